@@ -0,0 +1,168 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicBenchmarksFramework.h"
+
+using namespace Intrinsic::Core;
+using namespace Intrinsic::Benchmarks;
+
+namespace
+{
+const uint32_t _refCount = 100000u;
+
+struct RefManagerData
+{
+};
+
+// Exposes the allocation functions of the manager base
+struct RefManager : Dod::ManagerBase<_refCount, RefManagerData>
+{
+  static void init() { _initManager(); }
+  static Dod::Ref create() { return allocate(); }
+  static void destroy(Dod::Ref p_Ref) { release(p_Ref); }
+};
+
+// <-
+
+// Baseline used to rate the manager base: searches the ref to release in the
+// active refs like the manager base did before tracking the dense indices
+struct LinearScanRefManager
+{
+  static void init()
+  {
+    _freeIds.reserve(_refCount);
+    _activeRefs.reserve(_refCount);
+    _generations.resize(_refCount);
+
+    for (uint32_t i = 0u; i < _refCount; ++i)
+    {
+      _freeIds.push_back(_refCount - i - 1u);
+    }
+  }
+
+  static Dod::Ref create()
+  {
+    const uint32_t id = _freeIds.back();
+    _freeIds.pop_back();
+
+    const Dod::Ref ref = Dod::Ref(id, _generations[id]);
+    _activeRefs.push_back(ref);
+
+    return ref;
+  }
+
+  static void destroy(Dod::Ref p_Ref)
+  {
+    for (uint32_t i = 0; i < _activeRefs.size(); ++i)
+    {
+      if (_activeRefs[i] == p_Ref)
+      {
+        _activeRefs[i] = _activeRefs[_activeRefs.size() - 1u];
+        _activeRefs.resize(_activeRefs.size() - 1u);
+        break;
+      }
+    }
+
+    _freeIds.push_back(p_Ref._id);
+    _generations[p_Ref._id] =
+        (_generations[p_Ref._id] + 1u) % (Dod::maxGenerationIdValue + 1u);
+  }
+
+  static _INTR_ARRAY(Dod::IdType) _freeIds;
+  static _INTR_ARRAY(Dod::GenerationType) _generations;
+  static _INTR_ARRAY(Dod::Ref) _activeRefs;
+};
+
+_INTR_ARRAY(Dod::IdType) LinearScanRefManager::_freeIds;
+_INTR_ARRAY(Dod::GenerationType) LinearScanRefManager::_generations;
+_INTR_ARRAY(Dod::Ref) LinearScanRefManager::_activeRefs;
+
+// <-
+
+enum ReleaseOrder
+{
+  kReleaseInCreationOrder,
+  kReleaseInReverseOrder,
+  kReleaseInRandomOrder
+};
+
+const char* _releaseOrderNames[] = {"in order", "reversed", "shuffled"};
+
+// <-
+
+template <class Manager>
+void runCreateDestroyBenchmark(const char* p_ManagerName,
+                               ReleaseOrder p_ReleaseOrder)
+{
+  Dod::RefArray refs;
+  refs.resize(_refCount);
+
+  Timer timer;
+  for (uint32_t i = 0u; i < _refCount; ++i)
+  {
+    refs[i] = Manager::create();
+  }
+  const uint64_t createNs = timer.getNanoseconds();
+
+  // Reordered outside of the measured loop
+  if (p_ReleaseOrder == kReleaseInReverseOrder)
+  {
+    std::reverse(refs.begin(), refs.end());
+  }
+  else if (p_ReleaseOrder == kReleaseInRandomOrder)
+  {
+    uint32_t random = 0x9E3779B9u;
+    for (uint32_t i = _refCount - 1u; i > 0u; --i)
+    {
+      random ^= random << 13u;
+      random ^= random >> 17u;
+      random ^= random << 5u;
+      std::swap(refs[i], refs[random % (i + 1u)]);
+    }
+  }
+
+  Timer destroyTimer;
+  for (uint32_t i = 0u; i < _refCount; ++i)
+  {
+    Manager::destroy(refs[i]);
+  }
+  const uint64_t destroyNs = destroyTimer.getNanoseconds();
+
+  char configuration[64];
+  sprintf(configuration, "%s, create", p_ManagerName);
+  BenchmarkRegistry::report(configuration, _refCount, createNs);
+  sprintf(configuration, "%s, destroy %s", p_ManagerName,
+          _releaseOrderNames[p_ReleaseOrder]);
+  BenchmarkRegistry::report(configuration, _refCount, destroyNs);
+}
+}
+
+// <-
+
+_INTR_BENCHMARK(DodCreateDestroyRefs)
+{
+  RefManager::init();
+  LinearScanRefManager::init();
+
+  const ReleaseOrder releaseOrders[] = {
+      kReleaseInCreationOrder, kReleaseInReverseOrder, kReleaseInRandomOrder};
+
+  for (ReleaseOrder releaseOrder : releaseOrders)
+  {
+    runCreateDestroyBenchmark<RefManager>("dense indices", releaseOrder);
+    runCreateDestroyBenchmark<LinearScanRefManager>("linear scan",
+                                                    releaseOrder);
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#define _INTR_MAX_BENCHMARK_COUNT 256u
+
+// Keeps functions out of the measured loops
+#if defined(_WIN32)
+#define _INTR_NO_INLINE __declspec(noinline)
+#else
+#define _INTR_NO_INLINE __attribute__((noinline))
+#endif // _WIN32
+
+namespace Intrinsic
+{
+namespace Benchmarks
+{
+typedef void (*BenchmarkFunction)();
+
+struct Benchmark
+{
+  const char* name;
+  BenchmarkFunction function;
+};
+
+// <-
+
+/**
+ * Measures the wall clock time between its construction and the call to
+ * getNanoseconds.
+ */
+struct Timer
+{
+  Timer() : _start(std::chrono::high_resolution_clock::now()) {}
+
+  _INTR_INLINE uint64_t getNanoseconds() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::high_resolution_clock::now() - _start)
+        .count();
+  }
+
+private:
+  std::chrono::high_resolution_clock::time_point _start;
+};
+
+// <-
+
+/**
+ * Keeps track of all benchmarks. Benchmarks register themselves during static
+ * initialization via _INTR_BENCHMARK and report their results via report.
+ */
+struct BenchmarkRegistry
+{
+  static bool registerBenchmark(const char* p_Name,
+                                BenchmarkFunction p_Function);
+
+  /**
+   * Runs all benchmarks whose name contains the given filter (or all
+   * benchmarks if the filter is nullptr).
+   */
+  static void runBenchmarks(const char* p_Filter);
+
+  /**
+   * Prints the time per operation and the throughput of a single
+   * configuration of the currently running benchmark.
+   */
+  static void report(const char* p_Configuration, uint64_t p_OperationCount,
+                     uint64_t p_Nanoseconds);
+
+private:
+  static Benchmark _benchmarks[_INTR_MAX_BENCHMARK_COUNT];
+  static uint32_t _benchmarkCount;
+  static const char* _currentBenchmarkName;
+};
+
+// <-
+
+// Keeps the compiler from optimizing away results which are not used
+// otherwise
+template <typename T> _INTR_INLINE void doNotOptimize(T p_Value)
+{
+  static volatile T sink;
+  sink = p_Value;
+}
+}
+}
+
+// Declares and registers a benchmark
+#define _INTR_BENCHMARK(_name)                                                 \
+  static void _name();                                                         \
+  static const bool _name##Registered =                                        \
+      Intrinsic::Benchmarks::BenchmarkRegistry::registerBenchmark(#_name,      \
+                                                                  _name);      \
+  static void _name()
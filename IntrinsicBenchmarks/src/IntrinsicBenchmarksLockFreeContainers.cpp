@@ -0,0 +1,129 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicBenchmarksFramework.h"
+
+using namespace Intrinsic::Core::Containers;
+using namespace Intrinsic::Benchmarks;
+
+namespace
+{
+const uint32_t _pairsPerThread = 1000000u;
+const uint64_t _capacity = 4096u;
+
+// Baseline used to rate the lock-free containers
+template <class T, uint64_t Capacity> struct MutexStack
+{
+  MutexStack() : _size(0u) {}
+
+  _INTR_INLINE bool push(const T& p_Element)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_size == Capacity)
+    {
+      return false;
+    }
+    _elements[_size++] = p_Element;
+    return true;
+  }
+
+  _INTR_INLINE bool pop(T& p_Element)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_size == 0u)
+    {
+      return false;
+    }
+    p_Element = _elements[--_size];
+    return true;
+  }
+
+  std::mutex _mutex;
+  T _elements[Capacity];
+  uint64_t _size;
+};
+
+// <-
+
+// Each thread pushes an element and pops one right after, so all threads
+// contend for the head (and tail) of the container all the time
+template <class Container> void pushPopThread(Container* p_Container)
+{
+  uint64_t sum = 0u;
+  for (uint32_t i = 0u; i < _pairsPerThread; ++i)
+  {
+    while (!p_Container->push(i))
+    {
+      std::this_thread::yield();
+    }
+
+    uint64_t element;
+    while (!p_Container->pop(element))
+    {
+      std::this_thread::yield();
+    }
+    sum += element;
+  }
+  doNotOptimize(sum);
+}
+
+// <-
+
+template <class Container>
+void runPushPopBenchmark(const char* p_ContainerName, uint32_t p_ThreadCount)
+{
+  Container* container = new Container();
+
+  Timer timer;
+  {
+    std::thread threads[16];
+    for (uint32_t i = 0u; i < p_ThreadCount; ++i)
+    {
+      threads[i] = std::thread(pushPopThread<Container>, container);
+    }
+    for (uint32_t i = 0u; i < p_ThreadCount; ++i)
+    {
+      threads[i].join();
+    }
+  }
+  const uint64_t ns = timer.getNanoseconds();
+
+  delete container;
+
+  char configuration[64];
+  sprintf(configuration, "%s, %u thread(s)", p_ContainerName, p_ThreadCount);
+
+  // One operation is a single push or pop
+  BenchmarkRegistry::report(
+      configuration, 2u * (uint64_t)_pairsPerThread * p_ThreadCount, ns);
+}
+}
+
+// <-
+
+_INTR_BENCHMARK(LockFreeContainersThroughput)
+{
+  const uint32_t threadCounts[] = {1u, 2u, 4u, 8u};
+
+  for (uint32_t threadCount : threadCounts)
+  {
+    runPushPopBenchmark<MutexStack<uint64_t, _capacity>>("mutex stack",
+                                                         threadCount);
+    runPushPopBenchmark<LockFreeStack<uint64_t, _capacity>>("lock-free stack",
+                                                            threadCount);
+    runPushPopBenchmark<LockFreeQueue<uint64_t, _capacity>>("lock-free queue",
+                                                            threadCount);
+  }
+}
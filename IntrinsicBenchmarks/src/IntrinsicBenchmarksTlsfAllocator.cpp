@@ -0,0 +1,129 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicBenchmarksFramework.h"
+
+using namespace Intrinsic::Core::Memory;
+using namespace Intrinsic::Benchmarks;
+
+namespace
+{
+const uint32_t _allocationsPerThread = 1000000u;
+const uint32_t _liveBlocksPerThread = 256u;
+const uint32_t _maxAllocationSize = 256u;
+
+struct MallocAllocator
+{
+  _INTR_INLINE static void* allocate(uint32_t p_Size) { return malloc(p_Size); }
+  _INTR_INLINE static void free(void* p_Mem) { ::free(p_Mem); }
+};
+
+// <-
+
+// Keeps a window of live blocks per thread and replaces a random one on each
+// iteration. With p_CrossThread set, all threads share a single window, so
+// most blocks get freed on a different thread than the one allocating them.
+template <typename Allocator>
+void allocationThread(uint32_t p_ThreadIdx, uint32_t p_ThreadCount,
+                      bool p_CrossThread, std::atomic<void*>* p_Blocks)
+{
+  uint32_t random = 0x9E3779B9u * (p_ThreadIdx + 1u);
+  std::atomic<void*>* window =
+      p_CrossThread ? p_Blocks : &p_Blocks[p_ThreadIdx * _liveBlocksPerThread];
+  const uint32_t windowSize =
+      p_CrossThread ? p_ThreadCount * _liveBlocksPerThread
+                    : _liveBlocksPerThread;
+
+  for (uint32_t i = 0u; i < _allocationsPerThread; ++i)
+  {
+    random ^= random << 13u;
+    random ^= random >> 17u;
+    random ^= random << 5u;
+
+    void* mem = Allocator::allocate(8u + random % _maxAllocationSize);
+    void* prevMem = window[random % windowSize].exchange(mem);
+    if (prevMem != nullptr)
+    {
+      Allocator::free(prevMem);
+    }
+  }
+}
+
+// <-
+
+template <typename Allocator>
+void runAllocationBenchmark(const char* p_AllocatorName, uint32_t p_ThreadCount,
+                            bool p_CrossThread)
+{
+  std::atomic<void*>* blocks =
+      new std::atomic<void*>[p_ThreadCount * _liveBlocksPerThread];
+  for (uint32_t i = 0u; i < p_ThreadCount * _liveBlocksPerThread; ++i)
+  {
+    blocks[i].store(nullptr);
+  }
+
+  Timer timer;
+  {
+    std::thread threads[16];
+    for (uint32_t i = 0u; i < p_ThreadCount; ++i)
+    {
+      threads[i] = std::thread(allocationThread<Allocator>, i, p_ThreadCount,
+                               p_CrossThread, blocks);
+    }
+    for (uint32_t i = 0u; i < p_ThreadCount; ++i)
+    {
+      threads[i].join();
+    }
+  }
+  const uint64_t ns = timer.getNanoseconds();
+
+  for (uint32_t i = 0u; i < p_ThreadCount * _liveBlocksPerThread; ++i)
+  {
+    void* mem = blocks[i].load();
+    if (mem != nullptr)
+    {
+      Allocator::free(mem);
+    }
+  }
+  delete[] blocks;
+
+  char configuration[64];
+  sprintf(configuration, "%s, %u thread(s)%s", p_AllocatorName, p_ThreadCount,
+          p_CrossThread ? ", shared window" : "");
+
+  // Reports the throughput of all threads combined
+  BenchmarkRegistry::report(
+      configuration, (uint64_t)_allocationsPerThread * p_ThreadCount, ns);
+}
+}
+
+// <-
+
+_INTR_BENCHMARK(TlsfAllocatorThroughput)
+{
+  const uint32_t threadCounts[] = {1u, 2u, 4u, 8u};
+
+  for (uint32_t threadCount : threadCounts)
+  {
+    runAllocationBenchmark<MallocAllocator>("malloc", threadCount, false);
+    runAllocationBenchmark<Tlsf::MainAllocator>("tlsf", threadCount, false);
+
+    if (threadCount > 1u)
+    {
+      runAllocationBenchmark<MallocAllocator>("malloc", threadCount, true);
+      runAllocationBenchmark<Tlsf::MainAllocator>("tlsf", threadCount, true);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicBenchmarksFramework.h"
+
+#if defined(_INTR_TRACE_PROFILING_ENABLED)
+
+using namespace Intrinsic::Core;
+using namespace Intrinsic::Benchmarks;
+
+namespace
+{
+const uint32_t _iterationCount = 100000000u;
+const uint32_t _capturingIterationCount = 10000000u;
+
+// Kept out of line so the loops only differ in the profiling scope
+_INTR_NO_INLINE void work(uint32_t p_Idx) { doNotOptimize(p_Idx); }
+
+// <-
+
+uint64_t runWithoutScope(uint32_t p_IterationCount)
+{
+  Timer timer;
+  for (uint32_t i = 0u; i < p_IterationCount; ++i)
+  {
+    work(i);
+  }
+  return timer.getNanoseconds();
+}
+
+// <-
+
+uint64_t runWithScope(uint32_t p_IterationCount)
+{
+  Timer timer;
+  for (uint32_t i = 0u; i < p_IterationCount; ++i)
+  {
+    _INTR_PROFILE_CPU("Benchmarks", "Scope");
+    work(i);
+  }
+  return timer.getNanoseconds();
+}
+}
+
+// <-
+
+_INTR_BENCHMARK(TraceProfilerScopeOverhead)
+{
+  BenchmarkRegistry::report("no scope", _iterationCount,
+                            runWithoutScope(_iterationCount));
+  BenchmarkRegistry::report("scope, not capturing", _iterationCount,
+                            runWithScope(_iterationCount));
+
+  // Only flips the flag checked by the scopes; the events end up in the ring
+  // buffer of this thread but never get written to disk
+  TraceProfiler::_capturing.store(true);
+  BenchmarkRegistry::report("scope, capturing", _capturingIterationCount,
+                            runWithScope(_capturingIterationCount));
+  TraceProfiler::_capturing.store(false);
+}
+
+#endif // _INTR_TRACE_PROFILING_ENABLED
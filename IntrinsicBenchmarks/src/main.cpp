@@ -0,0 +1,80 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicBenchmarksFramework.h"
+
+namespace Intrinsic
+{
+namespace Benchmarks
+{
+// Static members
+Benchmark BenchmarkRegistry::_benchmarks[_INTR_MAX_BENCHMARK_COUNT];
+uint32_t BenchmarkRegistry::_benchmarkCount = 0u;
+const char* BenchmarkRegistry::_currentBenchmarkName = nullptr;
+
+// <-
+
+bool BenchmarkRegistry::registerBenchmark(const char* p_Name,
+                                          BenchmarkFunction p_Function)
+{
+  assert(_benchmarkCount < _INTR_MAX_BENCHMARK_COUNT &&
+         "Max. benchmark count exceeded");
+
+  Benchmark& benchmark = _benchmarks[_benchmarkCount++];
+  benchmark.name = p_Name;
+  benchmark.function = p_Function;
+
+  return true;
+}
+
+// <-
+
+void BenchmarkRegistry::runBenchmarks(const char* p_Filter)
+{
+  for (uint32_t i = 0u; i < _benchmarkCount; ++i)
+  {
+    const Benchmark& benchmark = _benchmarks[i];
+    if (p_Filter != nullptr && strstr(benchmark.name, p_Filter) == nullptr)
+    {
+      continue;
+    }
+
+    _currentBenchmarkName = benchmark.name;
+    benchmark.function();
+  }
+}
+
+// <-
+
+void BenchmarkRegistry::report(const char* p_Configuration,
+                               uint64_t p_OperationCount,
+                               uint64_t p_Nanoseconds)
+{
+  const double nsPerOp = (double)p_Nanoseconds / p_OperationCount;
+  printf("%-40s %-34s %10.2f ns/op %10.2f Mop/s\n", _currentBenchmarkName,
+         p_Configuration, nsPerOp, 1000.0 / nsPerOp);
+  fflush(stdout);
+}
+}
+}
+
+// <-
+
+int main(int argc, char* argv[])
+{
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  Intrinsic::Benchmarks::BenchmarkRegistry::runBenchmarks(filter);
+  return 0;
+}
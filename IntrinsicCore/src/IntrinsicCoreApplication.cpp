@@ -40,6 +40,9 @@ bool Application::_running = true;
 
 void Application::init(void* p_PlatformHandle, void* p_PlatformWindow)
 {
+  // Everything allocated up to this point is manager storage
+  Memory::Tracking::_defaultTag = Memory::Tag::kGeneral;
+
   // Initializes physics
   Physics::System::init();
 
@@ -73,6 +76,8 @@ void Application::init(void* p_PlatformHandle, void* p_PlatformWindow)
 
   // Load resource managers
   {
+    _INTR_MEMORY_TAG(kResources);
+
     Resources::MeshManager::loadFromMultipleFiles("managers/meshes/",
                                                   ".mesh.json");
     Resources::MeshManager::createAllResources();
@@ -103,6 +108,8 @@ void Application::init(void* p_PlatformHandle, void* p_PlatformWindow)
 
 void Application::initManagers()
 {
+  _INTR_MEMORY_TAG(kDod);
+
   // Initializes component managers
   {
     GameStates::Manager::init();
@@ -34,6 +34,8 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
   {
     _INTR_PROFILE_CPU("General", "Mesh Inst. Data Updt. Job");
 
+    const R::RenderProcess::RenderPacket& renderPacket =
+        R::RenderProcess::Default::_renderPacket;
     Dod::Ref frustumRef =
         R::RenderProcess::Default::_activeFrustums[_frustumIdx];
     glm::mat4& viewMatrix =
@@ -46,12 +48,10 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
       MeshRef meshCompRef =
           R::RenderProcess::Default::_visibleMeshComponents[_frustumIdx]
                                                            [meshIdx];
-      Entity::EntityRef entityRef = MeshManager::_entity(meshCompRef);
-      Components::NodeRef nodeRef =
-          Components::NodeManager::getComponentForEntity(entityRef);
+      Components::NodeRef nodeRef = MeshManager::_node(meshCompRef);
 
       const float distToCamera = glm::distance(
-          Components::NodeManager::_worldPosition(nodeRef),
+          Components::NodeManager::_renderWorldPosition(nodeRef),
           Resources::FrustumManager::_frustumWorldPosition(frustumRef));
 
       // Fill per instance data
@@ -59,14 +59,14 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
           Components::MeshManager::_perInstanceDataVertex(meshCompRef);
       {
         perInstanceDataVertex.worldMatrix =
-            Components::NodeManager::_worldMatrix(nodeRef);
+            Components::NodeManager::_renderWorldMatrix(nodeRef);
         perInstanceDataVertex.viewProjMatrix = viewProjectionMatrix;
         perInstanceDataVertex.worldViewProjMatrix =
             viewProjectionMatrix * perInstanceDataVertex.worldMatrix;
         perInstanceDataVertex.worldViewMatrix =
             viewMatrix * perInstanceDataVertex.worldMatrix;
         perInstanceDataVertex.viewMatrix = viewMatrix;
-        perInstanceDataVertex.data0.w = TaskManager::_totalTimePassed;
+        perInstanceDataVertex.data0.w = renderPacket.totalTimePassed;
         perInstanceDataVertex.data0.y = distToCamera;
       }
 
@@ -82,10 +82,10 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
         perInstanceDataFragment.camParams.w =
             1.0f / perInstanceDataFragment.camParams.y;
 
-        perInstanceDataFragment.data0.x = World::_currentDayNightFactor;
+        perInstanceDataFragment.data0.x = renderPacket.currentDayNightFactor;
         perInstanceDataFragment.data0.y = distToCamera;
         perInstanceDataFragment.data0.z = (float)nodeRef._id;
-        perInstanceDataFragment.data0.w = TaskManager::_totalTimePassed;
+        perInstanceDataFragment.data0.w = renderPacket.totalTimePassed;
         perInstanceDataFragment.colorTint =
             Components::MeshManager::_descColorTint(meshCompRef);
       }
@@ -98,6 +98,113 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
 
 // <-
 
+struct InstancedBatch
+{
+  DrawCallRef drawCall;
+  uint32_t firstInstance;
+  uint32_t instanceCount;
+};
+
+// Mesh components of all batches, stored consecutively per batch
+_INTR_ARRAY(MeshRef) _batchInstances;
+_INTR_ARRAY(InstancedBatch) _instancedBatches;
+
+// <-
+
+_INTR_INLINE uint64_t calcInstancingKey(DrawCallRef p_DrawCall)
+{
+  // Draw calls with matching mesh, sub mesh, material and material pass share
+  // the pipeline, descriptor set contents and vertex/index buffers
+  const uint64_t materialPass = DrawCallManager::_descMaterialPass(p_DrawCall);
+  const uint64_t material = DrawCallManager::_descMaterial(p_DrawCall)._id;
+  const uint64_t indexBuffer =
+      DrawCallManager::_descIndexBuffer(p_DrawCall)._id;
+  const uint64_t vertexBuffer =
+      DrawCallManager::_descVertexBuffers(p_DrawCall)[0]._id;
+
+  return (materialPass << 48u) | ((material & 0xFFFFu) << 32u) |
+         ((indexBuffer & 0xFFFFu) << 16u) | (vertexBuffer & 0xFFFFu);
+}
+
+// <-
+
+void collectInstancedBatches(const DrawCallRefArray& p_DrawCalls,
+                             bool p_Instancing)
+{
+  _INTR_PROFILE_CPU("General", "Collect Instanced Batches");
+
+  static _INTR_HASH_MAP(uint64_t, uint32_t) openBatchMapping;
+  static _INTR_ARRAY(uint32_t) batchIndices;
+
+  _instancedBatches.clear();
+
+  if (!p_Instancing)
+  {
+    _batchInstances.resize(p_DrawCalls.size());
+
+    for (uint32_t dcIdx = 0u; dcIdx < p_DrawCalls.size(); ++dcIdx)
+    {
+      DrawCallRef dcRef = p_DrawCalls[dcIdx];
+      _batchInstances[dcIdx] = DrawCallManager::_descMeshComponent(dcRef);
+      _instancedBatches.push_back({dcRef, dcIdx, 1u});
+    }
+
+    return;
+  }
+
+  // Assign the draw calls to batches, keeping the order of the first draw
+  // call of each batch
+  openBatchMapping.clear();
+  batchIndices.resize(p_DrawCalls.size());
+  for (uint32_t dcIdx = 0u; dcIdx < p_DrawCalls.size(); ++dcIdx)
+  {
+    DrawCallRef dcRef = p_DrawCalls[dcIdx];
+    const uint64_t key = calcInstancingKey(dcRef);
+
+    // Start a new batch if there is none yet or the open one is full
+    uint32_t batchIdx = (uint32_t)_instancedBatches.size();
+    auto openBatch = openBatchMapping.find(key);
+    if (openBatch != openBatchMapping.end())
+    {
+      const InstancedBatch& batch = _instancedBatches[openBatch->second];
+      if (batch.instanceCount <
+          DrawCallManager::_descInstanceCount(batch.drawCall))
+      {
+        batchIdx = openBatch->second;
+      }
+    }
+
+    if (batchIdx == _instancedBatches.size())
+    {
+      openBatchMapping[key] = batchIdx;
+      _instancedBatches.push_back({dcRef, 0u, 0u});
+    }
+
+    batchIndices[dcIdx] = batchIdx;
+    ++_instancedBatches[batchIdx].instanceCount;
+  }
+
+  // Gather the instances of each batch
+  uint32_t instanceCount = 0u;
+  for (uint32_t batchIdx = 0u; batchIdx < _instancedBatches.size(); ++batchIdx)
+  {
+    InstancedBatch& batch = _instancedBatches[batchIdx];
+    batch.firstInstance = instanceCount;
+    instanceCount += batch.instanceCount;
+    batch.instanceCount = 0u;
+  }
+
+  _batchInstances.resize(instanceCount);
+  for (uint32_t dcIdx = 0u; dcIdx < p_DrawCalls.size(); ++dcIdx)
+  {
+    InstancedBatch& batch = _instancedBatches[batchIndices[dcIdx]];
+    _batchInstances[batch.firstInstance + batch.instanceCount++] =
+        DrawCallManager::_descMeshComponent(p_DrawCalls[dcIdx]);
+  }
+}
+
+// <-
+
 struct UniformUpdateParallelTaskSet : enki::ITaskSet
 {
   virtual ~UniformUpdateParallelTaskSet() {}
@@ -107,27 +214,30 @@ struct UniformUpdateParallelTaskSet : enki::ITaskSet
   {
     _INTR_PROFILE_CPU("General", "Mesh Uniform Data Updt. Job");
 
-    DrawCallRefArray& drawCalls = *_drawCalls;
-
-    for (uint32_t dcIdx = p_Range.start; dcIdx < p_Range.end; ++dcIdx)
+    for (uint32_t batchIdx = p_Range.start; batchIdx < p_Range.end; ++batchIdx)
     {
-      DrawCallRef dcRef = drawCalls[dcIdx];
-      MeshRef meshCompRef = DrawCallManager::_descMeshComponent(dcRef);
-      _INTR_ASSERT(meshCompRef.isValid());
-
-      MeshPerInstanceDataVertex& vertData =
-          Components::MeshManager::_perInstanceDataVertex(meshCompRef);
-      MeshPerInstanceDataFragment& fragData =
-          Components::MeshManager::_perInstanceDataFragment(meshCompRef);
+      const InstancedBatch& batch = _instancedBatches[batchIdx];
+      DrawCallRef dcRef = batch.drawCall;
 
+      DrawCallManager::_instanceCount(dcRef) = batch.instanceCount;
       DrawCallManager::allocateUniformMemory(dcRef);
-      DrawCallManager::updateUniformMemory(
-          dcRef, &vertData, sizeof(MeshPerInstanceDataVertex), &fragData,
-          sizeof(MeshPerInstanceDataFragment));
+
+      for (uint32_t instIdx = 0u; instIdx < batch.instanceCount; ++instIdx)
+      {
+        MeshRef meshCompRef = _batchInstances[batch.firstInstance + instIdx];
+        _INTR_ASSERT(meshCompRef.isValid());
+
+        MeshPerInstanceDataVertex& vertData =
+            Components::MeshManager::_perInstanceDataVertex(meshCompRef);
+        MeshPerInstanceDataFragment& fragData =
+            Components::MeshManager::_perInstanceDataFragment(meshCompRef);
+
+        DrawCallManager::updateUniformMemory(
+            dcRef, &vertData, sizeof(MeshPerInstanceDataVertex), &fragData,
+            sizeof(MeshPerInstanceDataFragment), instIdx);
+      }
     }
   }
-
-  DrawCallRefArray* _drawCalls;
 };
 
 // <-
@@ -282,6 +392,17 @@ void MeshManager::init()
 
 // <-
 
+void MeshManager::markNodeDirty(MeshRef p_Mesh)
+{
+  NodeRef nodeRef = NodeManager::getComponentForEntity(_entity(p_Mesh));
+  if (nodeRef.isValid())
+  {
+    NodeManager::markLocalTransformDirty(nodeRef);
+  }
+}
+
+// <-
+
 void MeshManager::createResources(const MeshRefArray& p_Meshes)
 {
   DrawCallRefArray drawCallsToCreate;
@@ -318,7 +439,8 @@ void MeshManager::createResources(const MeshRefArray& p_Meshes)
         DrawCallRef drawCallMesh = DrawCallManager::createDrawCallForMesh(
             _N(_MeshComponent), meshRef, matToUse, matPassIdx,
             sizeof(MeshPerInstanceDataVertex),
-            sizeof(MeshPerInstanceDataFragment), subMeshIdx);
+            sizeof(MeshPerInstanceDataFragment), subMeshIdx,
+            _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL);
 
         DrawCallManager::_descMeshComponent(drawCallMesh) = meshCompRef;
 
@@ -411,17 +533,32 @@ void MeshManager::updatePerInstanceData(Dod::Ref p_CameraRef,
 
 // <-
 
-void MeshManager::updateUniformData(Dod::RefArray& p_DrawCalls)
+void MeshManager::updateUniformData(Dod::RefArray& p_DrawCalls,
+                                    bool p_AllowInstancing)
 {
   static UniformUpdateParallelTaskSet uniformUpdateTaskSet;
 
   _INTR_PROFILE_CPU("General", "Mesh Uniform Data Updt.");
 
-  uniformUpdateTaskSet._drawCalls = &p_DrawCalls;
-  uniformUpdateTaskSet.m_SetSize = (uint32_t)p_DrawCalls.size();
+  collectInstancedBatches(p_DrawCalls,
+                          p_AllowInstancing &&
+                              Settings::Manager::_gpuInstancingEnabled);
+
+  uniformUpdateTaskSet.m_SetSize = (uint32_t)_instancedBatches.size();
 
   Application::_scheduler.AddTaskSetToPipe(&uniformUpdateTaskSet);
   Application::_scheduler.WaitforTaskSet(&uniformUpdateTaskSet);
+
+  // Only dispatch a single draw call per batch
+  if (_instancedBatches.size() != p_DrawCalls.size())
+  {
+    p_DrawCalls.resize(_instancedBatches.size());
+    for (uint32_t batchIdx = 0u; batchIdx < _instancedBatches.size();
+         ++batchIdx)
+    {
+      p_DrawCalls[batchIdx] = _instancedBatches[batchIdx].drawCall;
+    }
+  }
 }
 
 // <-
@@ -72,6 +72,7 @@ struct MeshManager
     MeshRef ref = Dod::Components::ComponentManagerBase<
         MeshData,
         _INTR_MAX_MESH_COMPONENT_COUNT>::_createComponent(p_ParentEntity);
+    markNodeDirty(ref);
     return ref;
   }
 
@@ -79,6 +80,8 @@ struct MeshManager
 
   _INTR_INLINE static void destroyMesh(MeshRef p_Mesh)
   {
+    // The Node falls back to its default bounds
+    markNodeDirty(p_Mesh);
     Dod::Components::ComponentManagerBase<
         MeshData, _INTR_MAX_MESH_COMPONENT_COUNT>::_destroyComponent(p_Mesh);
   }
@@ -87,6 +90,13 @@ struct MeshManager
 
   static void resetToDefault(MeshRef p_Mesh);
 
+  /**
+   * Marks the transform of the Node of the given Mesh as dirty, so the bounds
+   * of the Node get updated with the next transform update. Has to be called
+   * whenever the mesh used by the component changes.
+   */
+  static void markNodeDirty(MeshRef p_Mesh);
+
   // <-
 
   _INTR_INLINE static void compileDescriptor(MeshRef p_Ref, bool p_GenerateDesc,
@@ -113,8 +123,13 @@ struct MeshManager
   {
     if (p_Properties.HasMember("meshName"))
     {
-      _descMeshName(p_Ref) =
+      const Name meshName =
           JsonHelper::readPropertyName(p_Properties["meshName"]);
+      if (meshName != _descMeshName(p_Ref))
+      {
+        _descMeshName(p_Ref) = meshName;
+        markNodeDirty(p_Ref);
+      }
     }
     if (p_Properties.HasMember("colorTint"))
     {
@@ -146,7 +161,14 @@ struct MeshManager
 
   // <-
 
-  static void updateUniformData(Dod::RefArray& p_Meshes);
+  /**
+   * Allocates and updates the uniform memory of the given (visible) draw
+   * calls. If instancing is allowed and enabled, draw calls sharing mesh, sub
+   * mesh, material and material pass are merged into instanced draw calls and
+   * the array is reduced to one draw call per instanced batch.
+   */
+  static void updateUniformData(Dod::RefArray& p_DrawCalls,
+                                bool p_AllowInstancing = true);
   static void updatePerInstanceData(Dod::Ref p_CameraRef,
                                     uint32_t p_FrustumIdx);
 
@@ -21,9 +21,47 @@ namespace Core
 {
 namespace Components
 {
+namespace
+{
+// Only levels with at least this many nodes are updated in parallel
+const uint32_t _minParallelLevelSize = 256u;
+
+struct TransformUpdateParallelTaskSet : enki::ITaskSet
+{
+  virtual ~TransformUpdateParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Nodes", "Update Transforms Job");
+
+    uint32_t updatedNodeCount = 0u;
+    for (uint32_t nodeIdx = _levelStart + p_Range.start;
+         nodeIdx < _levelStart + p_Range.end; ++nodeIdx)
+    {
+      if (NodeManager::updateTransform((*_nodes)[nodeIdx]))
+      {
+        ++updatedNodeCount;
+      }
+    }
+
+    _updatedNodeCount += updatedNodeCount;
+  }
+
+  const NodeRefArray* _nodes;
+  uint32_t _levelStart;
+  std::atomic<uint32_t> _updatedNodeCount;
+} _transformUpdateParallelTaskSet;
+}
+
 // Static members
 NodeRefArray NodeManager::_rootNodes;
 NodeRefArray NodeManager::_sortedNodes;
+_INTR_ARRAY(uint32_t) NodeManager::_sortedNodeLevelOffsets;
+_INTR_ARRAY(uint32_t) NodeManager::_movedNodeIds;
+std::atomic<uint32_t> NodeManager::_movedNodeCount;
+uint32_t NodeManager::_updatedNodeCountPerFrame = 0u;
+DynamicAABBTree NodeManager::_boundingVolumeHierarchy;
 
 void NodeManager::init()
 {
@@ -34,6 +72,8 @@ void NodeManager::init()
 
   _sortedNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
   _rootNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _movedNodeIds.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _movedNodeCount = 0u;
 
   Dod::Components::ComponentManagerEntry nodeEntry;
   {
@@ -61,82 +101,221 @@ void NodeManager::init()
   }
 }
 
-void NodeManager::updateTransforms(const NodeRefArray& p_Nodes)
+bool NodeManager::updateTransform(NodeRef p_Ref)
 {
-  for (uint32_t nodeIdx = 0u; nodeIdx < p_Nodes.size(); ++nodeIdx)
+  uint32_t& flags = _flags(p_Ref);
+
+  // Skip nodes which did not move
+  if ((flags & NodeFlags::kTransformDirty) == 0u)
+  {
+    return false;
+  }
+
+  flags &= ~NodeFlags::kTransformDirty;
+
+  // Propagate to the children
+  for (NodeRef childRef = _firstChild(p_Ref); childRef.isValid();
+       childRef = _nextSibling(childRef))
+  {
+    _flags(childRef) |= NodeFlags::kWorldTransformDirty;
+  }
+
+  NodeRef parentNodeRef = _parent(p_Ref);
+
+  if (!parentNodeRef.isValid())
+  {
+    _worldPosition(p_Ref) = _position(p_Ref);
+    _worldOrientation(p_Ref) = _orientation(p_Ref);
+    _worldSize(p_Ref) = _size(p_Ref);
+  }
+  else
+  {
+    const glm::vec3& parentPos = _worldPosition(parentNodeRef);
+    const glm::quat& parentOrient = _worldOrientation(parentNodeRef);
+    const glm::vec3& parentSize = _worldSize(parentNodeRef);
+
+    const glm::vec3& localPos = _position(p_Ref);
+    const glm::quat& localOrient = _orientation(p_Ref);
+    const glm::vec3& localSize = _size(p_Ref);
+
+    const glm::vec3 worldPos = parentPos + (parentOrient * localPos);
+    const glm::quat worldOrient = parentOrient * localOrient;
+    const glm::vec3 worldSize = parentSize * localSize;
+
+    _worldPosition(p_Ref) = worldPos;
+    _worldOrientation(p_Ref) = worldOrient;
+    _worldSize(p_Ref) = worldSize;
+  }
+
+  glm::mat4 rot = glm::mat4_cast(_worldOrientation(p_Ref));
+  glm::mat4 trans = glm::translate(glm::mat4(1.0f), _worldPosition(p_Ref));
+  glm::mat4 scale = glm::scale(glm::mat4(1.0f), _worldSize(p_Ref));
+
+  _worldMatrix(p_Ref) = trans * rot * scale;
+  _inverseWorldMatrix(p_Ref) = glm::inverse(_worldMatrix(p_Ref));
+
+  // Update AABB
+  // TODO: Merge sub meshes
+  Components::MeshRef meshCompRef =
+      Components::MeshManager::getComponentForEntity(_entity(p_Ref));
+  if (meshCompRef.isValid())
   {
-    NodeRef nodeRef = p_Nodes[nodeIdx];
-    NodeRef parentNodeRef = _parent(nodeRef);
+    Name& meshName = Components::MeshManager::_descMeshName(meshCompRef);
+    Resources::MeshRef meshRef =
+        Resources::MeshManager::_getResourceByName(meshName);
 
-    if (!parentNodeRef.isValid())
+    if (meshRef.isValid())
     {
-      _worldPosition(nodeRef) = _position(nodeRef);
-      _worldOrientation(nodeRef) = _orientation(nodeRef);
-      _worldSize(nodeRef) = _size(nodeRef);
+      const uint32_t aabbCount =
+          (uint32_t)Resources::MeshManager::_aabbPerSubMesh(meshRef).size();
+
+      if (aabbCount > 0u)
+      {
+        _localAABB(p_Ref) =
+            Resources::MeshManager::_aabbPerSubMesh(meshRef)[0u];
+        _worldAABB(p_Ref) = _localAABB(p_Ref);
+        Math::transformAABBAffine(_worldAABB(p_Ref), _worldMatrix(p_Ref));
+
+        _worldBoundingSphere(p_Ref) = {
+            Math::calcAABBCenter(_worldAABB(p_Ref)),
+            glm::length(Math::calcAABBHalfExtent(_worldAABB(p_Ref)))};
+      }
     }
-    else
+  }
+  else
+  {
+    _worldAABB(p_Ref) = Math::AABB(_worldPosition(p_Ref) - glm::vec3(0.5f),
+                                   _worldPosition(p_Ref) + glm::vec3(0.5f));
+  }
+
+  // Queue the Node for the next BVH update (each id is queued only once)
+  if ((flags & NodeFlags::kBoundingVolumeMoved) == 0u)
+  {
+    flags |= NodeFlags::kBoundingVolumeMoved;
+    _movedNodeIds[_movedNodeCount++] = p_Ref._id;
+  }
+
+  return true;
+}
+
+// <-
+
+void NodeManager::updateTransforms(const NodeRef* p_Nodes,
+                                   uint32_t p_NodeCount)
+{
+  uint32_t updatedNodeCount = 0u;
+
+  for (uint32_t nodeIdx = 0u; nodeIdx < p_NodeCount; ++nodeIdx)
+  {
+    if (updateTransform(p_Nodes[nodeIdx]))
     {
-      const glm::vec3& parentPos = _worldPosition(parentNodeRef);
-      const glm::quat& parentOrient = _worldOrientation(parentNodeRef);
-      const glm::vec3& parentSize = _worldSize(parentNodeRef);
+      ++updatedNodeCount;
+    }
+  }
+
+  _updatedNodeCountPerFrame += updatedNodeCount;
+}
+
+// <-
+
+void NodeManager::updateTransforms()
+{
+  _INTR_PROFILE_CPU("Nodes", "Update Transforms");
 
-      const glm::vec3& localPos = _position(nodeRef);
-      const glm::quat& localOrient = _orientation(nodeRef);
-      const glm::vec3& localSize = _size(nodeRef);
+  _transformUpdateParallelTaskSet._nodes = &_sortedNodes;
+  _transformUpdateParallelTaskSet._updatedNodeCount = 0u;
 
-      const glm::vec3 worldPos = parentPos + (parentOrient * localPos);
-      const glm::quat worldOrient = parentOrient * localOrient;
-      const glm::vec3 worldSize = parentSize * localSize;
+  // Levels have to be processed in order since each level depends on the
+  // world transforms of the previous one
+  for (uint32_t levelIdx = 0u; levelIdx + 1u < _sortedNodeLevelOffsets.size();
+       ++levelIdx)
+  {
+    const uint32_t levelStart = _sortedNodeLevelOffsets[levelIdx];
+    const uint32_t levelSize =
+        _sortedNodeLevelOffsets[levelIdx + 1u] - levelStart;
 
-      _worldPosition(nodeRef) = worldPos;
-      _worldOrientation(nodeRef) = worldOrient;
-      _worldSize(nodeRef) = worldSize;
+    if (levelSize < _minParallelLevelSize)
+    {
+      enki::TaskSetPartition range;
+      range.start = 0u;
+      range.end = levelSize;
+
+      _transformUpdateParallelTaskSet._levelStart = levelStart;
+      _transformUpdateParallelTaskSet.ExecuteRange(range, 0u);
+      continue;
     }
 
-    glm::mat4 rot = glm::mat4_cast(NodeManager::_worldOrientation(nodeRef));
-    glm::mat4 trans =
-        glm::translate(glm::mat4(1.0f), NodeManager::_worldPosition(nodeRef));
-    glm::mat4 scale =
-        glm::scale(glm::mat4(1.0f), NodeManager::_worldSize(nodeRef));
+    _transformUpdateParallelTaskSet._levelStart = levelStart;
+    _transformUpdateParallelTaskSet.m_SetSize = levelSize;
+
+    Application::_scheduler.AddTaskSetToPipe(&_transformUpdateParallelTaskSet);
+    Application::_scheduler.WaitforTaskSet(&_transformUpdateParallelTaskSet);
+  }
+
+  _updatedNodeCountPerFrame +=
+      _transformUpdateParallelTaskSet._updatedNodeCount;
+}
+
+// <-
+
+void NodeManager::updateBoundingVolumeHierarchy()
+{
+  _INTR_PROFILE_CPU("Nodes", "Update BVH");
 
-    _worldMatrix(nodeRef) = trans * rot * scale;
-    _inverseWorldMatrix(nodeRef) = glm::inverse(_worldMatrix(nodeRef));
+  const uint32_t movedNodeCount = _movedNodeCount;
+  for (uint32_t i = 0u; i < movedNodeCount; ++i)
+  {
+    const uint32_t nodeId = _movedNodeIds[i];
+    _data.flags[nodeId] &= ~NodeFlags::kBoundingVolumeMoved;
 
-    // Update AABB
-    // TODO: Merge sub meshes
-    Components::MeshRef meshCompRef =
-        Components::MeshManager::getComponentForEntity(_entity(nodeRef));
-    if (meshCompRef.isValid())
+    // Skip Nodes which got destroyed in the meantime
+    const uint32_t activeIdx = _activeIndices[nodeId];
+    if (activeIdx == Dod::kInvalidId)
     {
-      Name& meshName = Components::MeshManager::_descMeshName(meshCompRef);
-      Resources::MeshRef meshRef =
-          Resources::MeshManager::_getResourceByName(meshName);
+      continue;
+    }
 
-      if (meshRef.isValid())
-      {
-        const uint32_t aabbCount =
-            (uint32_t)Resources::MeshManager::_aabbPerSubMesh(meshRef).size();
-
-        if (aabbCount > 0u)
-        {
-          _localAABB(nodeRef) =
-              Resources::MeshManager::_aabbPerSubMesh(meshRef)[0u];
-          _worldAABB(nodeRef) = _localAABB(nodeRef);
-          Math::transformAABBAffine(_worldAABB(nodeRef), _worldMatrix(nodeRef));
-
-          _worldBoundingSphere(nodeRef) = {
-              Math::calcAABBCenter(_worldAABB(nodeRef)),
-              glm::length(Math::calcAABBHalfExtent(_worldAABB(nodeRef)))};
-        }
-      }
+    const NodeRef nodeRef = _activeRefs[activeIdx];
+    const Math::Sphere& sphere = _worldBoundingSphere(nodeRef);
+    const Math::AABB aabb(sphere.p - sphere.r, sphere.p + sphere.r);
+
+    uint32_t& proxyId = _boundingVolumeProxy(nodeRef);
+    if (proxyId == DynamicAABBTree::kNullNode)
+    {
+      proxyId = _boundingVolumeHierarchy.createProxy(aabb, nodeRef);
     }
     else
     {
-      _worldAABB(nodeRef) =
-          Math::AABB(_worldPosition(nodeRef) - glm::vec3(0.5f),
-                     _worldPosition(nodeRef) + glm::vec3(0.5f));
+      _boundingVolumeHierarchy.moveProxy(proxyId, aabb);
     }
   }
+
+  _movedNodeCount = 0u;
+}
+
+// <-
+
+void NodeManager::snapshotRenderState()
+{
+  _INTR_PROFILE_CPU("Nodes", "Snapshot Render State");
+
+  for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+  {
+    const uint32_t id = _activeRefs[i]._id;
+
+    _data.renderWorldPosition[id] = _data.worldPosition[id];
+    _data.renderWorldOrientation[id] = _data.worldOrientation[id];
+    _data.renderWorldSize[id] = _data.worldSize[id];
+    _data.renderWorldMatrix[id] = _data.worldMatrix[id];
+  }
+}
+
+// <-
+
+void NodeManager::onFrameEnded()
+{
+  _INTR_PROFILE_COUNTER_SET("Updated Nodes", _updatedNodeCountPerFrame);
+  _updatedNodeCountPerFrame = 0u;
 }
 }
 }
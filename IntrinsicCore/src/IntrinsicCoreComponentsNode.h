@@ -29,6 +29,15 @@ namespace NodeFlags
 enum Flags
 {
   kSpawned = 0x01u,
+
+  // The local transform changed and the world transform has to be updated
+  kLocalTransformDirty = 0x02u,
+  // The world transform of the parent changed
+  kWorldTransformDirty = 0x04u,
+  // The Node is queued for an update of the bounding volume hierarchy
+  kBoundingVolumeMoved = 0x08u,
+
+  kTransformDirty = kLocalTransformDirty | kWorldTransformDirty
 };
 }
 
@@ -57,6 +66,13 @@ struct NodeData : Dod::Components::ComponentDataBase
     worldBoundingSphere.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
 
     visibilityMask.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+    boundingVolumeProxy.resize(_INTR_MAX_NODE_COMPONENT_COUNT,
+                               DynamicAABBTree::kNullNode);
+
+    renderWorldPosition.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+    renderWorldOrientation.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+    renderWorldSize.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+    renderWorldMatrix.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
 
     parent.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
     firstChild.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
@@ -82,6 +98,13 @@ struct NodeData : Dod::Components::ComponentDataBase
   _INTR_ARRAY(Math::Sphere) worldBoundingSphere;
 
   _INTR_ARRAY(uint32_t) visibilityMask;
+  _INTR_ARRAY(uint32_t) boundingVolumeProxy;
+
+  // World space state snapshotted for rendering
+  _INTR_ARRAY(glm::vec3) renderWorldPosition;
+  _INTR_ARRAY(glm::quat) renderWorldOrientation;
+  _INTR_ARRAY(glm::vec3) renderWorldSize;
+  _INTR_ARRAY(glm::mat4x4) renderWorldMatrix;
 
   _INTR_ARRAY(NodeRef) parent;
   _INTR_ARRAY(NodeRef) firstChild;
@@ -112,7 +135,9 @@ struct NodeManager
     _firstChild(p_Ref) = NodeRef();
     _prevSibling(p_Ref) = NodeRef();
     _nextSibling(p_Ref) = NodeRef();
-    _flags(p_Ref) = 0u;
+    // Keep the BVH flag: the id might still be queued from a previous Node
+    _flags(p_Ref) = (_flags(p_Ref) & NodeFlags::kBoundingVolumeMoved) |
+                    NodeFlags::kLocalTransformDirty;
 
     _position(p_Ref) = _worldPosition(p_Ref) = glm::vec3();
     _orientation(p_Ref) = _worldOrientation(p_Ref) =
@@ -120,6 +145,7 @@ struct NodeManager
     _size(p_Ref) = _worldSize(p_Ref) = glm::vec3(1.0f, 1.0f, 1.0f);
     Math::setAABBZero(_worldAABB(p_Ref));
     Math::setAABBZero(_localAABB(p_Ref));
+    _worldBoundingSphere(p_Ref) = {glm::vec3(0.0f), 0.0f};
   }
 
   // <-
@@ -149,10 +175,10 @@ struct NodeManager
    * Collects all Nodes recursively starting at the given Node and puts
    * them in the provided array.
    */
-  _INTR_INLINE static void collectNodes(NodeRef p_Node, NodeRefArray& p_Nodes)
+  template <class ArrayType>
+  _INTR_INLINE static void collectNodes(NodeRef p_Node, ArrayType& p_Nodes)
   {
-    static _INTR_ARRAY(NodeRef) nodeStack;
-    nodeStack.clear();
+    _INTR_SCRATCH_ARRAY(NodeRef) nodeStack;
     nodeStack.push_back(p_Node);
 
     while (!nodeStack.empty())
@@ -185,7 +211,7 @@ struct NodeManager
   _INTR_INLINE static void collectEntities(NodeRef p_Node,
                                            Entity::EntityRefArray& p_Entities)
   {
-    NodeRefArray nodes;
+    _INTR_SCRATCH_ARRAY(NodeRef) nodes;
     collectNodes(p_Node, nodes);
 
     for (uint32_t i = 0u; i < nodes.size(); ++i)
@@ -203,7 +229,7 @@ struct NodeManager
    */
   _INTR_INLINE static void destroyNode(NodeRef p_Node)
   {
-    NodeRefArray nodes;
+    _INTR_SCRATCH_ARRAY(NodeRef) nodes;
     collectNodes(p_Node, nodes);
 
     for (uint32_t i = 0u; i < nodes.size(); ++i)
@@ -220,6 +246,13 @@ struct NodeManager
 
       internalRemoveFromRootNodeArray(currentNode);
 
+      uint32_t& proxyId = _boundingVolumeProxy(currentNode);
+      if (proxyId != DynamicAABBTree::kNullNode)
+      {
+        _boundingVolumeHierarchy.destroyProxy(proxyId);
+        proxyId = DynamicAABBTree::kNullNode;
+      }
+
       // Destroy the actual resource
       Dod::Components::ComponentManagerBase<
           NodeData,
@@ -232,48 +265,80 @@ struct NodeManager
   // <-
 
   /**
-   * Rebuilds the internal sorted node array.
+   * Rebuilds the internal sorted node array. The Nodes are grouped by their
+   * depth in the hierarchy, starting with the root Nodes.
    */
   _INTR_INLINE static void rebuildTree()
   {
     _sortedNodes.clear();
+    _sortedNodeLevelOffsets.clear();
 
-    for (uint32_t i = 0; i < _rootNodes.size(); ++i)
+    _sortedNodes.insert(_sortedNodes.end(), _rootNodes.begin(),
+                        _rootNodes.end());
+
+    uint32_t levelStart = 0u;
+    while (levelStart < _sortedNodes.size())
     {
-      NodeRef currentRootNode = _rootNodes[i];
+      const uint32_t levelEnd = (uint32_t)_sortedNodes.size();
+      _sortedNodeLevelOffsets.push_back(levelStart);
+
+      for (uint32_t i = levelStart; i < levelEnd; ++i)
+      {
+        for (NodeRef childRef = _firstChild(_sortedNodes[i]);
+             childRef.isValid(); childRef = _nextSibling(childRef))
+        {
+          _sortedNodes.push_back(childRef);
+        }
+      }
 
-      NodeRefArray nodes;
-      collectNodes(currentRootNode, _sortedNodes);
+      levelStart = levelEnd;
     }
+
+    _sortedNodeLevelOffsets.push_back((uint32_t)_sortedNodes.size());
   }
 
   // <-
 
   /**
-   * Updates the transformations for the provided Nodes.
+   * Updates the transformation of the given Node if it is marked dirty. Returns
+   * true if the Node got updated.
    */
-  static void updateTransforms(const NodeRefArray& p_Nodes);
+  static bool updateTransform(NodeRef p_Ref);
 
   // <-
 
   /**
-   * Updates all transformation for all trees in the manager.
+   * Updates the transformations for the provided Nodes. Only Nodes marked
+   * dirty (or whose parent got updated in the same call) are touched. The
+   * Nodes have to be sorted parent first.
    */
-  _INTR_INLINE static void updateTransforms()
+  _INTR_INLINE static void updateTransforms(const NodeRefArray& p_Nodes)
   {
-    updateTransforms(_sortedNodes);
+    updateTransforms(p_Nodes.data(), (uint32_t)p_Nodes.size());
   }
+  static void updateTransforms(const NodeRef* p_Nodes, uint32_t p_NodeCount);
 
   // <-
 
   /**
-   * Updates the transformations recursively starting at the given Node.
+   * Updates all transformation for all trees in the manager. Each level of the
+   * hierarchy is updated in parallel.
+   */
+  static void updateTransforms();
+
+  // <-
+
+  /**
+   * Updates the transformations recursively starting at the given Node. The
+   * given Node is always marked dirty beforehand.
    */
   _INTR_INLINE static void updateTransforms(NodeRef p_RootNode)
   {
-    NodeRefArray nodes;
+    markLocalTransformDirty(p_RootNode);
+
+    _INTR_SCRATCH_ARRAY(NodeRef) nodes;
     collectNodes(p_RootNode, nodes);
-    updateTransforms(nodes);
+    updateTransforms(nodes.data(), (uint32_t)nodes.size());
   }
 
   // <-
@@ -328,6 +393,8 @@ struct NodeManager
     }
 
     internalRemoveFromRootNodeArray(p_Child);
+
+    _flags(p_Child) |= NodeFlags::kWorldTransformDirty;
   }
 
   // <-
@@ -351,6 +418,8 @@ struct NodeManager
       _orientation(p_Child) = _orientation(p_Child) * inverseParentWorldOrient;
       _size(p_Child) = _size(p_Child) / _worldSize(p_Parent);
     }
+
+    markLocalTransformDirty(p_Child);
   }
 
   // <-
@@ -398,6 +467,7 @@ struct NodeManager
     _prevSibling(p_Child) = NodeRef();
     _nextSibling(p_Child) = NodeRef();
     _parent(p_Child) = NodeRef();
+    markLocalTransformDirty(p_Child);
 
     // This is once again a root node
     internalAddToRootNodeArray(p_Child);
@@ -466,6 +536,8 @@ struct NodeManager
     {
       _size(p_Ref) = JsonHelper::readPropertyVec3(p_Properties["localSize"]);
     }
+
+    markLocalTransformDirty(p_Ref);
   }
 
   /**
@@ -486,6 +558,8 @@ struct NodeManager
     {
       _orientation(p_Ref) = p_WorldOrientation;
     }
+
+    markLocalTransformDirty(p_Ref);
   }
 
   /**
@@ -506,6 +580,8 @@ struct NodeManager
     {
       _position(p_Ref) = p_WorldPosition;
     }
+
+    markLocalTransformDirty(p_Ref);
   }
 
   // Scripting interface
@@ -541,6 +617,7 @@ struct NodeManager
                                        const glm::vec3& p_Position)
   {
     _data.position[p_Ref._id] = p_Position;
+    markLocalTransformDirty(p_Ref);
   }
 
   /**
@@ -558,6 +635,7 @@ struct NodeManager
                                           const glm::quat& p_Orientation)
   {
     _data.orientation[p_Ref._id] = p_Orientation;
+    markLocalTransformDirty(p_Ref);
   }
 
   /**
@@ -574,8 +652,36 @@ struct NodeManager
   _INTR_INLINE static void setSize(NodeRef p_Ref, const glm::vec3& p_Size)
   {
     _data.size[p_Ref._id] = p_Size;
+    markLocalTransformDirty(p_Ref);
+  }
+
+  /**
+   * Marks the local transform of the given Node as changed. Has to be called
+   * when writing the local transform directly.
+   */
+  _INTR_INLINE static void markLocalTransformDirty(NodeRef p_Ref)
+  {
+    _data.flags[p_Ref._id] |= NodeFlags::kLocalTransformDirty;
   }
 
+  /**
+   * Moves the proxies of all Nodes which changed since the last call in the
+   * bounding volume hierarchy.
+   */
+  static void updateBoundingVolumeHierarchy();
+
+  /**
+   * Copies the world space transforms of all active Nodes to the render state.
+   * The renderer only reads the render state so the simulation of the next
+   * frame can update the transforms while the current frame is recorded.
+   */
+  static void snapshotRenderState();
+
+  /**
+   * Resets the per frame statistics.
+   */
+  static void onFrameEnded();
+
   // Resources
 
   /**
@@ -720,6 +826,46 @@ struct NodeManager
     return _data.visibilityMask[p_Ref._id];
   }
 
+  /**
+   * The proxy of this Node in the bounding volume hierarchy. If any.
+   */
+  _INTR_INLINE static uint32_t& _boundingVolumeProxy(NodeRef p_Ref)
+  {
+    return _data.boundingVolumeProxy[p_Ref._id];
+  }
+
+  /**
+   * The (world) position as seen by the renderer.
+   */
+  _INTR_INLINE static glm::vec3& _renderWorldPosition(NodeRef p_Ref)
+  {
+    return _data.renderWorldPosition[p_Ref._id];
+  }
+
+  /**
+   * The (world) orientation as seen by the renderer.
+   */
+  _INTR_INLINE static glm::quat& _renderWorldOrientation(NodeRef p_Ref)
+  {
+    return _data.renderWorldOrientation[p_Ref._id];
+  }
+
+  /**
+   * The (world) size as seen by the renderer.
+   */
+  _INTR_INLINE static glm::vec3& _renderWorldSize(NodeRef p_Ref)
+  {
+    return _data.renderWorldSize[p_Ref._id];
+  }
+
+  /**
+   * The world transform/matrix as seen by the renderer.
+   */
+  _INTR_INLINE static glm::mat4& _renderWorldMatrix(NodeRef p_Ref)
+  {
+    return _data.renderWorldMatrix[p_Ref._id];
+  }
+
   // <-
 
 private:
@@ -760,6 +906,27 @@ private:
    * The sorted nodes of all trees.
    */
   static NodeRefArray _sortedNodes;
+  /**
+   * The offsets of each hierarchy level in the sorted node array (plus the
+   * total count as the last entry).
+   */
+  static _INTR_ARRAY(uint32_t) _sortedNodeLevelOffsets;
+  /**
+   * The ids of the Nodes whose bounds changed since the last update of the
+   * bounding volume hierarchy.
+   */
+  static _INTR_ARRAY(uint32_t) _movedNodeIds;
+  static std::atomic<uint32_t> _movedNodeCount;
+
+public:
+  /**
+   * The amount of Nodes updated in the current frame.
+   */
+  static uint32_t _updatedNodeCountPerFrame;
+  /**
+   * Bounding volume hierarchy over the world bounding spheres of all Nodes.
+   */
+  static DynamicAABBTree _boundingVolumeHierarchy;
 };
 }
 }
@@ -206,9 +206,10 @@ void SwarmManager::simulateSwarms(const SwarmRefArray& p_Swarms, float p_DeltaT)
         boid.pos += boid.vel * p_DeltaT;
 
         // Update node
-        Components::NodeManager::_position(nodeRef) = boid.pos;
-        Components::NodeManager::_orientation(nodeRef) = glm::rotation(
-            glm::vec3(0.0f, 0.0f, 1.0f), glm::normalize(boid.vel + 0.01f));
+        Components::NodeManager::setPosition(nodeRef, boid.pos);
+        Components::NodeManager::setOrientation(
+            nodeRef, glm::rotation(glm::vec3(0.0f, 0.0f, 1.0f),
+                                   glm::normalize(boid.vel + 0.01f)));
 
         // Update lights and mesh color
         glm::vec4 boidColor = glm::vec4(boid.color, 1.0f);
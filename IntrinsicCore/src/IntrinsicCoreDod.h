@@ -148,9 +148,12 @@ template <uint32_t IdCount, class DataType> struct ManagerBase
 protected:
   _INTR_INLINE static void _initManager()
   {
+    _INTR_MEMORY_TAG(kDod);
+
     _freeIds.reserve(IdCount);
     _activeRefs.reserve(IdCount);
     _generations.resize(IdCount);
+    _activeIndices.resize(IdCount, kInvalidId);
 
     for (uint32_t i = 0u; i < IdCount; ++i)
     {
@@ -168,6 +171,7 @@ protected:
     ref._id = id;
     ref._generation = _generations[id];
 
+    _activeIndices[id] = (uint32_t)_activeRefs.size();
     _activeRefs.push_back(ref);
 
     return ref;
@@ -177,16 +181,16 @@ protected:
   {
     _INTR_ASSERT(p_Ref.isValid() && isAlive(p_Ref));
 
-    // Erase an swap
-    for (uint32_t i = 0; i < _activeRefs.size(); ++i)
-    {
-      if (_activeRefs[i] == p_Ref)
-      {
-        _activeRefs[i] = _activeRefs[_activeRefs.size() - 1u];
-        _activeRefs.resize(_activeRefs.size() - 1u);
-        break;
-      }
-    }
+    // Erase and swap using the dense index stored for each id
+    const uint32_t activeIdx = _activeIndices[p_Ref._id];
+    _INTR_ASSERT(activeIdx < _activeRefs.size() &&
+                 _activeRefs[activeIdx] == p_Ref);
+
+    const Ref lastRef = _activeRefs.back();
+    _activeRefs[activeIdx] = lastRef;
+    _activeIndices[lastRef._id] = activeIdx;
+    _activeRefs.pop_back();
+    _activeIndices[p_Ref._id] = kInvalidId;
 
     _freeIds.push_back(p_Ref._id);
 
@@ -196,6 +200,9 @@ protected:
 
   static _INTR_ARRAY(IdType) _freeIds;
   static _INTR_ARRAY(GenerationType) _generations;
+
+  // Maps each id to its (dense) index in _activeRefs
+  static _INTR_ARRAY(uint32_t) _activeIndices;
 };
 
 // <-
@@ -209,6 +216,9 @@ ManagerBase<IdCount, DataType>::_activeRefs;
 template <uint32_t IdCount, class DataType>
 _INTR_ARRAY(GenerationType)
 ManagerBase<IdCount, DataType>::_generations;
+template <uint32_t IdCount, class DataType>
+_INTR_ARRAY(uint32_t)
+ManagerBase<IdCount, DataType>::_activeIndices;
 }
 }
 }
@@ -47,21 +47,38 @@ struct ComponentManagerEntry : ManagerEntry
 
 // <-
 
+// Entry of the entity => component table
+struct EntityComponentEntry
+{
+  EntityComponentEntry() : entityGeneration(kInvalidGenerationId) {}
+
+  Ref component;
+  GenerationType entityGeneration;
+};
+
+// <-
+
 template <class DataType, uint32_t IdCount>
 struct ComponentManagerBase : Dod::ManagerBase<IdCount, DataType>
 {
-  typedef _INTR_HASH_MAP(uint32_t, Ref) EntityComponentMap;
+  typedef _INTR_ARRAY(EntityComponentEntry) EntityComponentTable;
 
   _INTR_INLINE static Ref getComponentForEntity(Entity::EntityRef p_Entity)
   {
-    auto componentIt = _entityComponentMap.find(p_Entity._id);
+    if (p_Entity._id >= _INTR_MAX_ENTITY_COUNT)
+    {
+      return Dod::Ref();
+    }
 
-    if (componentIt == _entityComponentMap.end())
+    const EntityComponentEntry& entry = _entityComponentTable[p_Entity._id];
+
+    // Stale entity refs (with an id that got reused) never resolve
+    if (entry.entityGeneration != p_Entity._generation)
     {
       return Dod::Ref();
     }
 
-    return componentIt->second;
+    return entry.component;
   }
 
   _INTR_INLINE static Entity::EntityRef& _entity(Ref p_Ref)
@@ -73,34 +90,38 @@ protected:
   _INTR_INLINE static void _initComponentManager()
   {
     Dod::ManagerBase<IdCount, DataType>::_initManager();
-    _entityComponentMap.reserve(IdCount);
+    _entityComponentTable.resize(_INTR_MAX_ENTITY_COUNT);
   }
 
   _INTR_INLINE static Ref _createComponent(Entity::EntityRef p_ParentEntity)
   {
     Ref ref = Dod::ManagerBase<IdCount, DataType>::allocate();
     _data.entity[ref._id] = p_ParentEntity;
-    _entityComponentMap[p_ParentEntity._id] = ref;
+
+    EntityComponentEntry& entry = _entityComponentTable[p_ParentEntity._id];
+    entry.component = ref;
+    entry.entityGeneration = p_ParentEntity._generation;
+
     return ref;
   }
 
   _INTR_INLINE static void _destroyComponent(Ref p_Ref)
   {
     Entity::EntityRef entity = _entity(p_Ref);
-    _entityComponentMap.erase(entity._id);
+    _entityComponentTable[entity._id] = EntityComponentEntry();
 
     Dod::ManagerBase<IdCount, DataType>::release(p_Ref);
   }
 
-  static EntityComponentMap _entityComponentMap;
+  static EntityComponentTable _entityComponentTable;
   static DataType _data;
 };
 
 template <class DataType, uint32_t IdCount>
 DataType ComponentManagerBase<DataType, IdCount>::_data;
 template <class DataType, uint32_t IdCount>
-_INTR_HASH_MAP(uint32_t, Ref)
-ComponentManagerBase<DataType, IdCount>::_entityComponentMap;
+_INTR_ARRAY(EntityComponentEntry)
+ComponentManagerBase<DataType, IdCount>::_entityComponentTable;
 }
 }
 }
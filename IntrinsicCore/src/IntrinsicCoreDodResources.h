@@ -406,6 +406,8 @@ protected:
                          ManagerInitFromDescriptorFunction p_InitFunction,
                          ManagerResetToDefaultFunction p_ResetToDefaultFunction)
   {
+    _INTR_MEMORY_TAG(kResources);
+
     char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
 
     tinydir_dir dir;
@@ -0,0 +1,418 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+DynamicAABBTree::DynamicAABBTree(float p_Margin)
+    : _root(kNullNode), _freeList(kNullNode), _proxyCount(0u),
+      _margin(p_Margin)
+{
+}
+
+// <-
+
+void DynamicAABBTree::clear()
+{
+  _nodes.clear();
+  _root = kNullNode;
+  _freeList = kNullNode;
+  _proxyCount = 0u;
+}
+
+// <-
+
+uint32_t DynamicAABBTree::createProxy(const Math::AABB& p_AABB,
+                                      Dod::Ref p_UserData)
+{
+  const uint32_t proxyId = allocateNode();
+
+  Node& node = _nodes[proxyId];
+  node.aabb = Math::AABB(p_AABB.min - _margin, p_AABB.max + _margin);
+  node.userData = p_UserData;
+  node.height = 0;
+
+  insertLeaf(proxyId);
+  ++_proxyCount;
+
+  return proxyId;
+}
+
+// <-
+
+void DynamicAABBTree::destroyProxy(uint32_t p_ProxyId)
+{
+  _INTR_ASSERT(p_ProxyId < _nodes.size() && _nodes[p_ProxyId].isLeaf());
+
+  removeLeaf(p_ProxyId);
+  freeNode(p_ProxyId);
+  --_proxyCount;
+}
+
+// <-
+
+bool DynamicAABBTree::moveProxy(uint32_t p_ProxyId, const Math::AABB& p_AABB)
+{
+  _INTR_ASSERT(p_ProxyId < _nodes.size() && _nodes[p_ProxyId].isLeaf());
+
+  // Still inside the enlarged AABB? Nothing to do
+  if (Math::isAABBContained(p_AABB, _nodes[p_ProxyId].aabb))
+  {
+    return false;
+  }
+
+  removeLeaf(p_ProxyId);
+  _nodes[p_ProxyId].aabb =
+      Math::AABB(p_AABB.min - _margin, p_AABB.max + _margin);
+  insertLeaf(p_ProxyId);
+
+  return true;
+}
+
+// <-
+
+uint32_t DynamicAABBTree::allocateNode()
+{
+  uint32_t nodeId = _freeList;
+
+  if (nodeId == kNullNode)
+  {
+    nodeId = (uint32_t)_nodes.size();
+    _nodes.push_back(Node());
+  }
+  else
+  {
+    _freeList = _nodes[nodeId].parent;
+  }
+
+  Node& node = _nodes[nodeId];
+  node.parent = kNullNode;
+  node.child0 = kNullNode;
+  node.child1 = kNullNode;
+  node.height = 0;
+  node.userData = Dod::Ref();
+
+  return nodeId;
+}
+
+// <-
+
+void DynamicAABBTree::freeNode(uint32_t p_NodeId)
+{
+  Node& node = _nodes[p_NodeId];
+  node.parent = _freeList;
+  node.height = -1;
+  _freeList = p_NodeId;
+}
+
+// <-
+
+void DynamicAABBTree::insertLeaf(uint32_t p_LeafId)
+{
+  if (_root == kNullNode)
+  {
+    _root = p_LeafId;
+    _nodes[_root].parent = kNullNode;
+    return;
+  }
+
+  // Find the best sibling using the surface area heuristic
+  const Math::AABB leafAABB = _nodes[p_LeafId].aabb;
+  uint32_t nodeId = _root;
+  while (!_nodes[nodeId].isLeaf())
+  {
+    const Node& node = _nodes[nodeId];
+
+    const float area = Math::calcAABBSurfaceArea(node.aabb);
+    const float combinedArea =
+        Math::calcAABBSurfaceArea(Math::mergeAABBs(node.aabb, leafAABB));
+
+    // Cost of creating a new parent for this node and the new leaf
+    const float cost = 2.0f * combinedArea;
+    // Minimum cost of pushing the leaf further down the tree
+    const float inheritanceCost = 2.0f * (combinedArea - area);
+
+    float childCosts[2];
+    const uint32_t children[2] = {node.child0, node.child1};
+    for (uint32_t i = 0u; i < 2u; ++i)
+    {
+      const Node& child = _nodes[children[i]];
+      const float mergedArea =
+          Math::calcAABBSurfaceArea(Math::mergeAABBs(leafAABB, child.aabb));
+
+      const float childArea =
+          child.isLeaf() ? 0.0f : Math::calcAABBSurfaceArea(child.aabb);
+
+      childCosts[i] = mergedArea - childArea + inheritanceCost;
+    }
+
+    if (cost < childCosts[0] && cost < childCosts[1])
+    {
+      break;
+    }
+
+    nodeId = childCosts[0] < childCosts[1] ? children[0] : children[1];
+  }
+
+  const uint32_t siblingId = nodeId;
+
+  // Create a new parent
+  const uint32_t oldParentId = _nodes[siblingId].parent;
+  const uint32_t newParentId = allocateNode();
+  {
+    Node& newParent = _nodes[newParentId];
+    newParent.parent = oldParentId;
+    newParent.aabb = Math::mergeAABBs(leafAABB, _nodes[siblingId].aabb);
+    newParent.height = _nodes[siblingId].height + 1;
+    newParent.child0 = siblingId;
+    newParent.child1 = p_LeafId;
+  }
+
+  if (oldParentId != kNullNode)
+  {
+    Node& oldParent = _nodes[oldParentId];
+    if (oldParent.child0 == siblingId)
+    {
+      oldParent.child0 = newParentId;
+    }
+    else
+    {
+      oldParent.child1 = newParentId;
+    }
+  }
+  else
+  {
+    _root = newParentId;
+  }
+
+  _nodes[siblingId].parent = newParentId;
+  _nodes[p_LeafId].parent = newParentId;
+
+  // Walk back up the tree fixing heights and AABBs
+  nodeId = _nodes[p_LeafId].parent;
+  while (nodeId != kNullNode)
+  {
+    nodeId = balance(nodeId);
+
+    Node& node = _nodes[nodeId];
+    const Node& child0 = _nodes[node.child0];
+    const Node& child1 = _nodes[node.child1];
+
+    node.height = 1 + std::max(child0.height, child1.height);
+    node.aabb = Math::mergeAABBs(child0.aabb, child1.aabb);
+
+    nodeId = node.parent;
+  }
+}
+
+// <-
+
+void DynamicAABBTree::removeLeaf(uint32_t p_LeafId)
+{
+  if (p_LeafId == _root)
+  {
+    _root = kNullNode;
+    return;
+  }
+
+  const uint32_t parentId = _nodes[p_LeafId].parent;
+  const uint32_t grandParentId = _nodes[parentId].parent;
+  const uint32_t siblingId = _nodes[parentId].child0 == p_LeafId
+                                 ? _nodes[parentId].child1
+                                 : _nodes[parentId].child0;
+
+  if (grandParentId != kNullNode)
+  {
+    // Destroy the parent and connect the sibling to the grand parent
+    Node& grandParent = _nodes[grandParentId];
+    if (grandParent.child0 == parentId)
+    {
+      grandParent.child0 = siblingId;
+    }
+    else
+    {
+      grandParent.child1 = siblingId;
+    }
+    _nodes[siblingId].parent = grandParentId;
+    freeNode(parentId);
+
+    // Adjust the ancestor bounds
+    uint32_t nodeId = grandParentId;
+    while (nodeId != kNullNode)
+    {
+      nodeId = balance(nodeId);
+
+      Node& node = _nodes[nodeId];
+      const Node& child0 = _nodes[node.child0];
+      const Node& child1 = _nodes[node.child1];
+
+      node.aabb = Math::mergeAABBs(child0.aabb, child1.aabb);
+      node.height = 1 + std::max(child0.height, child1.height);
+
+      nodeId = node.parent;
+    }
+  }
+  else
+  {
+    _root = siblingId;
+    _nodes[siblingId].parent = kNullNode;
+    freeNode(parentId);
+  }
+}
+
+// <-
+
+uint32_t DynamicAABBTree::balance(uint32_t p_NodeId)
+{
+  // Performs a left or right rotation if node A is imbalanced and returns the
+  // new root of the sub tree
+  const uint32_t iA = p_NodeId;
+  Node& A = _nodes[iA];
+
+  if (A.isLeaf() || A.height < 2)
+  {
+    return iA;
+  }
+
+  const uint32_t iB = A.child0;
+  const uint32_t iC = A.child1;
+  Node& B = _nodes[iB];
+  Node& C = _nodes[iC];
+
+  const int32_t balanceFactor = C.height - B.height;
+
+  // Rotate C up
+  if (balanceFactor > 1)
+  {
+    const uint32_t iF = C.child0;
+    const uint32_t iG = C.child1;
+    Node& F = _nodes[iF];
+    Node& G = _nodes[iG];
+
+    // Swap A and C
+    C.child0 = iA;
+    C.parent = A.parent;
+    A.parent = iC;
+
+    // A's old parent should point to C
+    if (C.parent != kNullNode)
+    {
+      Node& CParent = _nodes[C.parent];
+      if (CParent.child0 == iA)
+      {
+        CParent.child0 = iC;
+      }
+      else
+      {
+        CParent.child1 = iC;
+      }
+    }
+    else
+    {
+      _root = iC;
+    }
+
+    // Rotate
+    if (F.height > G.height)
+    {
+      C.child1 = iF;
+      A.child1 = iG;
+      G.parent = iA;
+      A.aabb = Math::mergeAABBs(B.aabb, G.aabb);
+      C.aabb = Math::mergeAABBs(A.aabb, F.aabb);
+
+      A.height = 1 + std::max(B.height, G.height);
+      C.height = 1 + std::max(A.height, F.height);
+    }
+    else
+    {
+      C.child1 = iG;
+      A.child1 = iF;
+      F.parent = iA;
+      A.aabb = Math::mergeAABBs(B.aabb, F.aabb);
+      C.aabb = Math::mergeAABBs(A.aabb, G.aabb);
+
+      A.height = 1 + std::max(B.height, F.height);
+      C.height = 1 + std::max(A.height, G.height);
+    }
+
+    return iC;
+  }
+
+  // Rotate B up
+  if (balanceFactor < -1)
+  {
+    const uint32_t iD = B.child0;
+    const uint32_t iE = B.child1;
+    Node& D = _nodes[iD];
+    Node& E = _nodes[iE];
+
+    // Swap A and B
+    B.child0 = iA;
+    B.parent = A.parent;
+    A.parent = iB;
+
+    // A's old parent should point to B
+    if (B.parent != kNullNode)
+    {
+      Node& BParent = _nodes[B.parent];
+      if (BParent.child0 == iA)
+      {
+        BParent.child0 = iB;
+      }
+      else
+      {
+        BParent.child1 = iB;
+      }
+    }
+    else
+    {
+      _root = iB;
+    }
+
+    // Rotate
+    if (D.height > E.height)
+    {
+      B.child1 = iD;
+      A.child0 = iE;
+      E.parent = iA;
+      A.aabb = Math::mergeAABBs(C.aabb, E.aabb);
+      B.aabb = Math::mergeAABBs(A.aabb, D.aabb);
+
+      A.height = 1 + std::max(C.height, E.height);
+      B.height = 1 + std::max(A.height, D.height);
+    }
+    else
+    {
+      B.child1 = iE;
+      A.child0 = iD;
+      D.parent = iA;
+      A.aabb = Math::mergeAABBs(C.aabb, D.aabb);
+      B.aabb = Math::mergeAABBs(A.aabb, E.aabb);
+
+      A.height = 1 + std::max(C.height, D.height);
+      B.height = 1 + std::max(A.height, E.height);
+    }
+
+    return iB;
+  }
+
+  return iA;
+}
+}
+}
@@ -0,0 +1,100 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Core
+{
+/**
+ * Bounding volume hierarchy of (enlarged) AABBs which can be updated
+ * incrementally. Each leaf represents a single proxy; proxies only get
+ * reinserted if their AABB leaves the enlarged AABB stored in the tree.
+ */
+struct DynamicAABBTree
+{
+  enum
+  {
+    kNullNode = 0xFFFFFFFFu
+  };
+
+  struct Node
+  {
+    _INTR_INLINE bool isLeaf() const { return child0 == kNullNode; }
+
+    Math::AABB aabb;
+    Dod::Ref userData;
+
+    // Doubles as the next pointer in the free list
+    uint32_t parent;
+    uint32_t child0;
+    uint32_t child1;
+    int32_t height;
+  };
+
+  DynamicAABBTree(float p_Margin = 0.1f);
+
+  // <-
+
+  /**
+   * Removes all proxies.
+   */
+  void clear();
+
+  /**
+   * Creates a new proxy for the given AABB and returns its id.
+   */
+  uint32_t createProxy(const Math::AABB& p_AABB, Dod::Ref p_UserData);
+
+  /**
+   * Destroys the given proxy.
+   */
+  void destroyProxy(uint32_t p_ProxyId);
+
+  /**
+   * Updates the AABB of the given proxy. Returns true if the proxy had to be
+   * reinserted.
+   */
+  bool moveProxy(uint32_t p_ProxyId, const Math::AABB& p_AABB);
+
+  // <-
+
+  _INTR_INLINE uint32_t getRoot() const { return _root; }
+  _INTR_INLINE const Node& getNode(uint32_t p_NodeId) const
+  {
+    return _nodes[p_NodeId];
+  }
+  _INTR_INLINE uint32_t getHeight() const
+  {
+    return _root != kNullNode ? (uint32_t)_nodes[_root].height : 0u;
+  }
+  _INTR_INLINE uint32_t getProxyCount() const { return _proxyCount; }
+
+private:
+  uint32_t allocateNode();
+  void freeNode(uint32_t p_NodeId);
+
+  void insertLeaf(uint32_t p_LeafId);
+  void removeLeaf(uint32_t p_LeafId);
+  uint32_t balance(uint32_t p_NodeId);
+
+  _INTR_ARRAY(Node) _nodes;
+  uint32_t _root;
+  uint32_t _freeList;
+  uint32_t _proxyCount;
+  float _margin;
+};
+}
+}
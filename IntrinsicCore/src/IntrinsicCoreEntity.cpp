@@ -79,6 +79,10 @@ void EntityManager::destroyAllComponents(EntityRefArray p_Refs)
 
 void EntityManager::destroyAllResources(EntityRefArray p_Refs)
 {
+  // Reused for all components to avoid allocating an array per component
+  Dod::RefArray refs;
+  refs.reserve(1u);
+
   for (uint32_t i = 0u; i < p_Refs.size(); ++i)
   {
     EntityRef entity = p_Refs[i];
@@ -96,7 +100,7 @@ void EntityManager::destroyAllResources(EntityRefArray p_Refs)
 
         if (componentRef.isValid())
         {
-          Dod::RefArray refs;
+          refs.clear();
           refs.push_back(componentRef);
 
           managerEntry.destroyResourcesFunction(refs);
@@ -35,6 +35,234 @@ _INTR_ARRAY(Benchmark::Data) _benchmarkData;
 uint32_t _pathIdx = 0u;
 float _pathPos = 0.0f;
 rapidjson::Document _benchmarkDesc;
+bool _bvhCullingEnabledBeforeBenchmark = true;
+
+const char* _frameStageNames[FrameStage::kCount] = {
+    "pumpEvents",     "gameStates",  "scripts", "physics",  "swarms",
+    "dayNightCycle", "postEffects", "events",  "rendering"};
+
+// Metrics below this value (in ms) are too noisy to be compared
+const float _minComparedTime = 0.1f;
+
+// <-
+
+_INTR_INLINE float calcPercentile(const _INTR_ARRAY(float) & p_SortedSamples,
+                                  float p_Percentile)
+{
+  // Nearest rank method
+  const uint32_t rank =
+      (uint32_t)std::ceil(p_Percentile * p_SortedSamples.size());
+  return p_SortedSamples[std::max(rank, 1u) - 1u];
+}
+
+// <-
+
+_INTR_INLINE void addStatistics(const char* p_Name,
+                                const _INTR_ARRAY(float) & p_Samples,
+                                rapidjson::Value& p_Parent,
+                                rapidjson::Document& p_Doc)
+{
+  const Benchmark::Statistics stats = Benchmark::calcStatistics(p_Samples);
+
+  rapidjson::Value statsValue = rapidjson::Value(rapidjson::kObjectType);
+  statsValue.AddMember("min", stats.min, p_Doc.GetAllocator());
+  statsValue.AddMember("mean", stats.mean, p_Doc.GetAllocator());
+  statsValue.AddMember("median", stats.median, p_Doc.GetAllocator());
+  statsValue.AddMember("p95", stats.p95, p_Doc.GetAllocator());
+  statsValue.AddMember("p99", stats.p99, p_Doc.GetAllocator());
+  statsValue.AddMember("max", stats.max, p_Doc.GetAllocator());
+
+  p_Parent.AddMember(rapidjson::StringRef(p_Name), statsValue,
+                     p_Doc.GetAllocator());
+}
+
+// <-
+
+_INTR_INLINE void addData(const char* p_Name, const Benchmark::Data& p_Data,
+                          rapidjson::Value& p_Parent,
+                          rapidjson::Document& p_Doc)
+{
+  rapidjson::Value nameValue;
+  nameValue.SetString(p_Name, p_Doc.GetAllocator());
+  p_Parent.AddMember("name", nameValue, p_Doc.GetAllocator());
+  p_Parent.AddMember("frameCount", (uint32_t)p_Data.frameTimes.size(),
+                     p_Doc.GetAllocator());
+  p_Parent.AddMember("score", p_Data.calcScore(), p_Doc.GetAllocator());
+
+  addStatistics("frameTime", p_Data.frameTimes, p_Parent, p_Doc);
+  addStatistics("cpuFrameTime", p_Data.cpuFrameTimes, p_Parent, p_Doc);
+  addStatistics("cullingTime", p_Data.cullingTimes, p_Parent, p_Doc);
+
+  rapidjson::Value stages = rapidjson::Value(rapidjson::kObjectType);
+  for (uint32_t i = 0u; i < FrameStage::kCount; ++i)
+  {
+    addStatistics(_frameStageNames[i], p_Data.stageTimes[i], stages, p_Doc);
+  }
+  p_Parent.AddMember("stages", stages, p_Doc.GetAllocator());
+}
+
+// <-
+
+_INTR_INLINE void compareStatistics(const _INTR_STRING& p_Metric,
+                                    const rapidjson::Value& p_Current,
+                                    const rapidjson::Value& p_Baseline,
+                                    rapidjson::Value& p_Regressions,
+                                    rapidjson::Document& p_Doc)
+{
+  static const char* statNames[] = {"mean", "median", "p95", "p99"};
+
+  for (const char* statName : statNames)
+  {
+    if (!p_Current.HasMember(statName) || !p_Baseline.HasMember(statName))
+    {
+      continue;
+    }
+
+    const float current = p_Current[statName].GetFloat();
+    const float baseline = p_Baseline[statName].GetFloat();
+
+    if (baseline < _minComparedTime ||
+        current <= baseline * (1.0f + Settings::Manager::_benchmarkThreshold))
+    {
+      continue;
+    }
+
+    const _INTR_STRING metric = p_Metric + "." + statName;
+    const float change = current / baseline - 1.0f;
+    _INTR_LOG_WARNING("Regression in '%s': %.3f ms -> %.3f ms (+%.1f%%)",
+                      metric.c_str(), baseline, current, change * 100.0f);
+
+    rapidjson::Value metricValue;
+    metricValue.SetString(metric.c_str(), p_Doc.GetAllocator());
+
+    rapidjson::Value regression = rapidjson::Value(rapidjson::kObjectType);
+    regression.AddMember("metric", metricValue, p_Doc.GetAllocator());
+    regression.AddMember("baseline", baseline, p_Doc.GetAllocator());
+    regression.AddMember("current", current, p_Doc.GetAllocator());
+    regression.AddMember("change", change, p_Doc.GetAllocator());
+    p_Regressions.PushBack(regression, p_Doc.GetAllocator());
+  }
+}
+
+// <-
+
+_INTR_INLINE void compareData(const _INTR_STRING& p_Prefix,
+                              const rapidjson::Value& p_Current,
+                              const rapidjson::Value& p_Baseline,
+                              rapidjson::Value& p_Regressions,
+                              rapidjson::Document& p_Doc)
+{
+  static const char* timeNames[] = {"frameTime", "cpuFrameTime",
+                                    "cullingTime"};
+
+  for (const char* timeName : timeNames)
+  {
+    if (p_Baseline.HasMember(timeName))
+    {
+      compareStatistics(p_Prefix + "." + timeName, p_Current[timeName],
+                        p_Baseline[timeName], p_Regressions, p_Doc);
+    }
+  }
+
+  if (!p_Baseline.HasMember("stages"))
+  {
+    return;
+  }
+
+  const rapidjson::Value& baselineStages = p_Baseline["stages"];
+  const rapidjson::Value& currentStages = p_Current["stages"];
+  for (uint32_t i = 0u; i < FrameStage::kCount; ++i)
+  {
+    if (baselineStages.HasMember(_frameStageNames[i]))
+    {
+      compareStatistics(p_Prefix + ".stages." + _frameStageNames[i],
+                        currentStages[_frameStageNames[i]],
+                        baselineStages[_frameStageNames[i]], p_Regressions,
+                        p_Doc);
+    }
+  }
+}
+
+// <-
+
+_INTR_INLINE bool loadReport(const _INTR_STRING& p_FilePath,
+                             rapidjson::Document& p_Report)
+{
+  FILE* fp = fopen(p_FilePath.c_str(), "rb");
+
+  if (fp == nullptr)
+  {
+    return false;
+  }
+
+  char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+  {
+    rapidjson::FileReadStream is(fp, readBuffer, 65536u);
+    p_Report.ParseStream(is);
+    fclose(fp);
+  }
+  Memory::Tlsf::MainAllocator::free(readBuffer);
+
+  return !p_Report.HasParseError() && p_Report.IsObject() &&
+         p_Report.HasMember("total") && p_Report.HasMember("paths");
+}
+
+// <-
+
+_INTR_INLINE void addCullingComparisonPaths(_INTR_ARRAY(Benchmark::Path) &
+                                            p_Paths)
+{
+  // Runs each path with BVH culling first and with brute force culling right
+  // after, so both see the same scene and camera movement
+  _INTR_ARRAY(Benchmark::Path) paths;
+  for (uint32_t i = 0u; i < p_Paths.size(); ++i)
+  {
+    Benchmark::Path bvhPath = p_Paths[i];
+    bvhPath.name += " (BVH culling)";
+    bvhPath.bvhCullingEnabled = true;
+    paths.push_back(bvhPath);
+
+    Benchmark::Path bruteForcePath = p_Paths[i];
+    bruteForcePath.name += " (brute force culling)";
+    bruteForcePath.bvhCullingEnabled = false;
+    paths.push_back(bruteForcePath);
+  }
+
+  p_Paths.swap(paths);
+}
+
+// <-
+
+_INTR_INLINE void addCullingComparison(const _INTR_ARRAY(Benchmark::Path) &
+                                           p_Paths,
+                                       const _INTR_ARRAY(Benchmark::Data) &
+                                           p_Data,
+                                       rapidjson::Document& p_Report)
+{
+  _INTR_ARRAY(float) bvhCullingTimes;
+  _INTR_ARRAY(float) bruteForceCullingTimes;
+  for (uint32_t pathIdx = 0u; pathIdx < p_Paths.size(); ++pathIdx)
+  {
+    _INTR_ARRAY(float)& cullingTimes = p_Paths[pathIdx].bvhCullingEnabled
+                                           ? bvhCullingTimes
+                                           : bruteForceCullingTimes;
+    cullingTimes.insert(cullingTimes.end(),
+                        p_Data[pathIdx].cullingTimes.begin(),
+                        p_Data[pathIdx].cullingTimes.end());
+  }
+
+  rapidjson::Value comparison = rapidjson::Value(rapidjson::kObjectType);
+  addStatistics("bvh", bvhCullingTimes, comparison, p_Report);
+  addStatistics("bruteForce", bruteForceCullingTimes, comparison, p_Report);
+  p_Report.AddMember("cullingComparison", comparison,
+                     p_Report.GetAllocator());
+
+  const float bvhMean = Benchmark::calcStatistics(bvhCullingTimes).mean;
+  const float bruteForceMean =
+      Benchmark::calcStatistics(bruteForceCullingTimes).mean;
+  _INTR_LOG_INFO("Mean culling time: %.3f ms (BVH) vs. %.3f ms (brute force)",
+                 bvhMean, bruteForceMean);
+}
 }
 
 void Benchmark::init() {}
@@ -64,18 +292,29 @@ void Benchmark::activate()
 
   parseBenchmark(_benchmarkDesc);
   assembleBenchmarkPaths(_benchmarkDesc, _paths);
+
+  _bvhCullingEnabledBeforeBenchmark = Settings::Manager::_bvhCullingEnabled;
+  if (Settings::Manager::_benchmarkCompareCulling)
+  {
+    addCullingComparisonPaths(_paths);
+  }
+
   _benchmarkData.resize(_paths.size());
 
   _INTR_LOG_INFO("Starting benchmark...\n---");
   if (!_paths.empty())
   {
+    Settings::Manager::_bvhCullingEnabled = _paths[0u].bvhCullingEnabled;
     _INTR_LOG_INFO("Benchmarking path '%s'...", _paths[0u].name.c_str());
   }
 }
 
 // <-
 
-void Benchmark::deativate() {}
+void Benchmark::deativate()
+{
+  Settings::Manager::_bvhCullingEnabled = _bvhCullingEnabledBeforeBenchmark;
+}
 
 // <-
 
@@ -125,6 +364,7 @@ void Benchmark::assembleBenchmarkPaths(
     path.name = pathDesc["name"].GetString();
     path.camSpeed = pathDesc["camSpeed"].GetFloat();
     path.currentTime = pathDesc["currentTime"].GetFloat();
+    path.bvhCullingEnabled = Settings::Manager::_bvhCullingEnabled;
 
     for (uint32_t j = 0u; j < nodeDescs.Size(); ++j)
     {
@@ -178,8 +418,21 @@ void Benchmark::update(float p_DeltaT)
 
   World::_currentTime = currentPath.currentTime;
 
+  // Skip the first frame of each path since the timings of the last frame
+  // still belong to the previous path
+  if (_pathPos > 0.0f)
+  {
+    data.frameTimes.push_back(TaskManager::_lastActualFrameDuration * 1000.0f);
+    data.cpuFrameTimes.push_back(TaskManager::_lastCpuFrameDuration);
+    data.cullingTimes.push_back(
+        Resources::FrustumManager::_lastCullingDuration);
+    for (uint32_t i = 0u; i < FrameStage::kCount; ++i)
+    {
+      data.stageTimes[i].push_back(TaskManager::_lastStageDurations[i]);
+    }
+  }
+
   _pathPos += p_DeltaT * currentPath.camSpeed;
-  data.meanFps = 1.0f / TaskManager::_lastActualFrameDuration;
 
   if (_pathPos >= 1.0f)
   {
@@ -199,12 +452,14 @@ void Benchmark::update(float p_DeltaT)
                        (uint32_t)totalScore);
       }
 
+      writeReport(_paths, _benchmarkData);
+
       // Reset data
       {
         _pathIdx = 0u;
         for (uint32_t i = 0u; i < _benchmarkData.size(); ++i)
         {
-          _benchmarkData[i] = Data();
+          _benchmarkData[i].clear();
         }
       }
     }
@@ -213,10 +468,182 @@ void Benchmark::update(float p_DeltaT)
       _INTR_LOG_INFO("Score: %u", data.calcScore());
     }
 
+    Settings::Manager::_bvhCullingEnabled = _paths[_pathIdx].bvhCullingEnabled;
     _INTR_LOG_INFO("Benchmarking path '%s'...", _paths[_pathIdx].name.c_str());
     _pathPos = 0.0f;
   }
 }
+
+// <-
+
+Benchmark::Statistics
+Benchmark::calcStatistics(const _INTR_ARRAY(float) & p_Samples)
+{
+  Statistics stats = {};
+  if (p_Samples.empty())
+  {
+    return stats;
+  }
+
+  _INTR_ARRAY(float) sortedSamples = p_Samples;
+  std::sort(sortedSamples.begin(), sortedSamples.end());
+
+  double sum = 0.0;
+  for (uint32_t i = 0u; i < sortedSamples.size(); ++i)
+    sum += sortedSamples[i];
+
+  stats.min = sortedSamples.front();
+  stats.mean = (float)(sum / sortedSamples.size());
+  stats.median = calcPercentile(sortedSamples, 0.5f);
+  stats.p95 = calcPercentile(sortedSamples, 0.95f);
+  stats.p99 = calcPercentile(sortedSamples, 0.99f);
+  stats.max = sortedSamples.back();
+
+  return stats;
+}
+
+// <-
+
+bool Benchmark::writeReport(const _INTR_ARRAY(Path) & p_Paths,
+                            const _INTR_ARRAY(Data) & p_Data)
+{
+  _INTR_STRING worldFileName, worldFileExtension;
+  StringUtil::extractFileNameAndExtension(World::_filePath, worldFileName,
+                                          worldFileExtension);
+
+  rapidjson::Document report = rapidjson::Document(rapidjson::kObjectType);
+
+  rapidjson::Value worldValue;
+  worldValue.SetString(worldFileName.c_str(), report.GetAllocator());
+  report.AddMember("world", worldValue, report.GetAllocator());
+  report.AddMember("timestamp", (uint64_t)std::time(nullptr),
+                   report.GetAllocator());
+
+  // Per path data and the data of all frames of all paths combined
+  Data totalData;
+  rapidjson::Value paths = rapidjson::Value(rapidjson::kArrayType);
+  for (uint32_t pathIdx = 0u; pathIdx < p_Paths.size(); ++pathIdx)
+  {
+    const Data& data = p_Data[pathIdx];
+
+    rapidjson::Value path = rapidjson::Value(rapidjson::kObjectType);
+    addData(p_Paths[pathIdx].name.c_str(), data, path, report);
+    paths.PushBack(path, report.GetAllocator());
+
+    totalData.frameTimes.insert(totalData.frameTimes.end(),
+                                data.frameTimes.begin(), data.frameTimes.end());
+    totalData.cpuFrameTimes.insert(totalData.cpuFrameTimes.end(),
+                                   data.cpuFrameTimes.begin(),
+                                   data.cpuFrameTimes.end());
+    totalData.cullingTimes.insert(totalData.cullingTimes.end(),
+                                  data.cullingTimes.begin(),
+                                  data.cullingTimes.end());
+    for (uint32_t i = 0u; i < FrameStage::kCount; ++i)
+    {
+      totalData.stageTimes[i].insert(totalData.stageTimes[i].end(),
+                                     data.stageTimes[i].begin(),
+                                     data.stageTimes[i].end());
+    }
+  }
+
+  rapidjson::Value total = rapidjson::Value(rapidjson::kObjectType);
+  addData("total", totalData, total, report);
+  report.AddMember("total", total, report.GetAllocator());
+  report.AddMember("paths", paths, report.GetAllocator());
+  report.AddMember("scratchMemoryPeakInBytes",
+                   Memory::ScratchAllocator::_peakUsageInBytes,
+                   report.GetAllocator());
+
+  if (Settings::Manager::_benchmarkCompareCulling)
+  {
+    addCullingComparison(p_Paths, p_Data, report);
+  }
+
+  // Compare against the baseline
+  bool passed = true;
+  const _INTR_STRING& baselineFilePath = Settings::Manager::_benchmarkBaseline;
+  if (!baselineFilePath.empty())
+  {
+    rapidjson::Document baseline;
+    if (loadReport(baselineFilePath, baseline))
+    {
+      rapidjson::Value regressions = rapidjson::Value(rapidjson::kArrayType);
+
+      compareData("total", report["total"], baseline["total"], regressions,
+                  report);
+
+      const rapidjson::Value& baselinePaths = baseline["paths"];
+      const rapidjson::Value& currentPaths = report["paths"];
+      for (uint32_t i = 0u; i < currentPaths.Size(); ++i)
+      {
+        const _INTR_STRING pathName = currentPaths[i]["name"].GetString();
+        for (uint32_t j = 0u; j < baselinePaths.Size(); ++j)
+        {
+          if (pathName == baselinePaths[j]["name"].GetString())
+          {
+            compareData(pathName, currentPaths[i], baselinePaths[j],
+                        regressions, report);
+            break;
+          }
+        }
+      }
+
+      passed = regressions.Empty();
+
+      rapidjson::Value baselineValue;
+      baselineValue.SetString(baselineFilePath.c_str(), report.GetAllocator());
+      report.AddMember("baseline", baselineValue, report.GetAllocator());
+      report.AddMember("threshold", Settings::Manager::_benchmarkThreshold,
+                       report.GetAllocator());
+      report.AddMember("regressions", regressions, report.GetAllocator());
+      report.AddMember("passed", passed, report.GetAllocator());
+
+      if (passed)
+      {
+        _INTR_LOG_INFO("No regressions compared to baseline '%s'...",
+                       baselineFilePath.c_str());
+      }
+      else
+      {
+        _INTR_LOG_ERROR("Regressions detected compared to baseline '%s'...",
+                        baselineFilePath.c_str());
+      }
+    }
+    else
+    {
+      _INTR_LOG_WARNING("Failed to load benchmark baseline from file '%s'...",
+                        baselineFilePath.c_str());
+    }
+  }
+
+  // Write report
+  const _INTR_STRING reportFilePath =
+      "benchmark_report_" + worldFileName + "_" +
+      StringUtil::toString((uint64_t)std::time(nullptr)) + ".json";
+
+  FILE* fp = fopen(reportFilePath.c_str(), "wb");
+
+  if (fp == nullptr)
+  {
+    _INTR_LOG_WARNING("Failed to write benchmark report to file '%s'...",
+                      reportFilePath.c_str());
+    return passed;
+  }
+
+  {
+    char* writeBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+    rapidjson::FileWriteStream os(fp, writeBuffer, 65536u);
+    rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
+    report.Accept(writer);
+    fclose(fp);
+    Memory::Tlsf::MainAllocator::free(writeBuffer);
+  }
+
+  _INTR_LOG_INFO("Benchmark report written to file '%s'...",
+                 reportFilePath.c_str());
+
+  return passed;
+}
 }
 }
 }
@@ -28,14 +28,48 @@ struct Benchmark
     _INTR_ARRAY(glm::vec3) nodePositions;
     float camSpeed;
     float currentTime;
+    bool bvhCullingEnabled;
   };
 
+  struct Statistics
+  {
+    float min;
+    float mean;
+    float median;
+    float p95;
+    float p99;
+    float max;
+  };
+
+  /**
+   * Per frame timings (in ms) recorded while benchmarking a path.
+   */
   struct Data
   {
-    Data() { meanFps = 0.0f; }
+    _INTR_INLINE uint32_t calcScore() const
+    {
+      float totalTime = 0.0f;
+      for (uint32_t i = 0u; i < frameTimes.size(); ++i)
+        totalTime += frameTimes[i];
+
+      const float meanFps =
+          totalTime > 0.0f ? frameTimes.size() * 1000.0f / totalTime : 0.0f;
+      return (uint32_t)(meanFps * 1337.0f);
+    }
 
-    _INTR_INLINE uint32_t calcScore() { return (uint32_t)(meanFps * 1337.0f); }
-    float meanFps;
+    _INTR_INLINE void clear()
+    {
+      frameTimes.clear();
+      cpuFrameTimes.clear();
+      cullingTimes.clear();
+      for (uint32_t i = 0u; i < FrameStage::kCount; ++i)
+        stageTimes[i].clear();
+    }
+
+    _INTR_ARRAY(float) frameTimes;
+    _INTR_ARRAY(float) cpuFrameTimes;
+    _INTR_ARRAY(float) cullingTimes;
+    _INTR_ARRAY(float) stageTimes[FrameStage::kCount];
   };
 
   static void init();
@@ -46,6 +80,22 @@ struct Benchmark
   static void assembleBenchmarkPaths(const rapidjson::Document& p_BenchmarkDesc,
                                      _INTR_ARRAY(Path) & p_Paths);
   static void update(float p_DeltaT);
+
+  // <-
+
+  /**
+   * Calculates min/mean/median/p95/p99/max of the given samples.
+   */
+  static Statistics calcStatistics(const _INTR_ARRAY(float) & p_Samples);
+
+  /**
+   * Writes a JSON report for the recorded data. If a baseline report is set in
+   * the settings, the run is compared against it and all metrics regressing by
+   * more than the configured threshold are reported. Returns false if any
+   * regression was detected.
+   */
+  static bool writeReport(const _INTR_ARRAY(Path) & p_Paths,
+                          const _INTR_ARRAY(Data) & p_Data);
 };
 }
 }
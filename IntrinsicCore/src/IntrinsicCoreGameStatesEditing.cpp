@@ -1265,9 +1265,10 @@ void Editing::update(float p_DeltaT)
         camOffset * Components::CameraManager::_forward(World::_activeCamera);
 
     const float blendFactor = deltaT * 2.0f;
-    Components::NodeManager::_position(camNodeRef) =
+    Components::NodeManager::setPosition(
+        camNodeRef,
         (1.0f - blendFactor) * Components::NodeManager::_position(camNodeRef) +
-        blendFactor * newPosition;
+            blendFactor * newPosition);
   }
 
   // Snap/align currently selected object to the ground
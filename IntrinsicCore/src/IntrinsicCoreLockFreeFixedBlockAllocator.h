@@ -26,46 +26,91 @@ struct Block
   uint32_t memoryOffset;
 };
 
+/**
+ * Thread safe allocator for blocks of a fixed size. Blocks which have never
+ * been allocated are handed out by bumping a watermark, freed blocks are
+ * recycled via a lock-free stack. If asserts are enabled, each block is
+ * tagged with the reset epoch it has been allocated in to detect double frees.
+ */
 template <uint32_t BlockCount, uint32_t BlockSizeInBytes>
 struct LockFreeFixedBlockAllocator
 {
-  LockFreeFixedBlockAllocator() {}
+  LockFreeFixedBlockAllocator() : _memory(nullptr), _offset(0u)
+  {
+#if defined(_INTR_ASSERTS_ENABLED)
+    _epoch = 0u;
+    for (uint32_t i = 0u; i < BlockCount; ++i)
+    {
+      _blockEpochs[i].store(0u, std::memory_order_relaxed);
+    }
+#endif // _INTR_ASSERTS_ENABLED
+  }
 
   // <-
 
   _INTR_INLINE void init(uint8_t* p_Memory = nullptr, uint32_t p_Offset = 0u)
   {
-    _memoryBlocks.resize(BlockCount);
-
-    uint32_t currentOffset = 0u;
-    for (uint32_t i = 0u; i < BlockCount; ++i)
-    {
-      const uint32_t actualOffset = p_Offset + currentOffset;
-      _memoryBlocks[i] = {p_Memory != nullptr ? &p_Memory[actualOffset]
-                                              : nullptr,
-                          actualOffset};
-      currentOffset += BlockSizeInBytes;
-    }
+    _memory = p_Memory;
+    _offset = p_Offset;
+    reset();
   }
 
   // <-
 
   _INTR_INLINE Block allocate()
   {
-    _INTR_ASSERT(!_memoryBlocks.empty());
-    return _memoryBlocks.pop_back();
+    uint32_t blockIdx;
+    if (!_freeBlocks.pop(blockIdx))
+    {
+      blockIdx = _blockWatermark.fetch_add(1u, std::memory_order_relaxed);
+      _INTR_ASSERT(blockIdx < BlockCount && "Out of blocks");
+    }
+
+#if defined(_INTR_ASSERTS_ENABLED)
+    _blockEpochs[blockIdx].store(_epoch, std::memory_order_relaxed);
+#endif // _INTR_ASSERTS_ENABLED
+
+    const uint32_t actualOffset = _offset + blockIdx * BlockSizeInBytes;
+    return {_memory != nullptr ? &_memory[actualOffset] : nullptr,
+            actualOffset};
   }
 
   // <-
 
   _INTR_INLINE void free(const Block& p_Block)
   {
-    _memoryBlocks.push_back(p_Block);
+    const uint32_t blockIdx =
+        (p_Block.memoryOffset - _offset) / BlockSizeInBytes;
+    _INTR_ASSERT(blockIdx < BlockCount);
+
+#if defined(_INTR_ASSERTS_ENABLED)
+    const uint32_t blockEpoch =
+        _blockEpochs[blockIdx].exchange(0u, std::memory_order_relaxed);
+    _INTR_ASSERT(blockEpoch == _epoch &&
+                 "Block freed twice or allocated before the last reset");
+#endif // _INTR_ASSERTS_ENABLED
+
+    // The stack holds a node for each block, so pushing can only fail if the
+    // same block is pushed more than once
+    const bool result = _freeBlocks.push(blockIdx);
+    _INTR_ASSERT(result && "Free block stack full");
   }
 
   // <-
 
-  _INTR_INLINE void reset() { _memoryBlocks.resize(BlockCount); }
+  /**
+   * Frees all blocks. Must not be called concurrently to allocations.
+   */
+  _INTR_INLINE void reset()
+  {
+    _freeBlocks.clear();
+    _blockWatermark.store(0u, std::memory_order_release);
+
+#if defined(_INTR_ASSERTS_ENABLED)
+    // Epoch 0 marks free blocks
+    _epoch = _epoch + 1u == 0u ? 1u : _epoch + 1u;
+#endif // _INTR_ASSERTS_ENABLED
+  }
 
   // <-
 
@@ -77,17 +122,31 @@ struct LockFreeFixedBlockAllocator
 
   // <-
 
-  _INTR_INLINE uint32_t availablePageCount() { return _memoryBlocks.size(); }
+  _INTR_INLINE uint32_t availablePageCount()
+  {
+    const uint32_t watermark = std::min(
+        _blockWatermark.load(std::memory_order_relaxed), BlockCount);
+    return BlockCount - watermark + (uint32_t)_freeBlocks.size();
+  }
 
   // <-
 
   _INTR_INLINE uint32_t calcAvailableMemoryInBytes()
   {
-    return _memoryBlocks.size() * BlockSizeInBytes;
+    return availablePageCount() * BlockSizeInBytes;
   }
 
 private:
-  Containers::LockFreeStack<Block, BlockCount> _memoryBlocks;
+  uint8_t* _memory;
+  uint32_t _offset;
+
+  std::atomic<uint32_t> _blockWatermark;
+  Containers::LockFreeStack<uint32_t, BlockCount> _freeBlocks;
+
+#if defined(_INTR_ASSERTS_ENABLED)
+  uint32_t _epoch;
+  std::atomic<uint32_t> _blockEpochs[BlockCount];
+#endif // _INTR_ASSERTS_ENABLED
 };
 }
 }
@@ -0,0 +1,186 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Containers
+{
+/**
+ * Bounded, lock-free multi producer/multi consumer FIFO queue. Each slot
+ * carries a sequence number which tells producers and consumers whether the
+ * slot is ready to be written or read in the current lap.
+ */
+template <class T, uint64_t Capacity> struct LockFreeQueue
+{
+  LockFreeQueue()
+  {
+    _cells =
+        (Cell*)Memory::Tlsf::MainAllocator::allocate(Capacity * sizeof(Cell));
+    for (uint64_t i = 0u; i < Capacity; ++i)
+    {
+      new (&_cells[i]) Cell();
+    }
+
+    clear();
+  }
+
+  // <-
+
+  ~LockFreeQueue()
+  {
+    Memory::Tlsf::MainAllocator::free(_cells);
+    _cells = nullptr;
+  }
+
+  // <-
+
+  /**
+   * Appends the given element. Returns false if the queue is full.
+   */
+  _INTR_INLINE bool push(const T& p_Element)
+  {
+    Cell* cell;
+    uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell = &_cells[pos % Capacity];
+      const uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      const int64_t diff = (int64_t)seq - (int64_t)pos;
+
+      if (diff == 0)
+      {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1u,
+                                              std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        // Slot still occupied by the previous lap
+        return false;
+      }
+      else
+      {
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->element = p_Element;
+    cell->sequence.store(pos + 1u, std::memory_order_release);
+
+    return true;
+  }
+
+  // <-
+
+  /**
+   * Removes the oldest element. Returns false if the queue is empty.
+   */
+  _INTR_INLINE bool pop(T& p_Element)
+  {
+    Cell* cell;
+    uint64_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell = &_cells[pos % Capacity];
+      const uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      const int64_t diff = (int64_t)seq - (int64_t)(pos + 1u);
+
+      if (diff == 0)
+      {
+        if (_dequeuePos.compare_exchange_weak(pos, pos + 1u,
+                                              std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        // Slot not written yet
+        return false;
+      }
+      else
+      {
+        pos = _dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    p_Element = cell->element;
+    cell->sequence.store(pos + Capacity, std::memory_order_release);
+
+    return true;
+  }
+
+  // <-
+
+  /**
+   * Removes all elements. Must not be called concurrently to any other
+   * operation.
+   */
+  _INTR_INLINE void clear()
+  {
+    for (uint64_t i = 0u; i < Capacity; ++i)
+    {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    _enqueuePos.store(0u, std::memory_order_relaxed);
+    _dequeuePos.store(0u, std::memory_order_release);
+  }
+
+  // <-
+
+  /**
+   * The element count. Only approximate while other threads are pushing or
+   * popping.
+   */
+  _INTR_INLINE uint64_t size() const
+  {
+    const uint64_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+    const uint64_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0u;
+  }
+
+  // <-
+
+  _INTR_INLINE bool empty() const { return size() == 0u; }
+
+  // <-
+
+  _INTR_INLINE uint64_t capacity() const { return Capacity; }
+
+private:
+  struct Cell
+  {
+    std::atomic<uint64_t> sequence;
+    T element;
+  };
+
+  Cell* _cells;
+
+  // Producers and consumers work on separate cache lines
+  uint8_t _padding0[_INTR_CACHE_LINE_SIZE_IN_BYTES - sizeof(Cell*)];
+  std::atomic<uint64_t> _enqueuePos;
+  uint8_t _padding1[_INTR_CACHE_LINE_SIZE_IN_BYTES - sizeof(uint64_t)];
+  std::atomic<uint64_t> _dequeuePos;
+};
+}
+}
+}
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #pragma once
 
 namespace Intrinsic
@@ -20,111 +21,209 @@ namespace Core
 {
 namespace Containers
 {
+/**
+ * Bounded, lock-free multi producer/multi consumer LIFO stack. Elements are
+ * stored in a fixed pool of nodes which are linked via their indices; the
+ * heads are tagged with a counter to avoid ABA issues. An element is only
+ * visible to consumers after it has been fully written.
+ */
 template <class T, uint64_t Capacity> struct LockFreeStack
 {
+  static_assert(Capacity < 0xFFFFFFFFu, "Capacity too large");
+
   LockFreeStack()
   {
-    _data = (T*)Memory::Tlsf::MainAllocator::allocate(Capacity * sizeof(T));
-    _capacity = Capacity;
-    _size = 0u;
+    _nodes =
+        (Node*)Memory::Tlsf::MainAllocator::allocate(Capacity * sizeof(Node));
+    for (uint64_t i = 0u; i < Capacity; ++i)
+    {
+      new (&_nodes[i]) Node();
+    }
+
+    clear();
   }
 
   // <-
 
   ~LockFreeStack()
   {
-    Memory::Tlsf::MainAllocator::free(_data);
-    _data = nullptr;
+    Memory::Tlsf::MainAllocator::free(_nodes);
+    _nodes = nullptr;
   }
 
   // <-
 
-  _INTR_INLINE void push_back(const T& p_Element)
+  /**
+   * Pushes the given element. Returns false if the stack is full.
+   */
+  _INTR_INLINE bool push(const T& p_Element)
   {
-    const Threading::Atomic oldSize = Threading::interlockedAdd(_size, 1);
-    _INTR_ASSERT(oldSize + 1u <= Capacity && "Stack overflow");
-    _data[oldSize] = p_Element;
-  }
+    const uint32_t nodeIdx = acquireNode();
+    if (nodeIdx == kInvalidIdx)
+    {
+      return false;
+    }
 
-  // <-
+    _nodes[nodeIdx].element = p_Element;
+    pushNode(_head, nodeIdx);
+    _size.fetch_add(1u, std::memory_order_relaxed);
 
-  _INTR_INLINE T pop_back()
-  {
-    const uint64_t oldSize = Threading::interlockedSub(_size, 1);
-    _INTR_ASSERT(oldSize - 1u <= Capacity && "Stack underflow");
-    return _data[oldSize - 1u];
+    return true;
   }
 
   // <-
 
-  _INTR_INLINE void resize(uint64_t p_Size) { _size = p_Size; }
+  /**
+   * Pops the most recently pushed element. Returns false if the stack is
+   * empty.
+   */
+  _INTR_INLINE bool pop(T& p_Element)
+  {
+    const uint32_t nodeIdx = popNode(_head);
+    if (nodeIdx == kInvalidIdx)
+    {
+      return false;
+    }
 
-  // <-
+    p_Element = _nodes[nodeIdx].element;
+    pushNode(_freeNodes, nodeIdx);
+    _size.fetch_sub(1u, std::memory_order_relaxed);
 
-  _INTR_INLINE void clear() { resize(0u); }
+    return true;
+  }
 
   // <-
 
-  _INTR_INLINE bool empty() const { return _size == 0u; }
+  /**
+   * Removes all elements. Must not be called concurrently to any other
+   * operation.
+   */
+  _INTR_INLINE void clear()
+  {
+    _head.store(pack(kInvalidIdx, 0u), std::memory_order_relaxed);
+    _freeNodes.store(pack(kInvalidIdx, 0u), std::memory_order_relaxed);
+    _nodeWatermark.store(0u, std::memory_order_relaxed);
+    _size.store(0u, std::memory_order_release);
+  }
 
   // <-
 
-  _INTR_INLINE T& back()
+  _INTR_INLINE bool empty() const
   {
-    _INTR_ASSERT(!empty());
-    return _data[_size - 1u];
+    return (uint32_t)_head.load(std::memory_order_acquire) == kInvalidIdx;
   }
 
   // <-
 
-  _INTR_INLINE const T& back() const
+  /**
+   * The element count. Only approximate while other threads are pushing or
+   * popping.
+   */
+  _INTR_INLINE uint64_t size() const
   {
-    _INTR_ASSERT(!empty());
-    return _data[_size - 1u];
+    return _size.load(std::memory_order_relaxed);
   }
 
   // <-
 
-  _INTR_INLINE uint64_t capacity() const { return _capacity; }
+  _INTR_INLINE uint64_t capacity() const { return Capacity; }
 
-  // <-
+private:
+  enum
+  {
+    kInvalidIdx = 0xFFFFFFFFu
+  };
 
-  _INTR_INLINE uint64_t size() const { return _size; }
+  struct Node
+  {
+    T element;
+    std::atomic<uint32_t> next;
+  };
 
   // <-
 
-  _INTR_INLINE T& operator[](uint64_t p_Idx) { return _data[p_Idx]; }
+  _INTR_INLINE static uint64_t pack(uint32_t p_NodeIdx, uint32_t p_Tag)
+  {
+    return ((uint64_t)p_Tag << 32u) | p_NodeIdx;
+  }
 
   // <-
 
-  _INTR_INLINE T& operator[](uint64_t p_Idx) const { return _data[p_Idx]; }
+  _INTR_INLINE void pushNode(std::atomic<uint64_t>& p_Head, uint32_t p_NodeIdx)
+  {
+    uint64_t head = p_Head.load(std::memory_order_relaxed);
+    while (true)
+    {
+      _nodes[p_NodeIdx].next.store((uint32_t)head, std::memory_order_relaxed);
+
+      const uint64_t newHead = pack(p_NodeIdx, (uint32_t)(head >> 32u) + 1u);
+      if (p_Head.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                       std::memory_order_relaxed))
+      {
+        return;
+      }
+    }
+  }
 
   // <-
 
-  _INTR_INLINE void insert(const _INTR_ARRAY(T) & p_Array)
+  _INTR_INLINE uint32_t popNode(std::atomic<uint64_t>& p_Head)
   {
-    const Threading::Atomic oldSize =
-        Threading::interlockedAdd(_size, p_Array.size());
-    _INTR_ASSERT(oldSize + p_Array.size() <= _capacity);
-    memcpy(&_data[oldSize], p_Array.data(), p_Array.size() * sizeof(T));
+    uint64_t head = p_Head.load(std::memory_order_acquire);
+    while (true)
+    {
+      const uint32_t nodeIdx = (uint32_t)head;
+      if (nodeIdx == kInvalidIdx)
+      {
+        return kInvalidIdx;
+      }
+
+      // Might read the link of a node which got popped concurrently - the tag
+      // makes the exchange fail in this case
+      const uint32_t next =
+          _nodes[nodeIdx].next.load(std::memory_order_relaxed);
+
+      const uint64_t newHead = pack(next, (uint32_t)(head >> 32u) + 1u);
+      if (p_Head.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                                       std::memory_order_acquire))
+      {
+        return nodeIdx;
+      }
+    }
   }
 
   // <-
 
-  _INTR_INLINE void copy(_INTR_ARRAY(T) & p_Array) const
+  _INTR_INLINE uint32_t acquireNode()
   {
-    const uint32_t startIdx = (uint32_t)p_Array.size();
-    p_Array.resize(p_Array.size() + _size);
-    memcpy(&p_Array.data()[startIdx], _data, _size * sizeof(T));
+    const uint32_t nodeIdx = popNode(_freeNodes);
+    if (nodeIdx != kInvalidIdx)
+    {
+      return nodeIdx;
+    }
+
+    // Nodes which have never been used are handed out in order
+    if (_nodeWatermark.load(std::memory_order_relaxed) >= Capacity)
+    {
+      return kInvalidIdx;
+    }
+
+    const uint64_t freshNodeIdx =
+        _nodeWatermark.fetch_add(1u, std::memory_order_relaxed);
+    return freshNodeIdx < Capacity ? (uint32_t)freshNodeIdx : kInvalidIdx;
   }
 
   // <-
 
-  T* _data;
+  Node* _nodes;
 
-private:
-  uint64_t _capacity;
-  Threading::Atomic _size;
+  // Heads are kept on separate cache lines
+  std::atomic<uint64_t> _head;
+  uint8_t _padding0[_INTR_CACHE_LINE_SIZE_IN_BYTES - sizeof(uint64_t)];
+  std::atomic<uint64_t> _freeNodes;
+  uint8_t _padding1[_INTR_CACHE_LINE_SIZE_IN_BYTES - sizeof(uint64_t)];
+  std::atomic<uint64_t> _nodeWatermark;
+  std::atomic<uint64_t> _size;
 };
 }
 }
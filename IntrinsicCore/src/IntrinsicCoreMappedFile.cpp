@@ -0,0 +1,148 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Util
+{
+#if defined(_WIN32)
+MappedFile::MappedFile()
+    : _data(nullptr), _size(0u), _fileHandle(INVALID_HANDLE_VALUE),
+      _mappingHandle(nullptr)
+{
+}
+#else
+MappedFile::MappedFile() : _data(nullptr), _size(0u), _fileDescriptor(-1) {}
+#endif // _WIN32
+
+// <-
+
+MappedFile::~MappedFile() { close(); }
+
+// <-
+
+bool MappedFile::open(const char* p_FilePath)
+{
+  close();
+
+#if defined(_WIN32)
+  _fileHandle = CreateFileA(p_FilePath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (_fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+  {
+    close();
+    return false;
+  }
+
+  _mappingHandle =
+      CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+  if (_mappingHandle == nullptr)
+  {
+    close();
+    return false;
+  }
+
+  _data = (const uint8_t*)MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0u, 0u,
+                                        0u);
+  if (_data == nullptr)
+  {
+    close();
+    return false;
+  }
+
+  _size = (uint64_t)fileSize.QuadPart;
+#else
+  _fileDescriptor = ::open(p_FilePath, O_RDONLY);
+  if (_fileDescriptor == -1)
+  {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(_fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+  {
+    close();
+    return false;
+  }
+
+  void* data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE,
+                    _fileDescriptor, 0);
+  if (data == MAP_FAILED)
+  {
+    close();
+    return false;
+  }
+
+  _data = (const uint8_t*)data;
+  _size = (uint64_t)fileStat.st_size;
+#endif // _WIN32
+
+  return true;
+}
+
+// <-
+
+void MappedFile::close()
+{
+#if defined(_WIN32)
+  if (_data != nullptr)
+  {
+    UnmapViewOfFile(_data);
+  }
+  if (_mappingHandle != nullptr)
+  {
+    CloseHandle(_mappingHandle);
+    _mappingHandle = nullptr;
+  }
+  if (_fileHandle != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(_fileHandle);
+    _fileHandle = INVALID_HANDLE_VALUE;
+  }
+#else
+  if (_data != nullptr)
+  {
+    munmap((void*)_data, (size_t)_size);
+  }
+  if (_fileDescriptor != -1)
+  {
+    ::close(_fileDescriptor);
+    _fileDescriptor = -1;
+  }
+#endif // _WIN32
+
+  _data = nullptr;
+  _size = 0u;
+}
+}
+}
+}
@@ -0,0 +1,62 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Util
+{
+/**
+ * Read-only view of a file mapped into the address space of the process.
+ */
+struct MappedFile
+{
+  MappedFile();
+  ~MappedFile();
+
+  /**
+   * Maps the given file. Returns false if the file could not be opened or
+   * mapped.
+   */
+  bool open(const char* p_FilePath);
+
+  /**
+   * Unmaps the file. Pointers retrieved via getData() are invalid afterwards.
+   */
+  void close();
+
+  _INTR_INLINE const uint8_t* getData() const { return _data; }
+  _INTR_INLINE uint64_t getSize() const { return _size; }
+  _INTR_INLINE bool isOpen() const { return _data != nullptr; }
+
+private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  const uint8_t* _data;
+  uint64_t _size;
+
+#if defined(_WIN32)
+  HANDLE _fileHandle;
+  HANDLE _mappingHandle;
+#else
+  int _fileDescriptor;
+#endif // _WIN32
+};
+}
+}
+}
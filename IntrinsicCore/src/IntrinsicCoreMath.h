@@ -441,6 +441,32 @@ _INTR_INLINE void mergePointToAABB(AABB& p_AABB, const glm::vec3& p_Point)
 
 // <-
 
+_INTR_INLINE AABB mergeAABBs(const AABB& p_AABB0, const AABB& p_AABB1)
+{
+  return AABB(calcVecMin(p_AABB0.min, p_AABB1.min),
+              calcVecMax(p_AABB0.max, p_AABB1.max));
+}
+
+// <-
+
+_INTR_INLINE bool isAABBContained(const AABB& p_Inner, const AABB& p_Outer)
+{
+  return p_Outer.min.x <= p_Inner.min.x && p_Outer.min.y <= p_Inner.min.y &&
+         p_Outer.min.z <= p_Inner.min.z && p_Inner.max.x <= p_Outer.max.x &&
+         p_Inner.max.y <= p_Outer.max.y && p_Inner.max.z <= p_Outer.max.z;
+}
+
+// <-
+
+_INTR_INLINE float calcAABBSurfaceArea(const AABB& p_AABB)
+{
+  const glm::vec3 extent = p_AABB.max - p_AABB.min;
+  return 2.0f * (extent.x * extent.y + extent.y * extent.z +
+                 extent.z * extent.x);
+}
+
+// <-
+
 _INTR_INLINE void transformAABBAffine(AABB& p_AABB,
                                       const glm::mat4& p_Transform)
 {
@@ -0,0 +1,355 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+namespace
+{
+const char* _tagNames[Tag::kCount] = {"General",  "Dod",     "Resources",
+                                      "Renderer", "Physics", "Scripts",
+                                      "Scratch"};
+
+// The log allocates from the main allocator and can't be used while reporting
+// that it is exhausted
+thread_local bool _reportingOutOfMemory = false;
+
+// Walking the heaps is not free, so the heap stats are only sampled every few
+// frames
+const uint32_t _heapStatsUpdateInterval = 60u;
+}
+
+// Static members
+Tag::Enum Tracking::_defaultTag = Tag::kDod;
+thread_local uint32_t Tracking::_currentTag = Tag::kCount;
+
+thread_local ThreadTagCounters* Tracking::_threadCounters = nullptr;
+thread_local Tracking::ThreadCountersOwner Tracking::_threadCountersOwner;
+thread_local bool Tracking::_threadCountersReleased = false;
+ThreadTagCounters*
+    Tracking::_threadCounterBlocks[_INTR_MEMORY_TRACKING_MAX_THREAD_COUNT];
+ThreadTagCounters*
+    Tracking::_freeThreadCounterBlocks[_INTR_MEMORY_TRACKING_MAX_THREAD_COUNT];
+uint32_t Tracking::_freeThreadCounterBlockCount = 0u;
+std::atomic<uint32_t> Tracking::_threadCounterBlockCount(0u);
+std::mutex Tracking::_threadCounterMutex;
+
+TagBytes Tracking::_tagBytes[Tag::kCount];
+uint64_t Tracking::_lastTotalAllocationCount[Tag::kCount] = {};
+uint64_t Tracking::_lastFrameAllocationCount[Tag::kCount] = {};
+
+// <-
+
+Tracking::ThreadCountersOwner::~ThreadCountersOwner()
+{
+  if (counters != nullptr)
+  {
+    releaseThreadCounters(counters);
+    counters = nullptr;
+  }
+}
+
+// <-
+
+ThreadTagCounters* Tracking::acquireThreadCounters()
+{
+  ThreadTagCounters* counters = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_threadCounterMutex);
+
+    if (_freeThreadCounterBlockCount > 0u)
+    {
+      counters = _freeThreadCounterBlocks[--_freeThreadCounterBlockCount];
+    }
+    else
+    {
+      const uint32_t blockIdx =
+          _threadCounterBlockCount.load(std::memory_order_relaxed);
+      _INTR_ASSERT(blockIdx < _INTR_MEMORY_TRACKING_MAX_THREAD_COUNT &&
+                   "Max. memory tracking thread count exceeded");
+
+      counters = new ThreadTagCounters();
+
+      // Publish the counters only after they have been fully initialized
+      _threadCounterBlocks[blockIdx] = counters;
+      _threadCounterBlockCount.store(blockIdx + 1u, std::memory_order_release);
+    }
+  }
+
+  _threadCounters = counters;
+
+  // Threads allocating while their thread locals get destroyed keep the
+  // counters they got until the process exits
+  if (!_threadCountersReleased)
+  {
+    _threadCountersOwner.counters = counters;
+  }
+
+  return counters;
+}
+
+// <-
+
+void Tracking::releaseThreadCounters(ThreadTagCounters* p_Counters)
+{
+  _threadCounters = nullptr;
+  _threadCountersReleased = true;
+
+  std::lock_guard<std::mutex> lock(_threadCounterMutex);
+  _freeThreadCounterBlocks[_freeThreadCounterBlockCount++] = p_Counters;
+}
+
+// <-
+
+void Tracking::calcTagStats(TagStats* p_Stats)
+{
+  const uint32_t blockCount =
+      _threadCounterBlockCount.load(std::memory_order_acquire);
+
+  for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+  {
+    TagStats& stats = p_Stats[tagIdx];
+    stats.liveBytes =
+        _tagBytes[tagIdx].liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes =
+        _tagBytes[tagIdx].peakBytes.load(std::memory_order_relaxed);
+    stats.totalAllocationCount = 0u;
+
+    for (uint32_t i = 0u; i < blockCount; ++i)
+    {
+      const ThreadTagCounters* counters = _threadCounterBlocks[i];
+      stats.totalAllocationCount +=
+          counters->allocationCount[tagIdx].load(std::memory_order_relaxed);
+    }
+
+    stats.lastFrameAllocationCount = _lastFrameAllocationCount[tagIdx];
+  }
+}
+
+// <-
+
+void Tracking::onFrameEnded()
+{
+  _INTR_PROFILE_CPU("Memory", "Update Memory Stats");
+
+  TagStats stats[Tag::kCount];
+  calcTagStats(stats);
+
+  for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+  {
+    _lastFrameAllocationCount[tagIdx] =
+        stats[tagIdx].totalAllocationCount - _lastTotalAllocationCount[tagIdx];
+    _lastTotalAllocationCount[tagIdx] = stats[tagIdx].totalAllocationCount;
+  }
+
+  if (TaskManager::_frameCounter % _heapStatsUpdateInterval == 0u)
+  {
+    Tlsf::MainAllocator::updateHeapStats();
+
+    const Tlsf::HeapStats& heapStats = Tlsf::MainAllocator::getHeapStats();
+    _INTR_PROFILE_COUNTER_SET("Main Allocator Committed (MB)",
+                              heapStats.committedSizeInBytes / 1024u / 1024u);
+    _INTR_PROFILE_COUNTER_SET("Main Allocator Pools", heapStats.poolCount);
+    _INTR_PROFILE_COUNTER_SET("Main Allocator Fragmentation (%)",
+                              (int64_t)(heapStats.fragmentation * 100.0f));
+  }
+
+#if defined(_INTR_PROFILING_ENABLED)
+  static MicroProfileToken tokens[Tag::kCount][2u];
+  static bool init = false;
+
+  if (!init)
+  {
+    for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+    {
+      static char charBuffer[128];
+      sprintf(charBuffer, "%s Memory (KB)", _tagNames[tagIdx]);
+      tokens[tagIdx][0] = MicroProfileGetCounterToken(charBuffer);
+
+      sprintf(charBuffer, "%s Allocations Per Frame", _tagNames[tagIdx]);
+      tokens[tagIdx][1] = MicroProfileGetCounterToken(charBuffer);
+    }
+
+    init = true;
+  }
+
+  for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+  {
+    MicroProfileCounterSet(tokens[tagIdx][0],
+                           std::max(stats[tagIdx].liveBytes, (int64_t)0) /
+                               1024);
+    MicroProfileCounterSet(tokens[tagIdx][1],
+                           _lastFrameAllocationCount[tagIdx]);
+  }
+#endif // _INTR_PROFILING_ENABLED
+}
+
+// <-
+
+void Tracking::onOutOfMemory(uint32_t p_RequestedSize)
+{
+  if (_reportingOutOfMemory)
+  {
+    return;
+  }
+  _reportingOutOfMemory = true;
+
+  printf("Out of memory: Failed to allocate %u bytes from the main "
+         "allocator\n",
+         p_RequestedSize);
+
+  TagStats stats[Tag::kCount];
+  calcTagStats(stats);
+
+  for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+  {
+    printf("  %-10s %12lld bytes live, %12lld bytes peak, %10llu "
+           "allocations\n",
+           _tagNames[tagIdx], (long long)stats[tagIdx].liveBytes,
+           (long long)stats[tagIdx].peakBytes,
+           (unsigned long long)stats[tagIdx].totalAllocationCount);
+  }
+
+  writeReport("memory_report_out_of_memory.json");
+
+  _reportingOutOfMemory = false;
+}
+
+// <-
+
+TagStats Tracking::getTagStats(Tag::Enum p_Tag)
+{
+  TagStats stats[Tag::kCount];
+  calcTagStats(stats);
+
+  return stats[p_Tag];
+}
+
+// <-
+
+const char* Tracking::getTagName(Tag::Enum p_Tag) { return _tagNames[p_Tag]; }
+
+// <-
+
+bool Tracking::writeReport(const char* p_FilePath)
+{
+  // Only uses memory from the CRT heap so reports can be written even if the
+  // main allocator is exhausted
+  rapidjson::Document report = rapidjson::Document(rapidjson::kObjectType);
+
+  report.AddMember("timestamp", (uint64_t)std::time(nullptr),
+                   report.GetAllocator());
+  report.AddMember("frame", TaskManager::_frameCounter, report.GetAllocator());
+
+  TagStats stats[Tag::kCount];
+  calcTagStats(stats);
+
+  rapidjson::Value tags = rapidjson::Value(rapidjson::kArrayType);
+  for (uint32_t tagIdx = 0u; tagIdx < Tag::kCount; ++tagIdx)
+  {
+    rapidjson::Value tag = rapidjson::Value(rapidjson::kObjectType);
+    tag.AddMember("name", rapidjson::StringRef(_tagNames[tagIdx]),
+                  report.GetAllocator());
+    tag.AddMember("liveBytes", stats[tagIdx].liveBytes, report.GetAllocator());
+    tag.AddMember("peakBytes", stats[tagIdx].peakBytes, report.GetAllocator());
+    tag.AddMember("totalAllocationCount", stats[tagIdx].totalAllocationCount,
+                  report.GetAllocator());
+    tag.AddMember("lastFrameAllocationCount",
+                  stats[tagIdx].lastFrameAllocationCount,
+                  report.GetAllocator());
+    tags.PushBack(tag, report.GetAllocator());
+  }
+  report.AddMember("tags", tags, report.GetAllocator());
+
+  // Sampled at the end of the frame, walking the heaps here would race with
+  // the other threads
+  const Tlsf::HeapStats& heapStats = Tlsf::MainAllocator::getHeapStats();
+  rapidjson::Value mainAllocator = rapidjson::Value(rapidjson::kObjectType);
+  mainAllocator.AddMember("heapCount", Tlsf::MainAllocator::getHeapCount(),
+                          report.GetAllocator());
+  mainAllocator.AddMember("explicitHugePageHeapCount",
+                          heapStats.explicitHugePageHeapCount,
+                          report.GetAllocator());
+  mainAllocator.AddMember("poolCount", heapStats.poolCount,
+                          report.GetAllocator());
+  mainAllocator.AddMember("reservedSizeInBytes",
+                          heapStats.reservedSizeInBytes, report.GetAllocator());
+  mainAllocator.AddMember("committedSizeInBytes",
+                          heapStats.committedSizeInBytes,
+                          report.GetAllocator());
+  mainAllocator.AddMember("freeSizeInBytes", heapStats.freeSizeInBytes,
+                          report.GetAllocator());
+  mainAllocator.AddMember("largestFreeBlockSizeInBytes",
+                          heapStats.largestFreeBlockSizeInBytes,
+                          report.GetAllocator());
+  mainAllocator.AddMember("fragmentation", heapStats.fragmentation,
+                          report.GetAllocator());
+  report.AddMember("mainAllocator", mainAllocator, report.GetAllocator());
+
+  rapidjson::Value scratch = rapidjson::Value(rapidjson::kObjectType);
+  scratch.AddMember("lastFramePeakUsageInBytes",
+                    ScratchAllocator::_lastFramePeakUsageInBytes,
+                    report.GetAllocator());
+  scratch.AddMember("lastFrameOverflowInBytes",
+                    ScratchAllocator::_lastFrameOverflowInBytes,
+                    report.GetAllocator());
+  scratch.AddMember("peakUsageInBytes", ScratchAllocator::_peakUsageInBytes,
+                    report.GetAllocator());
+  report.AddMember("scratch", scratch, report.GetAllocator());
+
+  // The Lua heap is managed by Lua itself
+  report.AddMember("luaHeapInBytes",
+                   Resources::ScriptManager::calcLuaMemoryUsageInBytes(),
+                   report.GetAllocator());
+
+  rapidjson::Value gpuMemoryPools = rapidjson::Value(rapidjson::kArrayType);
+  R::GpuMemoryManager::compileMemoryStats(gpuMemoryPools, report);
+  report.AddMember("gpuMemoryPools", gpuMemoryPools, report.GetAllocator());
+
+  FILE* fp = fopen(p_FilePath, "wb");
+  if (fp == nullptr)
+  {
+    if (!_reportingOutOfMemory)
+    {
+      _INTR_LOG_WARNING("Failed to write memory report to file '%s'...",
+                        p_FilePath);
+    }
+    return false;
+  }
+
+  {
+    static char writeBuffer[65536u];
+    rapidjson::FileWriteStream os(fp, writeBuffer, sizeof(writeBuffer));
+    rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
+    report.Accept(writer);
+    fclose(fp);
+  }
+
+  if (!_reportingOutOfMemory)
+  {
+    _INTR_LOG_INFO("Memory report written to file '%s'...", p_FilePath);
+  }
+
+  return true;
+}
+}
+}
+}
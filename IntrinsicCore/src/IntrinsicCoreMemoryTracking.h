@@ -0,0 +1,231 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Counters of exited threads are handed over to new threads, so this only
+// limits the count of threads allocating memory at the same time
+#define _INTR_MEMORY_TRACKING_MAX_THREAD_COUNT 64u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+namespace Tag
+{
+enum Enum
+{
+  kGeneral,
+  kDod,
+  kResources,
+  kRenderer,
+  kPhysics,
+  kScripts,
+  kScratch,
+
+  kCount
+};
+}
+
+/**
+ * Allocation counters of a single thread. Only the owning thread writes to the
+ * counters, so no atomic read-modify-write operations are needed.
+ */
+struct ThreadTagCounters
+{
+  ThreadTagCounters()
+  {
+    for (uint32_t i = 0u; i < Tag::kCount; ++i)
+    {
+      allocationCount[i].store(0u, std::memory_order_relaxed);
+    }
+  }
+
+  // Keeps the counters of different threads on separate cache lines
+  uint8_t _padding0[_INTR_CACHE_LINE_SIZE_IN_BYTES];
+  std::atomic<uint64_t> allocationCount[Tag::kCount];
+  uint8_t _padding1[_INTR_CACHE_LINE_SIZE_IN_BYTES];
+};
+
+// <-
+
+/**
+ * Live bytes and high-water mark of a single tag. Both are shared by all
+ * threads, so the high-water mark is exact and includes short-lived peaks
+ * within a frame.
+ */
+struct TagBytes
+{
+  TagBytes() : liveBytes(0), peakBytes(0) {}
+
+  std::atomic<int64_t> liveBytes;
+  std::atomic<int64_t> peakBytes;
+
+  // Keeps the counters of different tags on separate cache lines
+  uint8_t _padding[_INTR_CACHE_LINE_SIZE_IN_BYTES - 2u * sizeof(int64_t)];
+};
+
+// <-
+
+struct TagStats
+{
+  int64_t liveBytes;
+  int64_t peakBytes;
+  uint64_t totalAllocationCount;
+  uint64_t lastFrameAllocationCount;
+};
+
+// <-
+
+/**
+ * Keeps track of the memory used by the different subsystems. Allocations are
+ * attributed to the tag of the innermost active tag scope of the allocating
+ * thread or to the default tag if there is none.
+ */
+struct Tracking
+{
+  _INTR_INLINE static void onAllocate(Tag::Enum p_Tag, uint32_t p_Size)
+  {
+    TagBytes& tagBytes = _tagBytes[p_Tag];
+    const int64_t liveBytes =
+        tagBytes.liveBytes.fetch_add(p_Size, std::memory_order_relaxed) +
+        p_Size;
+
+    // Atomic max, only contended while the high-water mark is rising
+    int64_t peakBytes = tagBytes.peakBytes.load(std::memory_order_relaxed);
+    while (liveBytes > peakBytes &&
+           !tagBytes.peakBytes.compare_exchange_weak(
+               peakBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+
+    ThreadTagCounters* counters = getThreadCounters();
+    std::atomic<uint64_t>& allocationCount = counters->allocationCount[p_Tag];
+    allocationCount.store(allocationCount.load(std::memory_order_relaxed) + 1u,
+                          std::memory_order_relaxed);
+  }
+
+  // <-
+
+  _INTR_INLINE static void onFree(Tag::Enum p_Tag, uint32_t p_Size)
+  {
+    _tagBytes[p_Tag].liveBytes.fetch_sub(p_Size, std::memory_order_relaxed);
+  }
+
+  // <-
+
+  _INTR_INLINE static Tag::Enum getCurrentTag()
+  {
+    return _currentTag != Tag::kCount ? (Tag::Enum)_currentTag : _defaultTag;
+  }
+
+  // <-
+
+  /**
+   * Updates the per frame stats. Has to be called once per frame.
+   */
+  static void onFrameEnded();
+
+  /**
+   * Logs the stats of all tags and writes a report to disk. Called when one
+   * of the memory pools is exhausted; does not allocate from the main
+   * allocator.
+   */
+  static void onOutOfMemory(uint32_t p_RequestedSize);
+
+  static TagStats getTagStats(Tag::Enum p_Tag);
+  static const char* getTagName(Tag::Enum p_Tag);
+
+  /**
+   * Writes the stats of all tags and memory pools to the given JSON file.
+   */
+  static bool writeReport(const char* p_FilePath);
+
+  // Used for allocations outside of tag scopes. Everything allocated before
+  // the application gets initialized is manager storage
+  static Tag::Enum _defaultTag;
+  static thread_local uint32_t _currentTag;
+
+private:
+  _INTR_INLINE static ThreadTagCounters* getThreadCounters()
+  {
+    ThreadTagCounters* counters = _threadCounters;
+    if (counters == nullptr)
+    {
+      counters = acquireThreadCounters();
+    }
+    return counters;
+  }
+
+  /**
+   * Releases the counters of the owning thread when the thread exits.
+   */
+  struct ThreadCountersOwner
+  {
+    ~ThreadCountersOwner();
+
+    ThreadTagCounters* counters;
+  };
+
+  /**
+   * Adopts the counters of an exited thread or creates new ones. The counts
+   * of the previous owner are kept, so the sums over all threads stay valid.
+   */
+  static ThreadTagCounters* acquireThreadCounters();
+  static void releaseThreadCounters(ThreadTagCounters* p_Counters);
+  static void calcTagStats(TagStats* p_Stats);
+
+  static thread_local ThreadTagCounters* _threadCounters;
+  static thread_local ThreadCountersOwner _threadCountersOwner;
+  // Set once the counters of the thread have been released during thread exit
+  static thread_local bool _threadCountersReleased;
+  static ThreadTagCounters*
+      _threadCounterBlocks[_INTR_MEMORY_TRACKING_MAX_THREAD_COUNT];
+  static ThreadTagCounters*
+      _freeThreadCounterBlocks[_INTR_MEMORY_TRACKING_MAX_THREAD_COUNT];
+  static uint32_t _freeThreadCounterBlockCount;
+  static std::atomic<uint32_t> _threadCounterBlockCount;
+  static std::mutex _threadCounterMutex;
+
+  static TagBytes _tagBytes[Tag::kCount];
+  static uint64_t _lastTotalAllocationCount[Tag::kCount];
+  static uint64_t _lastFrameAllocationCount[Tag::kCount];
+};
+
+// <-
+
+/**
+ * Attributes all allocations of the current thread to the given tag while in
+ * scope. Use via _INTR_MEMORY_TAG.
+ */
+struct TagScope
+{
+  _INTR_INLINE TagScope(Tag::Enum p_Tag) : _prevTag(Tracking::_currentTag)
+  {
+    Tracking::_currentTag = p_Tag;
+  }
+  _INTR_INLINE ~TagScope() { Tracking::_currentTag = _prevTag; }
+
+  TagScope(const TagScope&) = delete;
+  TagScope& operator=(const TagScope&) = delete;
+
+private:
+  uint32_t _prevTag;
+};
+}
+}
+}
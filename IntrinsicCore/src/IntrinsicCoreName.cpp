@@ -19,6 +19,60 @@ namespace Intrinsic
 {
 namespace Core
 {
-_INTR_HASH_MAP(uint32_t, _INTR_STRING) Name::_stringMap;
+namespace
+{
+// Interned strings are distributed across multiple independently locked
+// stripes so concurrent lookups and inserts rarely contend
+const uint32_t _internTableStripeCount = 64u;
+
+struct InternTableStripe
+{
+  std::mutex mutex;
+  _INTR_HASH_MAP(uint64_t, _INTR_STRING) strings;
+};
+
+_INTR_INLINE InternTableStripe& getInternTableStripe(uint64_t p_Hash)
+{
+  // Initialized on first use as names might be created during static init
+  static InternTableStripe stripes[_internTableStripeCount];
+  return stripes[(p_Hash >> 32u) % _internTableStripeCount];
+}
+}
+
+// <-
+
+void Name::intern(uint64_t p_Hash, const char* p_String)
+{
+  if (p_Hash == 0u)
+  {
+    return;
+  }
+
+  InternTableStripe& stripe = getInternTableStripe(p_Hash);
+  std::lock_guard<std::mutex> lock(stripe.mutex);
+
+  auto it = stripe.strings.find(p_Hash);
+  if (it == stripe.strings.end())
+  {
+    stripe.strings[p_Hash] = p_String;
+  }
+  else if (it->second != p_String)
+  {
+    _INTR_LOG_ERROR("Name hash collision between '%s' and '%s'...",
+                    it->second.c_str(), p_String);
+    _INTR_ASSERT(false && "Name hash collision");
+  }
+}
+
+// <-
+
+_INTR_STRING Name::lookupString(uint64_t p_Hash)
+{
+  InternTableStripe& stripe = getInternTableStripe(p_Hash);
+  std::lock_guard<std::mutex> lock(stripe.mutex);
+
+  auto it = stripe.strings.find(p_Hash);
+  return it != stripe.strings.end() ? it->second : _INTR_STRING();
+}
 }
 }
@@ -18,23 +18,33 @@ namespace Intrinsic
 {
 namespace Core
 {
+/**
+ * Hashed name. Names built from string literals via _N() are hashed at compile
+ * time and interned only once per call site; names built from strings at
+ * runtime are hashed and interned on construction. The intern table is only
+ * used for reverse lookups via getString().
+ */
 struct Name
 {
   _INTR_INLINE Name() : _hash(0u) {}
   _INTR_INLINE Name(const _INTR_STRING& p_String) { setName(p_String.c_str()); }
   _INTR_INLINE Name(const char* p_String) { setName(p_String); }
-  _INTR_INLINE Name(uint32_t p_Hash) : _hash(p_Hash) {}
+  _INTR_INLINE Name(uint64_t p_Hash) : _hash(p_Hash) {}
+  _INTR_INLINE Name(uint64_t p_Hash, const char* p_String) : _hash(p_Hash)
+  {
+    _INTR_ASSERT(p_Hash == calcHash(p_String));
+    intern(_hash, p_String);
+  }
 
   _INTR_INLINE void setName(const char* p_String)
   {
-    _hash = Math::hash(p_String, strlen(p_String));
-    if (_stringMap.find(_hash) == _stringMap.end())
-      _stringMap[_hash] = p_String;
+    _hash = calcHash(p_String);
+    intern(_hash, p_String);
   }
 
   _INTR_INLINE bool isValid() const { return _hash != 0u; }
 
-  _INTR_INLINE _INTR_STRING getString() const { return _stringMap[_hash]; }
+  _INTR_INLINE _INTR_STRING getString() const { return lookupString(_hash); }
 
   _INTR_INLINE bool operator==(const Name& p_Rhs) const
   {
@@ -46,8 +56,26 @@ struct Name
     return !(*this == p_Rhs);
   }
 
-  uint32_t _hash;
-  static _INTR_HASH_MAP(uint32_t, _INTR_STRING) _stringMap;
+  /**
+   * 64-bit FNV-1a hash of the given string. Empty strings map to the invalid
+   * hash.
+   */
+  static constexpr uint64_t calcHash(const char* p_String)
+  {
+    uint64_t hash = p_String[0] != '\0' ? 0xcbf29ce484222325ull : 0u;
+    for (const char* c = p_String; *c != '\0'; ++c)
+    {
+      hash = (hash ^ (uint8_t)*c) * 0x100000001b3ull;
+    }
+
+    return hash;
+  }
+
+  uint64_t _hash;
+
+private:
+  static void intern(uint64_t p_Hash, const char* p_String);
+  static _INTR_STRING lookupString(uint64_t p_Hash);
 };
 }
 }
@@ -49,6 +49,37 @@ struct PhysXErrorCallback : public physx::PxErrorCallback
                       message, file, line);
   }
 } _physXErrorCallback;
+
+// Tracks the memory allocated by PhysX. The size of each allocation is stored
+// in front of it, padded to keep the 16 byte alignment PhysX requires
+struct PhysXAllocatorCallback : public physx::PxAllocatorCallback
+{
+  void* allocate(size_t size, const char* typeName, const char* filename,
+                 int line) override
+  {
+    uint8_t* mem = (uint8_t*)_defaultAllocator.allocate(
+        size + _headerSizeInBytes, typeName, filename, line);
+    *(size_t*)mem = size;
+
+    Memory::Tracking::onAllocate(Memory::Tag::kPhysics, (uint32_t)size);
+    return mem + _headerSizeInBytes;
+  }
+
+  void deallocate(void* ptr) override
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    uint8_t* mem = (uint8_t*)ptr - _headerSizeInBytes;
+    Memory::Tracking::onFree(Memory::Tag::kPhysics, (uint32_t) * (size_t*)mem);
+    _defaultAllocator.deallocate(mem);
+  }
+
+  static const size_t _headerSizeInBytes = 16u;
+  physx::PxDefaultAllocator _defaultAllocator;
+} _physXAllocatorCallback;
 }
 
 // Static members
@@ -60,12 +91,12 @@ physx::PxScene* System::_pxScene;
 
 void System::init()
 {
-  static physx::PxDefaultAllocator defaultAllocator;
+  _INTR_MEMORY_TAG(kPhysics);
 
   physx::PxTolerancesScale toleranceScale;
 
-  _pxFoundation = PxCreateFoundation(PX_FOUNDATION_VERSION, defaultAllocator,
-                                     _physXErrorCallback);
+  _pxFoundation = PxCreateFoundation(
+      PX_FOUNDATION_VERSION, _physXAllocatorCallback, _physXErrorCallback);
   _INTR_ASSERT(_pxFoundation);
 
   _pxPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *_pxFoundation,
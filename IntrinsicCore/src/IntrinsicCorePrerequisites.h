@@ -43,6 +43,7 @@
 #define _INTR_MAX_PIPELINE_LAYOUT_COUNT 1024u
 #define _INTR_MAX_BUFFER_COUNT 1024u
 #define _INTR_MAX_DRAW_CALL_COUNT 10240u
+#define _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL 32u
 #define _INTR_MAX_COMPUTE_CALL_COUNT 1024u
 #define _INTR_MAX_FRAMEBUFFER_COUNT 1024u
 #define _INTR_MAX_IMAGE_COUNT 1024u
@@ -53,6 +54,9 @@
 #define _INTR_MAX_EVENT_LISTENER_COUNT 1024u
 #define _INTR_MAX_MATERIAL_PASS_COUNT 256u
 
+// Threading
+#define _INTR_CACHE_LINE_SIZE_IN_BYTES 64u
+
 // Various
 #define _INTR_CONCAT_(x, y) x##y
 #define _INTR_CONCAT(x, y) _INTR_CONCAT_(x, y)
@@ -78,8 +82,13 @@
 #define _INTR_LOG_POP()
 #endif // _INTR_LOGGING_ENABLED
 
-// Names
-#define _N(x) Name(#x)
+// Names (hashed at compile time and interned once per call site)
+#define _N(x)                                                                  \
+  ([]() -> Name {                                                              \
+    static const Name name = Name(                                             \
+        std::integral_constant<uint64_t, Name::calcHash(#x)>::value, #x);      \
+    return name;                                                               \
+  }())
 
 // Memory management
 #define _INTR_NEW(x, y)                                                        \
@@ -98,6 +107,11 @@
     y = nullptr;                                                               \
   }
 
+// Attributes all allocations of the current scope to the given memory tag
+#define _INTR_MEMORY_TAG(_tag)                                                 \
+  Intrinsic::Core::Memory::TagScope _INTR_CONCAT(memoryTag, __LINE__)(         \
+      Intrinsic::Core::Memory::Tag::_tag)
+
 // Data structures
 #define _INTR_STRING                                                           \
   std::basic_string<char, std::char_traits<char>,                              \
@@ -106,6 +120,8 @@
   std::basic_stringstream<char, std::char_traits<char>,                        \
                           Intrinsic::Core::Memory::StlAllocator<char>>
 #define _INTR_ARRAY(a) std::vector<a, Intrinsic::Core::Memory::StlAllocator<a>>
+#define _INTR_SCRATCH_ARRAY(a)                                                 \
+  std::vector<a, Intrinsic::Core::Memory::ScratchStlAllocator<a>>
 #define _INTR_STACK_ARRAY(a, b) std::array<a, b>
 #define _INTR_HASH_MAP(a, b)                                                   \
   spp::sparse_hash_map<a, b, spp::spp_hash<a>, std::equal_to<a>>
@@ -255,9 +271,21 @@
 #define _INTR_PROFILE_COUNTER_LOCAL_SUB(_var, _count)                          \
   MICROPROFILE_COUNTER_LOCAL_SUB(_var, _count)
 #else
+#if defined(_INTR_TRACE_PROFILING_ENABLED)
+#define _INTR_PROFILE_CPU(_group, _name)                                       \
+  Intrinsic::Core::TraceProfiler::Scope _INTR_CONCAT(traceScope, __LINE__)(    \
+      _group, _name)
+#define _INTR_PROFILE_CPU_CUSTOM(_var)                                         \
+  Intrinsic::Core::TraceProfiler::Scope _INTR_CONCAT(traceScope, __LINE__)(    \
+      _var##Group, _var##Name)
+#define _INTR_PROFILE_CPU_DEFINE(_var, _group, _name)                          \
+  const char* _var##Group = _group;                                            \
+  const char* _var##Name = _name
+#else
 #define _INTR_PROFILE_CPU(_group, _name)
 #define _INTR_PROFILE_CPU_CUSTOM(_var)
 #define _INTR_PROFILE_CPU_DEFINE(_var, _group, _name)
+#endif // _INTR_TRACE_PROFILING_ENABLED
 #define _INTR_PROFILE_GPU(_name)
 #define _INTR_PROFILE_GPU_CUSTOM(_var, _name)
 #define _INTR_PROFILE_GPU_DEFINE(_var, _name)
@@ -359,8 +359,8 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
       }
     }
 
-    Components::NodeManager::_position(camNodeRef) =
-        Components::NodeManager::_worldPosition(nodeRef);
+    Components::NodeManager::setPosition(
+        camNodeRef, Components::NodeManager::_worldPosition(nodeRef));
     const Components::NodeRefArray nodesToUpdate = {camNodeRef};
     Components::NodeManager::updateTransforms(nodesToUpdate);
 
@@ -370,6 +370,7 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
       World::updateDayNightCycle(0.0f);
       Components::PostEffectVolumeManager::blendPostEffects(
           Components::PostEffectVolumeManager::_activeRefs);
+      RenderProcess::Default::prepareFrame(0.0f);
       RenderProcess::Default::renderFrame(0.0f);
       ++TaskManager::_frameCounter;
     }
@@ -403,13 +404,14 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
 
         for (uint32_t atlasIdx = 0u; atlasIdx < 6; ++atlasIdx)
         {
-          Components::NodeManager::_orientation(camNodeRef) =
-              rotationsPerAtlasIdx[atlasIdx];
+          Components::NodeManager::setOrientation(
+              camNodeRef, rotationsPerAtlasIdx[atlasIdx]);
           Components::NodeManager::updateTransforms(nodesToUpdate);
 
           // Render face
           Components::PostEffectVolumeManager::blendPostEffects(
               Components::PostEffectVolumeManager::_activeRefs);
+          RenderProcess::Default::prepareFrame(0.0f);
           RenderProcess::Default::renderFrame(0.0f);
 
           // Wait for the rendering to finish
@@ -139,6 +139,154 @@ struct CullingParallelTaskSet : enki::ITaskSet
   FrustumRefArray _frustums;
 } _cullingParallelTaskSet;
 
+// <-
+
+namespace
+{
+namespace Containment
+{
+enum Enum
+{
+  kOutside,
+  kIntersecting,
+  kInside
+};
+}
+
+// Marks BVH nodes which are fully inside of the frustum on the traversal stack
+const uint32_t _insideBit = 0x80000000u;
+
+_INTR_INLINE Containment::Enum
+calcAABBContainment(const Math::FrustumPlanes& p_FrustumPlanes,
+                    const Math::AABB& p_AABB)
+{
+  const glm::vec3 center = Math::calcAABBCenter(p_AABB);
+  const glm::vec3 halfExtent = Math::calcAABBHalfExtent(p_AABB);
+
+  Containment::Enum result = Containment::kInside;
+  for (uint32_t i = 0u; i < Math::FrustumPlane::kCount; ++i)
+  {
+    const glm::vec3& n = p_FrustumPlanes.n[i];
+    const float dist = glm::dot(n, center) + p_FrustumPlanes.d[i];
+    const float radius = glm::dot(glm::abs(n), halfExtent);
+
+    if (dist < -radius)
+    {
+      return Containment::kOutside;
+    }
+    if (dist < radius)
+    {
+      result = Containment::kIntersecting;
+    }
+  }
+
+  return result;
+}
+
+// <-
+
+_INTR_INLINE bool isSphereCulled(const Math::FrustumPlanes& p_FrustumPlanes,
+                                 const Math::Sphere& p_Sphere)
+{
+  for (uint32_t i = 0u; i < Math::FrustumPlane::kCount; ++i)
+  {
+    if (glm::dot(p_FrustumPlanes.n[i], p_Sphere.p) + p_FrustumPlanes.d[i] <
+        -p_Sphere.r)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+}
+
+// <-
+
+struct BvhCullingParallelTaskSet : enki::ITaskSet
+{
+  virtual ~BvhCullingParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Culling", "BVH Culling Job");
+
+    const DynamicAABBTree& bvh =
+        Components::NodeManager::_boundingVolumeHierarchy;
+
+    for (uint32_t frustIdx = p_Range.start; frustIdx < p_Range.end; ++frustIdx)
+    {
+      Components::NodeRefArray& visibleNodes = _visibleNodes[frustIdx];
+      _INTR_ARRAY(uint32_t)& stack = _stacks[frustIdx];
+
+      visibleNodes.clear();
+      stack.clear();
+
+      if (bvh.getRoot() == DynamicAABBTree::kNullNode)
+      {
+        continue;
+      }
+
+      const Math::FrustumPlanes& frustumPlanes =
+          Resources::FrustumManager::_frustumPlanesViewSpace(
+              _frustums[frustIdx]);
+
+      stack.push_back(bvh.getRoot());
+      while (!stack.empty())
+      {
+        const uint32_t entry = stack.back();
+        stack.pop_back();
+
+        const uint32_t bvhNodeId = entry & ~_insideBit;
+        const DynamicAABBTree::Node& bvhNode = bvh.getNode(bvhNodeId);
+
+        // Sub trees fully inside of the frustum are accepted without testing
+        bool inside = (entry & _insideBit) > 0u;
+        if (!inside)
+        {
+          const Containment::Enum containment =
+              calcAABBContainment(frustumPlanes, bvhNode.aabb);
+
+          if (containment == Containment::kOutside)
+          {
+            continue;
+          }
+
+          inside = containment == Containment::kInside;
+        }
+
+        if (bvhNode.isLeaf())
+        {
+          const Components::NodeRef nodeRef = bvhNode.userData;
+
+          // Test the actual bounds for leafs intersecting the frustum
+          if (inside ||
+              !isSphereCulled(
+                  frustumPlanes,
+                  Components::NodeManager::_worldBoundingSphere(nodeRef)))
+          {
+            visibleNodes.push_back(nodeRef);
+          }
+        }
+        else
+        {
+          const uint32_t insideBit = inside ? _insideBit : 0u;
+          stack.push_back(bvhNode.child0 | insideBit);
+          stack.push_back(bvhNode.child1 | insideBit);
+        }
+      }
+    }
+  }
+
+  FrustumRefArray _frustums;
+  _INTR_ARRAY(Components::NodeRefArray) _visibleNodes;
+  _INTR_ARRAY(_INTR_ARRAY(uint32_t)) _stacks;
+} _bvhCullingParallelTaskSet;
+
+// Static members
+float FrustumManager::_lastCullingDuration = 0.0f;
+
 void FrustumManager::init()
 {
   _INTR_LOG_INFO("Inititializing Frustum Manager...");
@@ -153,12 +301,70 @@ void FrustumManager::cullNodes(const FrustumRefArray& p_ActiveFrustums)
 {
   _INTR_PROFILE_CPU("Culling", "Culling");
 
-  _cullingParallelTaskSet._frustums = p_ActiveFrustums;
-  _cullingParallelTaskSet.m_SetSize =
-      Components::NodeManager::getActiveResourceCount();
+  const uint64_t startTime = TimingHelper::getMicroseconds();
+
+  if (!Settings::Manager::_bvhCullingEnabled)
+  {
+    _INTR_PROFILE_CPU("Culling", "Brute Force Culling");
+
+    _cullingParallelTaskSet._frustums = p_ActiveFrustums;
+    _cullingParallelTaskSet.m_SetSize =
+        Components::NodeManager::getActiveResourceCount();
+
+    Application::_scheduler.AddTaskSetToPipe(&_cullingParallelTaskSet);
+    Application::_scheduler.WaitforTaskSet(&_cullingParallelTaskSet);
+
+    _lastCullingDuration =
+        (TimingHelper::getMicroseconds() - startTime) * 0.001f;
+    return;
+  }
+
+  _INTR_PROFILE_CPU("Culling", "BVH Culling");
+
+  Components::NodeManager::updateBoundingVolumeHierarchy();
+
+  const uint32_t frustumCount = (uint32_t)p_ActiveFrustums.size();
+  _INTR_ASSERT(frustumCount <= 32u && "Too many active frustums");
+
+  // Traverse the BVH for each frustum in parallel
+  {
+    _bvhCullingParallelTaskSet._frustums = p_ActiveFrustums;
+    _bvhCullingParallelTaskSet._visibleNodes.resize(frustumCount);
+    _bvhCullingParallelTaskSet._stacks.resize(frustumCount);
+    _bvhCullingParallelTaskSet.m_SetSize = frustumCount;
+
+    Application::_scheduler.AddTaskSetToPipe(&_bvhCullingParallelTaskSet);
+    Application::_scheduler.WaitforTaskSet(&_bvhCullingParallelTaskSet);
+  }
+
+  // Write the results to the visibility masks
+  {
+    const uint32_t frustumsMask =
+        frustumCount < 32u ? (1u << frustumCount) - 1u : 0xFFFFFFFFu;
+
+    for (uint32_t i = 0u; i < Components::NodeManager::getActiveResourceCount();
+         ++i)
+    {
+      Components::NodeManager::_visibilityMask(
+          Components::NodeManager::getActiveResourceAtIndex(i)) &=
+          ~frustumsMask;
+    }
+
+    for (uint32_t frustIdx = 0u; frustIdx < frustumCount; ++frustIdx)
+    {
+      const uint32_t frustumMask = 1u << frustIdx;
+      const Components::NodeRefArray& visibleNodes =
+          _bvhCullingParallelTaskSet._visibleNodes[frustIdx];
+
+      for (uint32_t i = 0u; i < visibleNodes.size(); ++i)
+      {
+        Components::NodeManager::_visibilityMask(visibleNodes[i]) |=
+            frustumMask;
+      }
+    }
+  }
 
-  Application::_scheduler.AddTaskSetToPipe(&_cullingParallelTaskSet);
-  Application::_scheduler.WaitforTaskSet(&_cullingParallelTaskSet);
+  _lastCullingDuration = (TimingHelper::getMicroseconds() - startTime) * 0.001f;
 }
 }
 }
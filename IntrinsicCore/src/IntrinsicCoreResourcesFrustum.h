@@ -130,6 +130,9 @@ struct FrustumManager
 
   static void cullNodes(const FrustumRefArray& p_ActiveFrustums);
 
+  // CPU time spent in the last call to cullNodes (in ms)
+  static float _lastCullingDuration;
+
   // <-
 
   // Description
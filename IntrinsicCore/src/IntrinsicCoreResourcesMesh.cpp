@@ -60,6 +60,208 @@ _INTR_INLINE void createOrLoadPhysicsMeshes(MeshRef p_MeshRef)
         Physics::System::_pxPhysics->createConvexMesh(fileInput);
   }
 }
+
+// <-
+
+// Binary mesh file layout (all values little endian, sections 4 byte aligned):
+// MeshFileHeader, name, MeshFileSubMeshHeader[subMeshCount] and the material
+// name and the streams of each sub mesh in MeshFileStream order
+const char* _binaryFileExtension = ".mesh.bin";
+const uint32_t _binaryFileMagic = 0x48534D49u; // "IMSH"
+const uint32_t _binaryFileVersion = 2u;
+
+namespace MeshFileStream
+{
+enum Enum
+{
+  kPositions,
+  kUV0s,
+  kNormals,
+  kTangents,
+  kBinormals,
+  kVertexColors,
+  kIndices,
+
+  kCount
+};
+}
+
+struct MeshFileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t subMeshCount;
+  uint32_t nameLength;
+  // Hash of the JSON file the binary file has been created from
+  uint64_t sourceHash;
+};
+
+struct MeshFileSubMeshHeader
+{
+  uint32_t elementCounts[MeshFileStream::kCount];
+  uint32_t materialNameLength;
+};
+
+const uint32_t _streamElementSizes[MeshFileStream::kCount] = {
+    sizeof(glm::vec3), sizeof(glm::vec2), sizeof(glm::vec3), sizeof(glm::vec3),
+    sizeof(glm::vec3), sizeof(glm::vec4), sizeof(uint32_t)};
+
+_INTR_INLINE uint64_t alignToFileSection(uint64_t p_SizeInBytes)
+{
+  return (p_SizeInBytes + 3u) & ~3ull;
+}
+
+// <-
+
+struct MeshFileReader
+{
+  MeshFileReader(const uint8_t* p_Data, uint64_t p_Size)
+      : _data(p_Data), _size(p_Size), _offset(0u)
+  {
+  }
+
+  // Returns a pointer to the next section or nullptr if the file is too small
+  _INTR_INLINE const void* consume(uint64_t p_SizeInBytes)
+  {
+    const uint64_t alignedSize = alignToFileSection(p_SizeInBytes);
+    if (alignedSize > _size - _offset)
+    {
+      return nullptr;
+    }
+
+    const void* section = _data + _offset;
+    _offset += alignedSize;
+    return section;
+  }
+
+  const uint8_t* _data;
+  uint64_t _size;
+  uint64_t _offset;
+};
+
+_INTR_INLINE void writeFileSection(FILE* p_File, const void* p_Data,
+                                   uint64_t p_SizeInBytes)
+{
+  static const uint8_t padding[4] = {};
+
+  if (p_SizeInBytes > 0u)
+  {
+    fwrite(p_Data, 1u, (size_t)p_SizeInBytes, p_File);
+  }
+  fwrite(padding, 1u,
+         (size_t)(alignToFileSection(p_SizeInBytes) - p_SizeInBytes), p_File);
+}
+
+template <class T>
+_INTR_INLINE bool readFileStream(MeshFileReader& p_Reader, uint32_t p_Count,
+                                 _INTR_ARRAY(T) & p_Stream)
+{
+  const void* data = p_Reader.consume((uint64_t)p_Count * sizeof(T));
+  if (data == nullptr)
+  {
+    return false;
+  }
+
+  p_Stream.resize(p_Count);
+  if (p_Count > 0u)
+  {
+    memcpy(p_Stream.data(), data, p_Count * sizeof(T));
+  }
+
+  return true;
+}
+
+// <-
+
+// Returns zero if the file can't be read, which never matches a binary file
+_INTR_INLINE uint64_t calcSourceFileHash(const char* p_FilePath)
+{
+  Util::MappedFile file;
+  if (!file.open(p_FilePath))
+  {
+    return 0u;
+  }
+
+  return Util::calcHash(file.getData(), file.getSize());
+}
+
+// <-
+
+_INTR_INLINE bool validateBinaryFile(const uint8_t* p_Data, uint64_t p_Size,
+                                     uint64_t p_SourceHash)
+{
+  MeshFileReader reader = MeshFileReader(p_Data, p_Size);
+
+  const MeshFileHeader* header =
+      (const MeshFileHeader*)reader.consume(sizeof(MeshFileHeader));
+  if (header == nullptr || header->magic != _binaryFileMagic ||
+      header->version != _binaryFileVersion || p_SourceHash == 0u ||
+      header->sourceHash != p_SourceHash ||
+      reader.consume(header->nameLength) == nullptr)
+  {
+    return false;
+  }
+
+  const MeshFileSubMeshHeader* subMeshHeaders =
+      (const MeshFileSubMeshHeader*)reader.consume(
+          (uint64_t)header->subMeshCount * sizeof(MeshFileSubMeshHeader));
+  if (subMeshHeaders == nullptr)
+  {
+    return false;
+  }
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < header->subMeshCount;
+       ++subMeshIdx)
+  {
+    const MeshFileSubMeshHeader& subMeshHeader = subMeshHeaders[subMeshIdx];
+
+    if (reader.consume(subMeshHeader.materialNameLength) == nullptr)
+    {
+      return false;
+    }
+
+    for (uint32_t streamIdx = 0u; streamIdx < MeshFileStream::kCount;
+         ++streamIdx)
+    {
+      if (reader.consume((uint64_t)subMeshHeader.elementCounts[streamIdx] *
+                         _streamElementSizes[streamIdx]) == nullptr)
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// <-
+
+_INTR_INLINE MeshRef loadFromJsonFile(const char* p_FilePath,
+                                      char* p_ReadBuffer)
+{
+  FILE* fp = fopen(p_FilePath, "rb");
+
+  if (fp == nullptr)
+  {
+    _INTR_LOG_WARNING("Failed to load resources from file '%s'...",
+                      p_FilePath);
+    return MeshRef();
+  }
+
+  rapidjson::Document resource;
+  {
+    rapidjson::FileReadStream is(fp, p_ReadBuffer, 65536u);
+    resource.ParseStream(is);
+  }
+
+  fclose(fp);
+
+  MeshRef ref = MeshManager::createMesh(resource["name"].GetString());
+  MeshManager::resetToDefault(ref);
+  MeshManager::initFromDescriptor(ref, false, resource["properties"]);
+
+  return ref;
+}
 }
 
 void MeshManager::init()
@@ -415,6 +617,29 @@ void MeshManager::createResources(const MeshRefArray& p_Meshes)
     Memory::Tlsf::MainAllocator::free(tempBuffersToRelease[i]);
   }
   tempBuffersToRelease.clear();
+
+  // The AABBs of the meshes changed, so update the bounds of all Nodes using
+  // them
+  _INTR_HASH_MAP(uint32_t, bool) createdMeshIds;
+  for (uint32_t meshIdx = 0u; meshIdx < p_Meshes.size(); ++meshIdx)
+  {
+    createdMeshIds[p_Meshes[meshIdx]._id] = true;
+  }
+
+  for (uint32_t i = 0u; i < CComponents::MeshManager::getActiveResourceCount();
+       ++i)
+  {
+    Components::MeshRef meshCompRef =
+        CComponents::MeshManager::getActiveResourceAtIndex(i);
+    MeshRef meshRef = _getResourceByName(
+        CComponents::MeshManager::_descMeshName(meshCompRef));
+
+    if (meshRef.isValid() &&
+        createdMeshIds.find(meshRef._id) != createdMeshIds.end())
+    {
+      CComponents::MeshManager::markNodeDirty(meshCompRef);
+    }
+  }
 }
 
 // <-
@@ -474,6 +699,324 @@ void MeshManager::destroyResources(const MeshRefArray& p_Meshes)
     BufferManager::destroyBuffer(buffersToDestroy[i]);
   }
 }
+
+// <-
+
+void MeshManager::loadFromMultipleFiles(const char* p_Path,
+                                        const char* p_Extension)
+{
+  _INTR_MEMORY_TAG(kResources);
+
+  const uint64_t startTime = TimingHelper::getMicroseconds();
+  uint32_t meshCount = 0u;
+  uint32_t binaryMeshCount = 0u;
+
+  char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+
+  tinydir_dir dir;
+  if (tinydir_open(&dir, p_Path) == -1)
+  {
+    _INTR_LOG_ERROR("Directory not found while loading resources from "
+                    "multiple files...");
+    Memory::Tlsf::MainAllocator::free(readBuffer);
+    return;
+  }
+
+  while (dir.has_next)
+  {
+    tinydir_file file;
+    if (tinydir_readfile(&dir, &file) == -1)
+    {
+      _INTR_LOG_ERROR("Failed to read file in directory...");
+      tinydir_next(&dir);
+      continue;
+    }
+
+    _INTR_STRING resourceName, extension;
+    StringUtil::extractFileNameAndExtension(file.path, resourceName,
+                                            extension);
+
+    // Ignore files not matching the extension
+    if (extension.find(p_Extension) == std::string::npos)
+    {
+      tinydir_next(&dir);
+      continue;
+    }
+
+    ++meshCount;
+
+    // Prefer the binary file if it has been created from the current contents
+    // of the JSON file
+    const _INTR_STRING binaryFilePath =
+        _INTR_STRING(p_Path) + resourceName + _binaryFileExtension;
+    const uint64_t sourceHash = calcSourceFileHash(file.path);
+
+    if (Util::fileExists(binaryFilePath.c_str()) &&
+        loadFromBinaryFile(binaryFilePath.c_str(), sourceHash).isValid())
+    {
+      ++binaryMeshCount;
+      tinydir_next(&dir);
+      continue;
+    }
+
+    // Fall back to the JSON file and convert it for the next run
+    MeshRef ref = loadFromJsonFile(file.path, readBuffer);
+    if (ref.isValid())
+    {
+      _INTR_LOG_INFO("Converting mesh '%s' to binary mesh file...",
+                     resourceName.c_str());
+      saveToBinaryFile(ref, p_Path, file.path);
+    }
+
+    tinydir_next(&dir);
+  }
+
+  tinydir_close(&dir);
+
+  Memory::Tlsf::MainAllocator::free(readBuffer);
+
+  _INTR_LOG_INFO("Loaded %u meshes (%u from binary files) in %.2f ms...",
+                 meshCount, binaryMeshCount,
+                 (TimingHelper::getMicroseconds() - startTime) * 0.001f);
+}
+
+// <-
+
+bool MeshManager::saveToBinaryFile(MeshRef p_Ref, const char* p_Path,
+                                   const char* p_SourceFilePath)
+{
+  // Don't save volatile resources
+  if (hasResourceFlags(p_Ref, Dod::Resources::ResourceFlags::kResourceVolatile))
+  {
+    return false;
+  }
+
+  const _INTR_STRING name = _name(p_Ref).getString();
+  const _INTR_STRING fileName =
+      _INTR_STRING(p_Path) + name + _binaryFileExtension;
+
+  FILE* fp = fopen(fileName.c_str(), "wb");
+
+  if (fp == nullptr)
+  {
+    _INTR_LOG_WARNING("Failed to save mesh to binary file '%s'...",
+                      fileName.c_str());
+    return false;
+  }
+
+  const PositionsPerSubMeshArray& positions = _descPositionsPerSubMesh(p_Ref);
+  const UVsPerSubMeshArray& uv0s = _descUV0sPerSubMesh(p_Ref);
+  const NormalsPerSubMeshArray& normals = _descNormalsPerSubMesh(p_Ref);
+  const TangentsPerSubMeshArray& tangents = _descTangentsPerSubMesh(p_Ref);
+  const BinormalsPerSubMeshArray& binormals = _descBinormalsPerSubMesh(p_Ref);
+  const VertexColorsPerSubMeshArray& vtxColors =
+      _descVertexColorsPerSubMesh(p_Ref);
+  const IndicesPerSubMeshArray& indices = _descIndicesPerSubMesh(p_Ref);
+  const MaterialNamesPerSubMeshArray& materialNames =
+      _descMaterialNamesPerSubMesh(p_Ref);
+
+  const uint32_t subMeshCount = (uint32_t)positions.size();
+
+  MeshFileHeader header;
+  {
+    header.magic = _binaryFileMagic;
+    header.version = _binaryFileVersion;
+    header.subMeshCount = subMeshCount;
+    header.nameLength = (uint32_t)name.size();
+    header.sourceHash = calcSourceFileHash(p_SourceFilePath);
+  }
+  writeFileSection(fp, &header, sizeof(MeshFileHeader));
+  writeFileSection(fp, name.c_str(), name.size());
+
+  _INTR_ARRAY(_INTR_STRING) materialNameStrings;
+  materialNameStrings.resize(subMeshCount);
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    materialNameStrings[subMeshIdx] = materialNames[subMeshIdx].getString();
+
+    MeshFileSubMeshHeader subMeshHeader;
+    {
+      uint32_t* counts = subMeshHeader.elementCounts;
+      counts[MeshFileStream::kPositions] =
+          (uint32_t)positions[subMeshIdx].size();
+      counts[MeshFileStream::kUV0s] = (uint32_t)uv0s[subMeshIdx].size();
+      counts[MeshFileStream::kNormals] = (uint32_t)normals[subMeshIdx].size();
+      counts[MeshFileStream::kTangents] =
+          (uint32_t)tangents[subMeshIdx].size();
+      counts[MeshFileStream::kBinormals] =
+          (uint32_t)binormals[subMeshIdx].size();
+      counts[MeshFileStream::kVertexColors] =
+          (uint32_t)vtxColors[subMeshIdx].size();
+      counts[MeshFileStream::kIndices] = (uint32_t)indices[subMeshIdx].size();
+
+      subMeshHeader.materialNameLength =
+          (uint32_t)materialNameStrings[subMeshIdx].size();
+    }
+    writeFileSection(fp, &subMeshHeader, sizeof(MeshFileSubMeshHeader));
+  }
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    writeFileSection(fp, materialNameStrings[subMeshIdx].c_str(),
+                     materialNameStrings[subMeshIdx].size());
+
+    writeFileSection(fp, positions[subMeshIdx].data(),
+                     positions[subMeshIdx].size() * sizeof(glm::vec3));
+    writeFileSection(fp, uv0s[subMeshIdx].data(),
+                     uv0s[subMeshIdx].size() * sizeof(glm::vec2));
+    writeFileSection(fp, normals[subMeshIdx].data(),
+                     normals[subMeshIdx].size() * sizeof(glm::vec3));
+    writeFileSection(fp, tangents[subMeshIdx].data(),
+                     tangents[subMeshIdx].size() * sizeof(glm::vec3));
+    writeFileSection(fp, binormals[subMeshIdx].data(),
+                     binormals[subMeshIdx].size() * sizeof(glm::vec3));
+    writeFileSection(fp, vtxColors[subMeshIdx].data(),
+                     vtxColors[subMeshIdx].size() * sizeof(glm::vec4));
+    writeFileSection(fp, indices[subMeshIdx].data(),
+                     indices[subMeshIdx].size() * sizeof(uint32_t));
+  }
+
+  fclose(fp);
+
+  return true;
+}
+
+// <-
+
+MeshRef MeshManager::loadFromBinaryFile(const char* p_FilePath,
+                                        uint64_t p_SourceHash)
+{
+  Util::MappedFile file;
+  if (!file.open(p_FilePath))
+  {
+    return MeshRef();
+  }
+
+  // Validate the whole file upfront so we never end up with half loaded meshes
+  if (!validateBinaryFile(file.getData(), file.getSize(), p_SourceHash))
+  {
+    _INTR_LOG_WARNING("Binary mesh file '%s' is invalid or outdated...",
+                      p_FilePath);
+    return MeshRef();
+  }
+
+  MeshFileReader reader = MeshFileReader(file.getData(), file.getSize());
+
+  const MeshFileHeader* header =
+      (const MeshFileHeader*)reader.consume(sizeof(MeshFileHeader));
+  const char* name = (const char*)reader.consume(header->nameLength);
+  const MeshFileSubMeshHeader* subMeshHeaders =
+      (const MeshFileSubMeshHeader*)reader.consume(
+          header->subMeshCount * sizeof(MeshFileSubMeshHeader));
+
+  MeshRef ref = createMesh(_INTR_STRING(name, header->nameLength).c_str());
+  resetToDefault(ref);
+
+  const uint32_t subMeshCount = header->subMeshCount;
+  _descPositionsPerSubMesh(ref).resize(subMeshCount);
+  _descUV0sPerSubMesh(ref).resize(subMeshCount);
+  _descNormalsPerSubMesh(ref).resize(subMeshCount);
+  _descTangentsPerSubMesh(ref).resize(subMeshCount);
+  _descBinormalsPerSubMesh(ref).resize(subMeshCount);
+  _descVertexColorsPerSubMesh(ref).resize(subMeshCount);
+  _descIndicesPerSubMesh(ref).resize(subMeshCount);
+  _descMaterialNamesPerSubMesh(ref).resize(subMeshCount);
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    const uint32_t* counts = subMeshHeaders[subMeshIdx].elementCounts;
+
+    const uint32_t materialNameLength =
+        subMeshHeaders[subMeshIdx].materialNameLength;
+    const char* materialName = (const char*)reader.consume(materialNameLength);
+    _descMaterialNamesPerSubMesh(ref)[subMeshIdx] =
+        _INTR_STRING(materialName, materialNameLength).c_str();
+
+    readFileStream(reader, counts[MeshFileStream::kPositions],
+                   _descPositionsPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kUV0s],
+                   _descUV0sPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kNormals],
+                   _descNormalsPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kTangents],
+                   _descTangentsPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kBinormals],
+                   _descBinormalsPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kVertexColors],
+                   _descVertexColorsPerSubMesh(ref)[subMeshIdx]);
+    readFileStream(reader, counts[MeshFileStream::kIndices],
+                   _descIndicesPerSubMesh(ref)[subMeshIdx]);
+  }
+
+  return ref;
+}
+
+// <-
+
+void MeshManager::convertToBinaryFiles(const char* p_Path,
+                                       const char* p_Extension)
+{
+  char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+
+  tinydir_dir dir;
+  if (tinydir_open(&dir, p_Path) == -1)
+  {
+    _INTR_LOG_ERROR("Directory not found while converting meshes...");
+    Memory::Tlsf::MainAllocator::free(readBuffer);
+    return;
+  }
+
+  while (dir.has_next)
+  {
+    tinydir_file file;
+    if (tinydir_readfile(&dir, &file) == -1)
+    {
+      _INTR_LOG_ERROR("Failed to read file in directory...");
+      tinydir_next(&dir);
+      continue;
+    }
+
+    _INTR_STRING resourceName, extension;
+    StringUtil::extractFileNameAndExtension(file.path, resourceName,
+                                            extension);
+
+    if (extension.find(p_Extension) == std::string::npos)
+    {
+      tinydir_next(&dir);
+      continue;
+    }
+
+    // Meshes which are already loaded can be written out directly
+    bool converted = false;
+    MeshRef ref = _getResourceByName(resourceName.c_str());
+    if (ref.isValid())
+    {
+      converted = saveToBinaryFile(ref, p_Path, file.path);
+    }
+    else
+    {
+      ref = loadFromJsonFile(file.path, readBuffer);
+      if (ref.isValid())
+      {
+        converted = saveToBinaryFile(ref, p_Path, file.path);
+        destroyMesh(ref);
+      }
+    }
+
+    if (converted)
+    {
+      _INTR_LOG_INFO("Converted mesh '%s' to binary mesh file...",
+                     resourceName.c_str());
+    }
+
+    tinydir_next(&dir);
+  }
+
+  tinydir_close(&dir);
+
+  Memory::Tlsf::MainAllocator::free(readBuffer);
+}
 }
 }
 }
@@ -372,6 +372,14 @@ struct MeshManager
     Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
         _saveToMultipleFiles<rapidjson::Writer<rapidjson::FileWriteStream>>(
             p_Path, p_Extension, compileDescriptor);
+
+    for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+    {
+      const _INTR_STRING sourceFilePath = _INTR_STRING(p_Path) +
+                                          _name(_activeRefs[i]).getString() +
+                                          p_Extension;
+      saveToBinaryFile(_activeRefs[i], p_Path, sourceFilePath.c_str());
+    }
   }
 
   // <-
@@ -384,17 +392,52 @@ struct MeshManager
         _saveToMultipleFilesSingleResource<
             rapidjson::Writer<rapidjson::FileWriteStream>>(
             p_Ref, p_Path, p_Extension, compileDescriptor);
+
+    const _INTR_STRING sourceFilePath =
+        _INTR_STRING(p_Path) + _name(p_Ref).getString() + p_Extension;
+    saveToBinaryFile(p_Ref, p_Path, sourceFilePath.c_str());
   }
 
   // <-
 
-  _INTR_INLINE static void loadFromMultipleFiles(const char* p_Path,
-                                                 const char* p_Extension)
-  {
-    Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
-        _loadFromMultipleFiles(p_Path, p_Extension, initFromDescriptor,
-                               resetToDefault);
-  }
+  /**
+   * Loads all meshes described by the JSON files in the given directory. If a
+   * binary mesh file (see saveToBinaryFile()) created from the current
+   * contents of a JSON file is present next to it, the binary file is mapped
+   * and used instead. JSON files without a valid binary counterpart are parsed
+   * and converted on the fly.
+   */
+  static void loadFromMultipleFiles(const char* p_Path,
+                                    const char* p_Extension);
+
+  // <-
+
+  /**
+   * Writes the given mesh to a versioned binary mesh file named
+   * "<name>.mesh.bin" in the given directory. The hash of the given JSON file
+   * is stored alongside, so the binary file gets rebuilt as soon as the JSON
+   * file changes. Volatile meshes are skipped.
+   */
+  static bool saveToBinaryFile(MeshRef p_Ref, const char* p_Path,
+                               const char* p_SourceFilePath);
+
+  // <-
+
+  /**
+   * Creates a new mesh from the given binary mesh file. Returns an invalid
+   * reference if the file is missing, corrupt, of an outdated version or if it
+   * has not been created from a JSON file with the given hash.
+   */
+  static MeshRef loadFromBinaryFile(const char* p_FilePath,
+                                    uint64_t p_SourceHash);
+
+  // <-
+
+  /**
+   * Converts all JSON mesh files in the given directory to binary mesh files.
+   */
+  static void convertToBinaryFiles(const char* p_Path,
+                                   const char* p_Extension);
 
   // <-
 
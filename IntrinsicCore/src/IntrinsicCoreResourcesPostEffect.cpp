@@ -23,6 +23,7 @@ namespace Resources
 {
 // Static members
 PostEffectRef PostEffectManager::_blendTargetRef;
+PostEffectRef PostEffectManager::_renderTargetRef;
 
 void PostEffectManager::init()
 {
@@ -69,6 +70,11 @@ void PostEffectManager::init()
   addResourceFlags(_blendTargetRef,
                    Dod::Resources::ResourceFlags::kResourceVolatile);
   resetToDefault(_blendTargetRef);
+
+  _renderTargetRef = createPostEffect(_N(RenderTarget));
+  addResourceFlags(_renderTargetRef,
+                   Dod::Resources::ResourceFlags::kResourceVolatile);
+  resetToDefault(_renderTargetRef);
 }
 }
 }
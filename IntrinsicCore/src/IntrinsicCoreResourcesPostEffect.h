@@ -318,6 +318,8 @@ struct PostEffectManager
 
   // Static members
   static PostEffectRef _blendTargetRef;
+  // Copy of the blend target snapshotted for rendering
+  static PostEffectRef _renderTargetRef;
 };
 }
 }
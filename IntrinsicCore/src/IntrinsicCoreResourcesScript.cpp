@@ -71,6 +71,7 @@ void setupLuaState(sol::state* p_State)
 
   sol::table entityTable = p_State->create_named_table("entity");
   sol::table inputSystemTable = p_State->create_named_table("inputSystem");
+  sol::table memoryTable = p_State->create_named_table("memory");
 
   {
     inputSystemTable["keyState"] = &Input::System::getKeyState;
@@ -129,6 +130,11 @@ void setupLuaState(sol::state* p_State)
     worldTable["cloneNodeFull"] = &World::cloneNodeFull;
   }
 
+  // Memory API
+  {
+    memoryTable["writeReport"] = &Memory::Tracking::writeReport;
+  }
+
   {
     // Mesh component API
     {
@@ -212,6 +218,8 @@ void ScriptManager::init()
 
 void ScriptManager::createResources(const ScriptRefArray& p_Scripts)
 {
+  _INTR_MEMORY_TAG(kScripts);
+
   for (uint32_t i = 0u; i < static_cast<uint32_t>(p_Scripts.size()); ++i)
   {
     ScriptRef scriptRef = p_Scripts[i];
@@ -311,6 +319,13 @@ void ScriptManager::callOnDestroy(ScriptRef p_ScriptRef,
     }
   }
 }
+
+uint32_t ScriptManager::calcLuaMemoryUsageInBytes()
+{
+  lua_State* luaState = _luaState.lua_state();
+  return (uint32_t)lua_gc(luaState, LUA_GCCOUNT, 0) * 1024u +
+         (uint32_t)lua_gc(luaState, LUA_GCCOUNTB, 0);
+}
 }
 }
 }
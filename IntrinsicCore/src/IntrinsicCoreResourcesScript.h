@@ -162,6 +162,11 @@ struct ScriptManager
   static void callOnCreate(ScriptRef p_ScriptRef, Dod::Ref p_ScriptCompRef);
   static void callOnDestroy(ScriptRef p_Script, Dod::Ref p_ScriptCompRef);
 
+  /**
+   * Returns the size of the heap managed by Lua.
+   */
+  static uint32_t calcLuaMemoryUsageInBytes();
+
   // Description
   _INTR_INLINE static _INTR_STRING& _descScriptFileName(ScriptRef p_Ref)
   {
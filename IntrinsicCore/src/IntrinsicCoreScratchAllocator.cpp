@@ -0,0 +1,107 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+thread_local ScratchArena* ScratchAllocator::_threadArena = nullptr;
+ScratchArena* ScratchAllocator::_threadArenas[_INTR_SCRATCH_MAX_THREAD_COUNT];
+std::atomic<uint32_t> ScratchAllocator::_threadArenaCount(0u);
+std::mutex ScratchAllocator::_threadArenaMutex;
+
+uint32_t ScratchAllocator::_lastFramePeakUsageInBytes = 0u;
+uint32_t ScratchAllocator::_lastFrameOverflowInBytes = 0u;
+uint32_t ScratchAllocator::_peakUsageInBytes = 0u;
+
+// <-
+
+ScratchArena* ScratchAllocator::createThreadArena()
+{
+  std::lock_guard<std::mutex> lock(_threadArenaMutex);
+
+  const uint32_t arenaIdx = _threadArenaCount.load(std::memory_order_relaxed);
+  _INTR_ASSERT(arenaIdx < _INTR_SCRATCH_MAX_THREAD_COUNT &&
+               "Max. scratch arena count exceeded");
+
+  const uint32_t arenaSizeInBytes =
+      _INTR_SCRATCH_SIZE_PER_THREAD_IN_MB * 1024u * 1024u;
+  ScratchArena* arena = new ScratchArena(arenaSizeInBytes);
+  Tracking::onAllocate(Tag::kScratch, arenaSizeInBytes);
+
+  // Publish the arena only after it has been fully initialized
+  _threadArenas[arenaIdx] = arena;
+  _threadArenaCount.store(arenaIdx + 1u, std::memory_order_release);
+
+  _threadArena = arena;
+  return arena;
+}
+
+// <-
+
+bool ScratchAllocator::isScratchMemory(void* p_Mem)
+{
+  const uint32_t arenaCount = _threadArenaCount.load(std::memory_order_acquire);
+
+  for (uint32_t i = 0u; i < arenaCount; ++i)
+  {
+    if (_threadArenas[i]->owns(p_Mem))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// <-
+
+void ScratchAllocator::reset()
+{
+  _INTR_PROFILE_CPU("Memory", "Reset Scratch Allocator");
+
+  const uint32_t arenaCount = _threadArenaCount.load(std::memory_order_acquire);
+
+  uint32_t peakUsageInBytes = 0u;
+  uint32_t overflowInBytes = 0u;
+  for (uint32_t i = 0u; i < arenaCount; ++i)
+  {
+    ScratchArena* arena = _threadArenas[i];
+
+    peakUsageInBytes += arena->peakUsageInBytes;
+    overflowInBytes += arena->overflowInBytes;
+
+    arena->current = arena->memBegin;
+    arena->peakUsageInBytes = 0u;
+    arena->overflowInBytes = 0u;
+  }
+
+  _lastFramePeakUsageInBytes = peakUsageInBytes;
+  _lastFrameOverflowInBytes = overflowInBytes;
+  _peakUsageInBytes = std::max(_peakUsageInBytes, peakUsageInBytes);
+
+  _INTR_PROFILE_COUNTER_SET("Scratch Memory Peak (KB)",
+                            peakUsageInBytes / 1024u);
+  _INTR_PROFILE_COUNTER_SET("Scratch Memory Overflow (KB)",
+                            overflowInBytes / 1024u);
+}
+}
+}
+}
@@ -0,0 +1,213 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Size of the scratch memory available to each thread per frame
+#define _INTR_SCRATCH_SIZE_PER_THREAD_IN_MB 4u
+#define _INTR_SCRATCH_MAX_THREAD_COUNT 64u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+/**
+ * Linear block of scratch memory owned by a single thread.
+ */
+struct ScratchArena
+{
+  _INTR_INLINE ScratchArena(uint32_t p_Size)
+      : peakUsageInBytes(0u), overflowInBytes(0u)
+  {
+    memBegin = (uint8_t*)malloc(p_Size);
+    memEnd = memBegin + p_Size;
+    current = memBegin;
+  }
+
+  // <-
+
+  _INTR_INLINE bool owns(void* p_Mem) const
+  {
+    return (uint8_t*)p_Mem >= memBegin && (uint8_t*)p_Mem < memEnd;
+  }
+
+  // <-
+
+  _INTR_INLINE uint32_t calcUsageInBytes() const
+  {
+    return (uint32_t)(current - memBegin);
+  }
+
+  uint8_t* memBegin;
+  uint8_t* memEnd;
+  uint8_t* current;
+
+  uint32_t peakUsageInBytes;
+  uint32_t overflowInBytes;
+};
+
+// <-
+
+/**
+ * Per thread linear allocator for temporary data which does not outlive the
+ * current frame. Freeing memory only rolls back the most recent allocation of
+ * the calling thread; all threads are reset at once when the frame ends.
+ * Allocations exceeding the scratch memory fall back to the main allocator.
+ */
+struct ScratchAllocator
+{
+  _INTR_INLINE static void* allocate(uint32_t p_Size,
+                                     uint32_t p_Alignment = 16u)
+  {
+    ScratchArena* arena = _threadArena;
+    if (arena == nullptr)
+    {
+      arena = createThreadArena();
+    }
+
+    const uintptr_t alignedMem =
+        ((uintptr_t)arena->current + p_Alignment - 1u) &
+        ~(uintptr_t)(p_Alignment - 1u);
+    if (alignedMem + p_Size > (uintptr_t)arena->memEnd)
+    {
+      arena->overflowInBytes += p_Size;
+
+      _INTR_MEMORY_TAG(kScratch);
+      return Tlsf::MainAllocator::allocate(p_Size);
+    }
+
+    arena->current = (uint8_t*)(alignedMem + p_Size);
+    arena->peakUsageInBytes =
+        std::max(arena->peakUsageInBytes, arena->calcUsageInBytes());
+
+    return (void*)alignedMem;
+  }
+
+  // <-
+
+  _INTR_INLINE static void free(void* p_Mem, uint32_t p_Size)
+  {
+    ScratchArena* arena = _threadArena;
+    if (arena != nullptr && arena->owns(p_Mem))
+    {
+      if ((uint8_t*)p_Mem + p_Size == arena->current)
+      {
+        arena->current = (uint8_t*)p_Mem;
+      }
+      return;
+    }
+
+    // Memory of other threads is released when the frame ends
+    if (!isScratchMemory(p_Mem))
+    {
+      Tlsf::MainAllocator::free(p_Mem);
+    }
+  }
+
+  // <-
+
+  /**
+   * Resets the scratch memory of all threads and updates the usage stats. Has
+   * to be called while no other thread is using scratch memory.
+   */
+  static void reset();
+
+  // Sum of the peak scratch memory usage of all threads in the last frame
+  static uint32_t _lastFramePeakUsageInBytes;
+  // Memory which did not fit and went to the main allocator in the last frame
+  static uint32_t _lastFrameOverflowInBytes;
+  // Highest per frame peak usage since startup
+  static uint32_t _peakUsageInBytes;
+
+private:
+  static ScratchArena* createThreadArena();
+  static bool isScratchMemory(void* p_Mem);
+
+  static thread_local ScratchArena* _threadArena;
+  static ScratchArena* _threadArenas[_INTR_SCRATCH_MAX_THREAD_COUNT];
+  static std::atomic<uint32_t> _threadArenaCount;
+  static std::mutex _threadArenaMutex;
+};
+
+// <-
+
+/**
+ * STL allocator adaptor for the scratch allocator. Containers using it must
+ * be destroyed before the end of the frame.
+ */
+template <class T> class ScratchStlAllocator
+{
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <class U> struct rebind
+  {
+    typedef ScratchStlAllocator<U> other;
+  };
+
+  pointer address(reference value) const { return &value; }
+  const_pointer address(const_reference value) const { return &value; }
+
+  ScratchStlAllocator() throw() {}
+  ScratchStlAllocator(const ScratchStlAllocator&) throw() {}
+  template <class U> ScratchStlAllocator(const ScratchStlAllocator<U>&) throw()
+  {
+  }
+  ~ScratchStlAllocator() throw() {}
+
+  size_type max_size() const throw()
+  {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  pointer allocate(size_type num, const void* = 0)
+  {
+    return (T*)ScratchAllocator::allocate((uint32_t)(num * sizeof(T)),
+                                          (uint32_t)alignof(T));
+  }
+
+  void construct(pointer p, const T& value) { new ((void*)p) T(value); }
+
+  void destroy(pointer p) { p->~T(); }
+
+  void deallocate(pointer p, size_type num)
+  {
+    ScratchAllocator::free(p, (uint32_t)(num * sizeof(T)));
+  }
+};
+
+template <class T1, class T2>
+bool operator==(const ScratchStlAllocator<T1>&,
+                const ScratchStlAllocator<T2>&) throw()
+{
+  return true;
+}
+template <class T1, class T2>
+bool operator!=(const ScratchStlAllocator<T1>&,
+                const ScratchStlAllocator<T2>&) throw()
+{
+  return false;
+}
+}
+}
+}
@@ -41,6 +41,17 @@ float Manager::_controllerDeadZone = 0.25f;
 bool Manager::_invertHorizontalCameraAxis = false;
 bool Manager::_invertVerticalCameraAxis = false;
 
+bool Manager::_bvhCullingEnabled = true;
+bool Manager::_gpuInstancingEnabled = true;
+bool Manager::_pipelinedRenderingEnabled = false;
+
+uint32_t Manager::_traceCaptureStartFrame = 0u;
+uint32_t Manager::_traceCaptureFrameCount = 0u;
+
+_INTR_STRING Manager::_benchmarkBaseline = "";
+float Manager::_benchmarkThreshold = 0.05f;
+bool Manager::_benchmarkCompareCulling = false;
+
 namespace
 {
 template <typename T>
@@ -116,6 +127,15 @@ void Manager::loadSettings()
     readSetting(doc, _N(invertHorizontalCameraAxis),
                 _invertHorizontalCameraAxis);
     readSetting(doc, _N(invertVerticalCameraAxis), _invertVerticalCameraAxis);
+    readSetting(doc, _N(bvhCullingEnabled), _bvhCullingEnabled);
+    readSetting(doc, _N(gpuInstancingEnabled), _gpuInstancingEnabled);
+    readSetting(doc, _N(pipelinedRenderingEnabled),
+                _pipelinedRenderingEnabled);
+    readSetting(doc, _N(traceCaptureStartFrame), _traceCaptureStartFrame);
+    readSetting(doc, _N(traceCaptureFrameCount), _traceCaptureFrameCount);
+    readSetting(doc, _N(benchmarkBaseline), _benchmarkBaseline);
+    readSetting(doc, _N(benchmarkThreshold), _benchmarkThreshold);
+    readSetting(doc, _N(benchmarkCompareCulling), _benchmarkCompareCulling);
   }
 
   _INTR_LOG_POP();
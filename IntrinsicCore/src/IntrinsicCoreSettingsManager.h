@@ -72,6 +72,17 @@ struct Manager
   static bool _invertVerticalCameraAxis;
   static _INTR_STRING _rendererConfig;
   static _INTR_STRING _materialPassConfig;
+
+  static bool _bvhCullingEnabled;
+  static bool _gpuInstancingEnabled;
+  static bool _pipelinedRenderingEnabled;
+
+  static uint32_t _traceCaptureStartFrame;
+  static uint32_t _traceCaptureFrameCount;
+
+  static _INTR_STRING _benchmarkBaseline;
+  static float _benchmarkThreshold;
+  static bool _benchmarkCompareCulling;
 };
 }
 }
@@ -35,6 +35,8 @@ struct PhysicsUpdateTaskSet : enki::ITaskSet
   void ExecuteRange(enki::TaskSetPartition p_Range,
                     uint32_t p_ThreadNum) override
   {
+    _INTR_MEMORY_TAG(kPhysics);
+
     const float modDeltaT =
         TaskManager::_lastDeltaT * TaskManager::_timeModulator;
     _stepAccum += modDeltaT;
@@ -49,6 +51,291 @@ struct PhysicsUpdateTaskSet : enki::ITaskSet
   };
 
 } _physicsUpdateTaskSet;
+
+// <-
+
+struct RenderFrameTaskSet : enki::ITaskSet
+{
+  virtual ~RenderFrameTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    R::RenderProcess::Default::renderFrame(_deltaT);
+  };
+
+  float _deltaT;
+} _renderFrameTaskSet;
+
+bool _renderFrameInFlight = false;
+
+// <-
+
+// Data accessed by the frame stages. Stages with conflicting accesses are
+// executed in the order of their declaration, all others run concurrently
+namespace FrameData
+{
+enum Flags
+{
+  kInput = 0x01u,
+  kNodes = 0x02u,
+  kPhysicsScene = 0x04u,
+  kSwarms = 0x08u,
+  kDayNightCycle = 0x10u,
+  kPostEffects = 0x20u,
+  kDebugGeometry = 0x40u,
+  kMeshes = 0x80u,
+  kLights = 0x100u,
+  kCameras = 0x200u,
+  kCharacterControllers = 0x400u,
+  kRigidBodies = 0x800u,
+  kGameState = 0x1000u,
+
+  // Used for stages which can touch arbitrary data (e.g. Lua scripts)
+  kAll = 0xFFFFFFFFu
+};
+}
+
+typedef void (*FrameStageFunction)(float p_DeltaT);
+
+struct FrameStageDesc
+{
+  FrameStageFunction function;
+  uint32_t reads;
+  uint32_t writes;
+  bool mainThreadOnly;
+};
+
+// <-
+
+void pumpEvents(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Pump Events");
+
+  Input::System::reset();
+  SystemEventProvider::SDL::pumpEvents();
+}
+
+void updateGameStates(float p_DeltaT)
+{
+  GameStates::Manager::update(p_DeltaT);
+}
+
+void tickScripts(float p_DeltaT)
+{
+  _INTR_MEMORY_TAG(kScripts);
+
+  Components::ScriptManager::tickScripts(
+      Components::ScriptManager::_activeRefs, p_DeltaT);
+}
+
+void updateFromPhysicsResults(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Update From Physics Results");
+  _INTR_MEMORY_TAG(kPhysics);
+
+  Components::RigidBodyManager::updateNodesFromActors(
+      Components::RigidBodyManager::_activeRefs);
+  Components::RigidBodyManager::updateActorsFromNodes(
+      Components::RigidBodyManager::_activeRefs);
+  Physics::System::renderLineDebugGeometry();
+}
+
+void simulateSwarms(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Swarms");
+
+  Components::SwarmManager::simulateSwarms(
+      Components::SwarmManager::_activeRefs, p_DeltaT);
+}
+
+void updateDayNightCycle(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Day Night Cycle");
+
+  World::updateDayNightCycle(p_DeltaT);
+}
+
+void blendPostEffects(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Blend Post Effects");
+
+  Components::PostEffectVolumeManager::blendPostEffects(
+      Components::PostEffectVolumeManager::_activeRefs);
+}
+
+void fireEvents(float p_DeltaT) { Resources::EventManager::fireEvents(); }
+
+// <-
+
+// All stages up to rendering are part of the frame graph
+const uint32_t _frameGraphStageCount = FrameStage::kRendering;
+
+const FrameStageDesc _frameStageDescs[_frameGraphStageCount] = {
+    // kPumpEvents
+    {pumpEvents, 0u, FrameData::kInput, true},
+    // kGameStates
+    {updateGameStates, FrameData::kAll, FrameData::kAll, true},
+    // kScripts
+    {tickScripts, FrameData::kAll, FrameData::kAll, true},
+    // kPhysics
+    {updateFromPhysicsResults,
+     FrameData::kNodes | FrameData::kPhysicsScene | FrameData::kRigidBodies |
+         FrameData::kGameState,
+     FrameData::kNodes | FrameData::kPhysicsScene | FrameData::kDebugGeometry,
+     false},
+    // kSwarms (tints the boid meshes and lights)
+    {simulateSwarms,
+     FrameData::kNodes | FrameData::kPhysicsScene |
+         FrameData::kCharacterControllers,
+     FrameData::kNodes | FrameData::kSwarms | FrameData::kMeshes |
+         FrameData::kLights,
+     false},
+    // kDayNightCycle
+    {updateDayNightCycle, 0u, FrameData::kDayNightCycle, false},
+    // kPostEffects
+    {blendPostEffects, FrameData::kNodes | FrameData::kCameras,
+     FrameData::kPostEffects, false},
+    // kEvents
+    {fireEvents, FrameData::kAll, FrameData::kAll, true}};
+
+// Bit j of entry i is set if stage i has to wait for stage j
+uint32_t _frameStageDependencies[_frameGraphStageCount];
+bool _frameGraphInitialized = false;
+
+std::atomic<bool> _frameStageCompleted[_frameGraphStageCount];
+float _frameDeltaT = 0.0f;
+
+// <-
+
+void initFrameGraph()
+{
+  for (uint32_t i = 0u; i < _frameGraphStageCount; ++i)
+  {
+    const FrameStageDesc& stage = _frameStageDescs[i];
+    _frameStageDependencies[i] = 0u;
+
+    for (uint32_t j = 0u; j < i; ++j)
+    {
+      const FrameStageDesc& prevStage = _frameStageDescs[j];
+
+      // Write after write, read after write and write after read
+      if ((prevStage.writes & (stage.reads | stage.writes)) != 0u ||
+          (prevStage.reads & stage.writes) != 0u)
+      {
+        _frameStageDependencies[i] |= 1u << j;
+      }
+    }
+  }
+
+  _frameGraphInitialized = true;
+}
+
+// <-
+
+void executeFrameStage(uint32_t p_StageIdx)
+{
+  const uint64_t startTime = TimingHelper::getMicroseconds();
+  _frameStageDescs[p_StageIdx].function(_frameDeltaT);
+  TaskManager::_lastStageDurations[p_StageIdx] =
+      (TimingHelper::getMicroseconds() - startTime) * 0.001f;
+
+  _frameStageCompleted[p_StageIdx].store(true, std::memory_order_release);
+}
+
+// <-
+
+struct FrameStageTaskSet : enki::ITaskSet
+{
+  virtual ~FrameStageTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    executeFrameStage(stageIdx);
+  };
+
+  uint32_t stageIdx;
+} _frameStageTaskSets[_frameGraphStageCount];
+
+// <-
+
+void executeFrameGraph(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("TaskManager", "Non-Rendering Tasks");
+
+  if (!_frameGraphInitialized)
+  {
+    initFrameGraph();
+  }
+
+  _frameDeltaT = p_DeltaT;
+  for (uint32_t i = 0u; i < _frameGraphStageCount; ++i)
+  {
+    _frameStageCompleted[i].store(false, std::memory_order_relaxed);
+    _frameStageTaskSets[i].stageIdx = i;
+  }
+
+  const uint32_t allStagesMask = (1u << _frameGraphStageCount) - 1u;
+  uint32_t dispatchedMask = 0u;
+
+  while (true)
+  {
+    uint32_t completedMask = 0u;
+    for (uint32_t i = 0u; i < _frameGraphStageCount; ++i)
+    {
+      if (_frameStageCompleted[i].load(std::memory_order_acquire))
+      {
+        completedMask |= 1u << i;
+      }
+    }
+
+    if (completedMask == allStagesMask)
+    {
+      break;
+    }
+
+    // Dispatch all stages whose dependencies are resolved
+    bool dispatchedStage = false;
+    for (uint32_t i = 0u; i < _frameGraphStageCount; ++i)
+    {
+      const uint32_t stageBit = 1u << i;
+      if ((dispatchedMask & stageBit) != 0u ||
+          (_frameStageDependencies[i] & ~completedMask) != 0u)
+      {
+        continue;
+      }
+
+      dispatchedMask |= stageBit;
+      dispatchedStage = true;
+
+      if (_frameStageDescs[i].mainThreadOnly)
+      {
+        executeFrameStage(i);
+        completedMask |= stageBit;
+      }
+      else
+      {
+        Application::_scheduler.AddTaskSetToPipe(&_frameStageTaskSets[i]);
+      }
+    }
+
+    // Nothing to dispatch: help executing the oldest stage still in flight
+    if (!dispatchedStage)
+    {
+      for (uint32_t i = 0u; i < _frameGraphStageCount; ++i)
+      {
+        const uint32_t stageBit = 1u << i;
+        if ((dispatchedMask & stageBit) != 0u &&
+            (completedMask & stageBit) == 0u)
+        {
+          Application::_scheduler.WaitforTaskSet(&_frameStageTaskSets[i]);
+          break;
+        }
+      }
+    }
+  }
+}
 }
 
 // Static members
@@ -58,6 +345,21 @@ float TaskManager::_totalTimePassed = 0.0f;
 uint32_t TaskManager::_frameCounter = 0u;
 uint64_t TaskManager::_lastUpdate = 0u;
 float TaskManager::_timeModulator = 1.0f;
+float TaskManager::_lastStageDurations[FrameStage::kCount] = {};
+float TaskManager::_lastCpuFrameDuration = 0.0f;
+
+void TaskManager::waitForRendering()
+{
+  if (_renderFrameInFlight)
+  {
+    _INTR_PROFILE_CPU("TaskManager", "Wait For Rendering");
+
+    Application::_scheduler.WaitforTaskSet(&_renderFrameTaskSet);
+    _renderFrameInFlight = false;
+  }
+}
+
+// <-
 
 void TaskManager::executeTasks()
 {
@@ -65,6 +367,10 @@ void TaskManager::executeTasks()
   MICROPROFILE_SCOPE(MAIN);
 #endif // _INTR_PROFILING_ENABLED
 
+#if defined(_INTR_TRACE_PROFILING_ENABLED)
+  TraceProfiler::onFrameStarted(_frameCounter);
+#endif // _INTR_TRACE_PROFILING_ENABLED
+
   _INTR_PROFILE_CPU("TaskManager", "Execute Tasks");
 
   if (_frameCounter > 0u)
@@ -90,75 +396,53 @@ void TaskManager::executeTasks()
   _totalTimePassed += modDeltaT;
   _lastUpdate = TimingHelper::getMicroseconds();
 
-  {
-    _INTR_PROFILE_CPU("TaskManager", "Non-Rendering Tasks");
-
-    // Events and input
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Pump Events");
-
-      Input::System::reset();
-      SystemEventProvider::SDL::pumpEvents();
-    }
+  // Simulation
+  executeFrameGraph(modDeltaT);
 
-    // Game state update
-    {
-      GameStates::Manager::update(modDeltaT);
-    }
+  const uint64_t renderingStart = TimingHelper::getMicroseconds();
 
-    // Scripts
-    {
-      Components::ScriptManager::tickScripts(
-          Components::ScriptManager::_activeRefs, modDeltaT);
-    }
+  {
+    _INTR_PROFILE_CPU("TaskManager", "Rendering Tasks");
 
-    // Physics
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Update From Physics Results");
+    // Sync point: The previous frame has to be recorded before its render
+    // packet can be replaced
+    waitForRendering();
 
-      Components::RigidBodyManager::updateNodesFromActors(
-          Components::RigidBodyManager::_activeRefs);
-      Components::RigidBodyManager::updateActorsFromNodes(
-          Components::RigidBodyManager::_activeRefs);
-      Physics::System::renderLineDebugGeometry();
-    }
+    // No other thread is working on the frame at this point, so all
+    // temporaries of the previous frame can be released and the memory
+    // stats are consistent
+    Memory::ScratchAllocator::reset();
+    Memory::Tracking::onFrameEnded();
 
-    // Swarms
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Swarms");
+    R::RenderProcess::Default::prepareFrame(modDeltaT);
 
-      Components::SwarmManager::simulateSwarms(
-          Components::SwarmManager::_activeRefs, modDeltaT);
-    }
+    // Process physics during rendering
+    Application::_scheduler.AddTaskSetToPipe(&_physicsUpdateTaskSet);
 
-    // Update the day/night cycle
+    // Rendering - the editor changes resources and debug geometry at any time
+    // so it always renders in sync with the simulation
+    if (Settings::Manager::_pipelinedRenderingEnabled &&
+        GameStates::Manager::getActiveGameState() !=
+            GameStates::GameState::kEditing)
     {
-      World::updateDayNightCycle(modDeltaT);
+      _renderFrameTaskSet._deltaT = modDeltaT;
+      Application::_scheduler.AddTaskSetToPipe(&_renderFrameTaskSet);
+      _renderFrameInFlight = true;
     }
-
-    // Post effect system
+    else
     {
-      Components::PostEffectVolumeManager::blendPostEffects(
-          Components::PostEffectVolumeManager::_activeRefs);
+      R::RenderProcess::Default::renderFrame(modDeltaT);
     }
 
-    // Fire events
-    {
-      Resources::EventManager::fireEvents();
-    }
+    Application::_scheduler.WaitforTaskSet(&_physicsUpdateTaskSet);
   }
 
-  {
-    _INTR_PROFILE_CPU("TaskManager", "Rendering Tasks");
-
-    // Process physics during rendering
-    Application::_scheduler.AddTaskSetToPipe(&_physicsUpdateTaskSet);
-
-    // Rendering
-    R::RenderProcess::Default::renderFrame(modDeltaT);
+  Components::NodeManager::onFrameEnded();
 
-    Application::_scheduler.WaitforTaskSet(&_physicsUpdateTaskSet);
-  }
+  const uint64_t frameEnd = TimingHelper::getMicroseconds();
+  _lastStageDurations[FrameStage::kRendering] =
+      (frameEnd - renderingStart) * 0.001f;
+  _lastCpuFrameDuration = (frameEnd - _lastUpdate) * 0.001f;
 
   ++_frameCounter;
 }
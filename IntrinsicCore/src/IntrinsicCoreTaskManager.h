@@ -18,10 +18,36 @@ namespace Intrinsic
 {
 namespace Core
 {
+namespace FrameStage
+{
+enum Enum
+{
+  kPumpEvents,
+  kGameStates,
+  kScripts,
+  kPhysics,
+  kSwarms,
+  kDayNightCycle,
+  kPostEffects,
+  kEvents,
+  kRendering,
+
+  kCount
+};
+}
+
 struct TaskManager
 {
   static void executeTasks();
 
+  /**
+   * Waits for the frame which is rendered concurrently to the simulation (if
+   * pipelined rendering is enabled). Has to be called before changing state
+   * the renderer reads outside of the render packet, e.g. when unloading the
+   * world.
+   */
+  static void waitForRendering();
+
   static float _lastDeltaT;
   static float _totalTimePassed;
   static uint32_t _frameCounter;
@@ -29,6 +55,12 @@ struct TaskManager
 
   static float _lastActualFrameDuration;
   static float _timeModulator;
+
+  // CPU time spent in each stage of the last frame (in ms). With pipelined
+  // rendering the rendering stage only covers the work on the main thread
+  static float _lastStageDurations[FrameStage::kCount];
+  // CPU time spent in the last frame excluding the frame limiter (in ms)
+  static float _lastCpuFrameDuration;
 };
 }
 }
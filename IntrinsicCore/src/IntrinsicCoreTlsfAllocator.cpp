@@ -15,6 +15,11 @@
 // Precompiled header file
 #include "stdafx.h"
 
+// Not defined by older kernel headers
+#if defined(__linux__) && !defined(MADV_POPULATE_WRITE)
+#define MADV_POPULATE_WRITE 23
+#endif // MADV_POPULATE_WRITE
+
 namespace Intrinsic
 {
 namespace Core
@@ -23,8 +28,368 @@ namespace Memory
 {
 namespace Tlsf
 {
-Allocator* MainAllocator::_allocator = nullptr;
-std::once_flag MainAllocator::_onceFlag;
+namespace
+{
+// Pools are sized and aligned to multiples of the huge page size
+const uint64_t _hugePageSizeInBytes = 2u * 1024u * 1024u;
+
+_INTR_INLINE uint64_t alignUp(uint64_t p_Value, uint64_t p_Alignment)
+{
+  return (p_Value + p_Alignment - 1u) & ~(p_Alignment - 1u);
+}
+
+// <-
+
+uint8_t* reserveAddressSpace(uint64_t p_Size, bool p_ExplicitHugePages)
+{
+#if defined(_WIN32)
+  (void)p_ExplicitHugePages;
+  return (uint8_t*)VirtualAlloc(nullptr, p_Size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+#if defined(MAP_HUGETLB)
+  if (p_ExplicitHugePages)
+  {
+    void* mem = mmap(nullptr, p_Size, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_HUGETLB,
+                     -1, 0);
+    return mem != MAP_FAILED ? (uint8_t*)mem : nullptr;
+  }
+#endif // MAP_HUGETLB
+
+  // Reserve some additional space so the heap can be aligned to the huge page
+  // size
+  void* mem = mmap(nullptr, p_Size + _hugePageSizeInBytes, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mem == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  return (uint8_t*)alignUp((uint64_t)mem, _hugePageSizeInBytes);
+#endif // _WIN32
+}
+
+// <-
+
+bool commitMemory(uint8_t* p_Mem, uint64_t p_Size, bool p_ExplicitHugePages)
+{
+#if defined(_WIN32)
+  (void)p_ExplicitHugePages;
+  return VirtualAlloc(p_Mem, p_Size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+  if (mprotect(p_Mem, p_Size, PROT_READ | PROT_WRITE) != 0)
+  {
+    return false;
+  }
+
+#if defined(__linux__)
+  if (p_ExplicitHugePages)
+  {
+    // The huge pages are not reserved by the mapping. Populating them right
+    // away reports a lack of huge pages here instead of raising SIGBUS on the
+    // first access
+    if (madvise(p_Mem, p_Size, MADV_POPULATE_WRITE) != 0)
+    {
+      madvise(p_Mem, p_Size, MADV_DONTNEED);
+      mprotect(p_Mem, p_Size, PROT_NONE);
+      return false;
+    }
+    return true;
+  }
+#endif // __linux__
+
+#if _INTR_TLSF_HUGE_PAGE_MODE >= 1 && defined(MADV_HUGEPAGE)
+  // Only a hint, failing is fine
+  madvise(p_Mem, p_Size, MADV_HUGEPAGE);
+#endif // _INTR_TLSF_HUGE_PAGE_MODE
+
+  return true;
+#endif // _WIN32
+}
+
+// <-
+
+void releaseAddressSpace(uint8_t* p_Mem, uint64_t p_Size)
+{
+#if defined(_WIN32)
+  (void)p_Size;
+  VirtualFree(p_Mem, 0u, MEM_RELEASE);
+#else
+  munmap(p_Mem, p_Size);
+#endif // _WIN32
+}
+
+// <-
+
+struct PoolWalkStats
+{
+  uint64_t freeSizeInBytes;
+  uint64_t largestFreeBlockSizeInBytes;
+};
+
+void walkPoolBlock(void* p_Mem, size_t p_Size, int p_Used, void* p_User)
+{
+  (void)p_Mem;
+
+  if (p_Used)
+  {
+    return;
+  }
+
+  PoolWalkStats* stats = (PoolWalkStats*)p_User;
+  stats->freeSizeInBytes += p_Size;
+  stats->largestFreeBlockSizeInBytes =
+      std::max(stats->largestFreeBlockSizeInBytes, (uint64_t)p_Size);
+}
+}
+
+// <-
+
+thread_local ThreadHeap* MainAllocator::_threadHeap = nullptr;
+thread_local MainAllocator::ThreadHeapOwner MainAllocator::_threadHeapOwner;
+thread_local bool MainAllocator::_threadHeapReleased = false;
+ThreadHeap* MainAllocator::_threadHeaps[_INTR_TLSF_MAX_THREAD_HEAP_COUNT];
+ThreadHeap* MainAllocator::_freeThreadHeaps[_INTR_TLSF_MAX_THREAD_HEAP_COUNT];
+uint32_t MainAllocator::_freeThreadHeapCount = 0u;
+std::atomic<uint32_t> MainAllocator::_threadHeapCount(0u);
+std::mutex MainAllocator::_threadHeapMutex;
+HeapStats MainAllocator::_heapStats = {};
+
+// <-
+
+ThreadHeap::ThreadHeap(uint64_t p_ReservedSize)
+    : memBegin(nullptr), poolCount(0u), explicitHugePages(false),
+      remoteFreeHead(nullptr), stats(), statsRequested(false)
+{
+  const uint64_t poolSize = _INTR_TLSF_POOL_SIZE_IN_MB * 1024ull * 1024ull;
+
+#if _INTR_TLSF_HUGE_PAGE_MODE == 2
+  memBegin = reserveAddressSpace(p_ReservedSize, true);
+  if (memBegin != nullptr)
+  {
+    explicitHugePages = commitMemory(memBegin, poolSize, true);
+    if (!explicitHugePages)
+    {
+      // Not enough huge pages available, fall back to regular pages
+      releaseAddressSpace(memBegin, p_ReservedSize);
+      memBegin = nullptr;
+    }
+  }
+#endif // _INTR_TLSF_HUGE_PAGE_MODE
+
+  if (memBegin == nullptr)
+  {
+    memBegin = reserveAddressSpace(p_ReservedSize, false);
+    _INTR_ASSERT(memBegin && "Failed to reserve the address space of the heap");
+
+    if (!commitMemory(memBegin, poolSize, false))
+    {
+      _INTR_ASSERT(false && "Failed to commit the first pool of the heap");
+    }
+  }
+
+  memEnd = memBegin + p_ReservedSize;
+  memCommitEnd = memBegin + poolSize;
+
+  // The first pool also holds the TLSF control structure
+  allocator.init(memBegin, (uint32_t)poolSize);
+  pools[poolCount++] = tlsf_get_pool(allocator._memoryPool);
+
+  sampleStats();
+}
+
+// <-
+
+bool ThreadHeap::grow(uint32_t p_MinSize)
+{
+  if (poolCount >= _INTR_TLSF_MAX_POOL_COUNT)
+  {
+    return false;
+  }
+
+  // Large allocations get a pool of their own
+  const uint64_t minPoolSize =
+      (uint64_t)p_MinSize + tlsf_pool_overhead() + tlsf_alloc_overhead();
+  const uint64_t poolSize =
+      std::max((uint64_t)_INTR_TLSF_POOL_SIZE_IN_MB * 1024u * 1024u,
+               alignUp(minPoolSize, _hugePageSizeInBytes));
+
+  if (poolSize > (uint64_t)(memEnd - memCommitEnd) ||
+      !commitMemory(memCommitEnd, poolSize, explicitHugePages))
+  {
+    return false;
+  }
+
+  pools[poolCount++] = allocator.addPool(memCommitEnd, (uint32_t)poolSize);
+  memCommitEnd += poolSize;
+
+  return true;
+}
+
+// <-
+
+void ThreadHeap::sampleStats()
+{
+  // Pending remote frees would show up as used memory
+  drainRemoteFrees();
+
+  PoolWalkStats walkStats = {};
+  for (uint32_t poolIdx = 0u; poolIdx < poolCount; ++poolIdx)
+  {
+    tlsf_walk_pool(pools[poolIdx], walkPoolBlock, &walkStats);
+  }
+
+  std::lock_guard<std::mutex> lock(statsMutex);
+  stats.poolCount = poolCount;
+  stats.committedSizeInBytes = memCommitEnd - memBegin;
+  stats.freeSizeInBytes = walkStats.freeSizeInBytes;
+  stats.largestFreeBlockSizeInBytes = walkStats.largestFreeBlockSizeInBytes;
+}
+
+// <-
+
+MainAllocator::ThreadHeapOwner::~ThreadHeapOwner()
+{
+  if (heap != nullptr)
+  {
+    releaseThreadHeap(heap);
+    heap = nullptr;
+  }
+}
+
+// <-
+
+ThreadHeap* MainAllocator::acquireThreadHeap()
+{
+  ThreadHeap* heap = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_threadHeapMutex);
+
+    if (_freeThreadHeapCount > 0u)
+    {
+      heap = _freeThreadHeaps[--_freeThreadHeapCount];
+    }
+    else
+    {
+      heap = createThreadHeap();
+    }
+  }
+
+  // The new owner takes over the remote frees of the previous one
+  heap->drainRemoteFrees();
+
+  _threadHeap = heap;
+
+  // Threads allocating while their thread locals get destroyed keep the heap
+  // they got until the process exits
+  if (!_threadHeapReleased)
+  {
+    _threadHeapOwner.heap = heap;
+  }
+
+  return heap;
+}
+
+// <-
+
+void MainAllocator::releaseThreadHeap(ThreadHeap* p_Heap)
+{
+  _INTR_ASSERT(p_Heap == _threadHeap);
+
+  // Still the owner, so the stats can be sampled one last time
+  p_Heap->sampleStats();
+
+  _threadHeap = nullptr;
+  _threadHeapReleased = true;
+
+  std::lock_guard<std::mutex> lock(_threadHeapMutex);
+  _freeThreadHeaps[_freeThreadHeapCount++] = p_Heap;
+}
+
+// <-
+
+ThreadHeap* MainAllocator::createThreadHeap()
+{
+  const uint32_t heapIdx = _threadHeapCount.load(std::memory_order_relaxed);
+  _INTR_ASSERT(heapIdx < _INTR_TLSF_MAX_THREAD_HEAP_COUNT &&
+               "Max. thread heap count exceeded");
+
+  const uint64_t reservedSizeInMb =
+      heapIdx == 0u ? _INTR_TLSF_RESERVED_SIZE_IN_MB
+                    : _INTR_TLSF_THREAD_HEAP_RESERVED_SIZE_IN_MB;
+  ThreadHeap* heap = new ThreadHeap(reservedSizeInMb * 1024u * 1024u);
+
+  // Publish the heap only after it has been fully initialized
+  _threadHeaps[heapIdx] = heap;
+  _threadHeapCount.store(heapIdx + 1u, std::memory_order_release);
+
+  return heap;
+}
+
+// <-
+
+void MainAllocator::updateHeapStats()
+{
+  _INTR_PROFILE_CPU("Memory", "Update Heap Stats");
+
+  const uint32_t heapCount = _threadHeapCount.load(std::memory_order_acquire);
+
+  HeapStats stats = {};
+  stats.heapCount = heapCount;
+  uint64_t largestFreeBlockSum = 0u;
+
+  for (uint32_t i = 0u; i < heapCount; ++i)
+  {
+    ThreadHeap* heap = _threadHeaps[i];
+
+    // The pools of other threads are only ever touched by their owners
+    if (heap == _threadHeap)
+    {
+      heap->sampleStats();
+    }
+    else
+    {
+      heap->statsRequested.store(true, std::memory_order_relaxed);
+    }
+
+    const ThreadHeapStats heapStats = heap->getStats();
+
+    stats.explicitHugePageHeapCount += heap->explicitHugePages ? 1u : 0u;
+    stats.poolCount += heapStats.poolCount;
+    stats.reservedSizeInBytes += heap->memEnd - heap->memBegin;
+    stats.committedSizeInBytes += heapStats.committedSizeInBytes;
+    stats.freeSizeInBytes += heapStats.freeSizeInBytes;
+    stats.largestFreeBlockSizeInBytes =
+        std::max(stats.largestFreeBlockSizeInBytes,
+                 heapStats.largestFreeBlockSizeInBytes);
+    largestFreeBlockSum += heapStats.largestFreeBlockSizeInBytes;
+  }
+
+  stats.fragmentation =
+      stats.freeSizeInBytes > 0u
+          ? 1.0f - (float)((double)largestFreeBlockSum / stats.freeSizeInBytes)
+          : 0.0f;
+
+  _heapStats = stats;
+}
+
+// <-
+
+void MainAllocator::freeRemote(void* p_Mem)
+{
+  const uint32_t heapCount = _threadHeapCount.load(std::memory_order_acquire);
+
+  for (uint32_t i = 0u; i < heapCount; ++i)
+  {
+    ThreadHeap* heap = _threadHeaps[i];
+    if (heap->owns(p_Mem))
+    {
+      heap->pushRemoteFree(p_Mem);
+      return;
+    }
+  }
+
+  _INTR_ASSERT(false && "Tried to free memory not owned by any thread heap");
+}
 }
 }
 }
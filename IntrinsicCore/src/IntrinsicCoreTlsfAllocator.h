@@ -14,11 +14,27 @@
 
 #pragma once
 
-#define _INTR_TLSF_SIZE_IN_MB 256u
-#define _INTR_TLSF_INIT_ON_DEMAND()                                            \
-  std::call_once(_onceFlag, []() {                                             \
-    _allocator = new Allocator(_INTR_TLSF_SIZE_IN_MB * 1024u * 1024u);         \
-  });
+// Address space reserved for the heap of the first thread allocating memory
+// (usually the main thread)
+#define _INTR_TLSF_RESERVED_SIZE_IN_MB 8192u
+// Address space reserved for the heaps of all other threads
+#define _INTR_TLSF_THREAD_HEAP_RESERVED_SIZE_IN_MB 1024u
+// Heaps grow in pools of (at least) this size. Memory is only committed when a
+// pool gets added
+#define _INTR_TLSF_POOL_SIZE_IN_MB 16u
+#define _INTR_TLSF_MAX_POOL_COUNT 512u
+// Max. count of heaps in existence. Heaps of exited threads are recycled, so
+// this only limits the count of threads allocating memory at the same time
+#define _INTR_TLSF_MAX_THREAD_HEAP_COUNT 64u
+
+// Huge page usage of the heaps (Linux only):
+// 0 = Disabled
+// 1 = Transparent huge pages
+// 2 = Explicit huge pages (hugetlbfs), falls back to transparent huge pages if
+// not enough huge pages are available
+#if !defined(_INTR_TLSF_HUGE_PAGE_MODE)
+#define _INTR_TLSF_HUGE_PAGE_MODE 1
+#endif // _INTR_TLSF_HUGE_PAGE_MODE
 
 namespace Intrinsic
 {
@@ -55,15 +71,31 @@ struct Allocator
 
   // <-
 
+  _INTR_INLINE void* addPool(void* p_Mem, uint32_t p_Size)
+  {
+    pool_t pool = tlsf_add_pool(_memoryPool, p_Mem, p_Size);
+    _INTR_ASSERT(pool && "Adding Tlsf pool failed");
+    return pool;
+  }
+
+  // <-
+
   _INTR_INLINE void* allocate(uint32_t p_Size)
   {
-    void* mem = tlsf_malloc(_memoryPool, p_Size);
+    void* mem = tryAllocate(p_Size);
     _INTR_ASSERT(mem && "Tlsf allocation failed");
     return mem;
   }
 
   // <-
 
+  _INTR_INLINE void* tryAllocate(uint32_t p_Size)
+  {
+    return tlsf_malloc(_memoryPool, p_Size);
+  }
+
+  // <-
+
   _INTR_INLINE void* allocateAligned(uint32_t p_Size, uint32_t p_Alignment)
   {
     return tlsf_memalign(_memoryPool, p_Alignment, p_Size);
@@ -81,20 +113,288 @@ struct Allocator
   void* _mem;
 };
 
+/**
+ * Snapshot of the state of a single thread heap.
+ */
+struct ThreadHeapStats
+{
+  uint32_t poolCount;
+  uint64_t committedSizeInBytes;
+  uint64_t freeSizeInBytes;
+  uint64_t largestFreeBlockSizeInBytes;
+};
+
+// <-
+
+/**
+ * TLSF heap owned by a single thread. Only the owning thread touches the TLSF
+ * pools; memory freed by other threads is pushed to a lock-free remote free
+ * list and handed back to the pools by the owner on its next allocation. The
+ * same goes for the stats of the heap which are sampled by the owner on
+ * request.
+ *
+ * The address space of the heap is reserved up front so the heap stays
+ * contiguous. Memory gets committed lazily by adding new pools at the end of
+ * the committed range once the existing pools are exhausted.
+ */
+struct ThreadHeap
+{
+  ThreadHeap(uint64_t p_ReservedSize);
+
+  // <-
+
+  _INTR_INLINE void* allocate(uint32_t p_Size)
+  {
+    void* mem = allocator.tryAllocate(p_Size);
+    if (mem == nullptr && grow(p_Size))
+    {
+      mem = allocator.tryAllocate(p_Size);
+    }
+    return mem;
+  }
+
+  // <-
+
+  /**
+   * Commits a new pool large enough to hold an allocation of the given size.
+   * Returns false if the reserved address space is exhausted or committing
+   * failed.
+   */
+  bool grow(uint32_t p_MinSize);
+
+  // <-
+
+  _INTR_INLINE bool owns(void* p_Mem) const
+  {
+    return (uint8_t*)p_Mem >= memBegin && (uint8_t*)p_Mem < memEnd;
+  }
+
+  // <-
+
+  /**
+   * Walks the pools and updates the stats snapshot. Must only be called by
+   * the owning thread.
+   */
+  void sampleStats();
+
+  // <-
+
+  _INTR_INLINE void sampleStatsIfRequested()
+  {
+    if (statsRequested.load(std::memory_order_relaxed) &&
+        statsRequested.exchange(false, std::memory_order_relaxed))
+    {
+      sampleStats();
+    }
+  }
+
+  // <-
+
+  _INTR_INLINE ThreadHeapStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+  }
+
+  // <-
+
+  _INTR_INLINE void pushRemoteFree(void* p_Mem)
+  {
+    // The freed block is large enough to store the link to the next block
+    void* head = remoteFreeHead.load(std::memory_order_relaxed);
+    do
+    {
+      *(void**)p_Mem = head;
+    } while (!remoteFreeHead.compare_exchange_weak(
+        head, p_Mem, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // <-
+
+  _INTR_INLINE void drainRemoteFrees()
+  {
+    if (remoteFreeHead.load(std::memory_order_relaxed) == nullptr)
+    {
+      return;
+    }
+
+    // Only the owner ever removes entries and it always takes the whole list,
+    // so the list can't suffer from ABA issues
+    void* mem = remoteFreeHead.exchange(nullptr, std::memory_order_acquire);
+    while (mem != nullptr)
+    {
+      void* next = *(void**)mem;
+      allocator.free(mem);
+      mem = next;
+    }
+  }
+
+  Allocator allocator;
+
+  // Reserved address space
+  uint8_t* memBegin;
+  uint8_t* memEnd;
+  uint8_t* memCommitEnd;
+
+  void* pools[_INTR_TLSF_MAX_POOL_COUNT];
+  uint32_t poolCount;
+  bool explicitHugePages;
+
+  std::atomic<void*> remoteFreeHead;
+
+  ThreadHeapStats stats;
+  std::mutex statsMutex;
+  std::atomic<bool> statsRequested;
+};
+
+// <-
+
+struct HeapStats
+{
+  uint32_t heapCount;
+  uint32_t explicitHugePageHeapCount;
+  uint32_t poolCount;
+
+  uint64_t reservedSizeInBytes;
+  uint64_t committedSizeInBytes;
+  uint64_t freeSizeInBytes;
+  uint64_t largestFreeBlockSizeInBytes;
+
+  // 0 if all free memory of each heap is available as a single block, close to
+  // 1 if the free memory is scattered across many small blocks
+  float fragmentation;
+};
+
+// <-
+
+/**
+ * Stored in front of each allocation of the main allocator. Keeps the 8 byte
+ * alignment of the TLSF blocks.
+ */
+struct AllocationHeader
+{
+  uint32_t size;
+  uint32_t tag;
+};
+
+// <-
+
+/**
+ * General purpose allocator backed by one TLSF heap per thread. Memory can be
+ * freed on any thread. All allocations are tracked using the memory tag
+ * active on the allocating thread.
+ */
 struct MainAllocator
 {
-  static void* allocate(uint32_t p_Size)
+  _INTR_INLINE static void* allocate(uint32_t p_Size)
   {
-    _INTR_TLSF_INIT_ON_DEMAND();
+    ThreadHeap* heap = _threadHeap;
+    if (heap == nullptr)
+    {
+      heap = acquireThreadHeap();
+    }
+
+    heap->drainRemoteFrees();
+    heap->sampleStatsIfRequested();
+
+    AllocationHeader* header =
+        (AllocationHeader*)heap->allocate(p_Size + sizeof(AllocationHeader));
+    if (header == nullptr)
+    {
+      Tracking::onOutOfMemory(p_Size);
+      _INTR_ASSERT(false && "Tlsf allocation failed");
+      return nullptr;
+    }
 
-    return _allocator->allocate(p_Size);
+    const Tag::Enum tag = Tracking::getCurrentTag();
+    header->size = p_Size;
+    header->tag = tag;
+    Tracking::onAllocate(tag, p_Size);
+
+    return header + 1u;
+  }
+
+  // <-
+
+  _INTR_INLINE static void free(void* p_Mem)
+  {
+    _INTR_ASSERT(p_Mem && "Tried to free nullptr");
+
+    AllocationHeader* header = (AllocationHeader*)p_Mem - 1u;
+    Tracking::onFree((Tag::Enum)header->tag, header->size);
+
+    ThreadHeap* heap = _threadHeap;
+    if (heap != nullptr && heap->owns(header))
+    {
+      heap->allocator.free(header);
+      return;
+    }
+
+    freeRemote(header);
+  }
+
+  // <-
+
+  _INTR_INLINE static uint32_t getHeapCount()
+  {
+    return _threadHeapCount.load(std::memory_order_acquire);
   }
 
-  static void free(void* p_Mem) { _allocator->free(p_Mem); }
+  /**
+   * Samples the heap of the calling thread and requests all other heaps to
+   * be sampled by their owners on their next allocation. The heap stats are
+   * then gathered from the latest snapshots, so the stats of the other heaps
+   * lag behind by one update.
+   */
+  static void updateHeapStats();
+
+  /**
+   * Returns the heap stats sampled by the last call to updateHeapStats.
+   */
+  _INTR_INLINE static const HeapStats& getHeapStats() { return _heapStats; }
 
 private:
-  static Allocator* _allocator;
-  static std::once_flag _onceFlag;
+  /**
+   * Releases the heap of the owning thread when the thread exits.
+   */
+  struct ThreadHeapOwner
+  {
+    ~ThreadHeapOwner();
+
+    ThreadHeap* heap;
+  };
+
+  /**
+   * Adopts the heap of an exited thread or creates a new heap for the
+   * calling thread.
+   */
+  static ThreadHeap* acquireThreadHeap();
+
+  /**
+   * Hands the heap over to the next thread calling acquireThreadHeap().
+   * Memory freed in the meantime is pushed to the remote free list of the
+   * heap and drained by its next owner.
+   */
+  static void releaseThreadHeap(ThreadHeap* p_Heap);
+
+  /**
+   * Creates a new heap. Requires _threadHeapMutex to be locked.
+   */
+  static ThreadHeap* createThreadHeap();
+
+  static void freeRemote(void* p_Mem);
+
+  static thread_local ThreadHeap* _threadHeap;
+  static thread_local ThreadHeapOwner _threadHeapOwner;
+  // Set once the heap of the thread has been released during thread exit
+  static thread_local bool _threadHeapReleased;
+  static ThreadHeap* _threadHeaps[_INTR_TLSF_MAX_THREAD_HEAP_COUNT];
+  static ThreadHeap* _freeThreadHeaps[_INTR_TLSF_MAX_THREAD_HEAP_COUNT];
+  static uint32_t _freeThreadHeapCount;
+  static std::atomic<uint32_t> _threadHeapCount;
+  static std::mutex _threadHeapMutex;
+
+  static HeapStats _heapStats;
 };
 }
 }
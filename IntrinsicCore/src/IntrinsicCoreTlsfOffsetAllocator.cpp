@@ -0,0 +1,384 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+namespace
+{
+_INTR_INLINE uint32_t findMsb(uint64_t p_Value)
+{
+#if defined(_WIN32)
+  unsigned long idx;
+  _BitScanReverse64(&idx, p_Value);
+  return (uint32_t)idx;
+#else
+  return 63u - (uint32_t)__builtin_clzll(p_Value);
+#endif // _WIN32
+}
+
+// <-
+
+_INTR_INLINE uint32_t findLsb(uint32_t p_Value)
+{
+#if defined(_WIN32)
+  unsigned long idx;
+  _BitScanForward(&idx, p_Value);
+  return (uint32_t)idx;
+#else
+  return (uint32_t)__builtin_ctz(p_Value);
+#endif // _WIN32
+}
+
+// <-
+
+_INTR_INLINE void mapSizeToBin(uint64_t p_Size, uint32_t& p_Fl, uint32_t& p_Sl)
+{
+  if (p_Size < TlsfOffsetAllocator::kSlCount)
+  {
+    // Small sizes get a bin of their own
+    p_Fl = 0u;
+    p_Sl = (uint32_t)p_Size;
+    return;
+  }
+
+  const uint32_t shift =
+      findMsb(p_Size) - _INTR_TLSF_OFFSET_ALLOCATOR_SL_COUNT_LOG2;
+  p_Fl = shift + 1u;
+  p_Sl = (uint32_t)(p_Size >> shift) - TlsfOffsetAllocator::kSlCount;
+}
+}
+
+// <-
+
+TlsfOffsetAllocator::TlsfOffsetAllocator()
+    : _flBitmap(0u), _sizeInBytes(0u), _freeSizeInBytes(0u),
+      _allocationCount(0u)
+{
+}
+
+// <-
+
+void TlsfOffsetAllocator::init(uint32_t p_Size)
+{
+  _sizeInBytes = p_Size;
+  reset();
+}
+
+// <-
+
+void TlsfOffsetAllocator::reset()
+{
+  _nodes.clear();
+  _unusedNodes.clear();
+
+  for (uint32_t i = 0u; i < kBinCount; ++i)
+  {
+    _binHeads[i] = kInvalidIdx;
+  }
+  _flBitmap = 0u;
+  memset(_slBitmaps, 0u, sizeof(_slBitmaps));
+
+  _freeSizeInBytes = _sizeInBytes;
+  _allocationCount = 0u;
+
+  if (_sizeInBytes > 0u)
+  {
+    insertFreeNode(createNode(0u, _sizeInBytes, kInvalidIdx, kInvalidIdx));
+  }
+}
+
+// <-
+
+bool TlsfOffsetAllocator::allocate(uint32_t p_Size, uint32_t p_Alignment,
+                                   TlsfOffsetAllocation& p_Allocation)
+{
+  _INTR_ASSERT(p_Size > 0u && "Tried to allocate zero bytes");
+  _INTR_ASSERT(p_Alignment > 0u && (p_Alignment & (p_Alignment - 1u)) == 0u &&
+               "Alignment has to be a power of two");
+
+  // Any block of this size can hold the allocation regardless of its offset
+  const uint32_t nodeIdx = findFreeNode((uint64_t)p_Size + p_Alignment - 1u);
+  if (nodeIdx == kInvalidIdx)
+  {
+    return false;
+  }
+
+  removeFreeNode(nodeIdx);
+
+  // Nodes are referenced by index only, creating new nodes might resize the
+  // node array
+  const uint32_t offset = _nodes[nodeIdx].offset;
+  const uint32_t alignedOffset =
+      (offset + p_Alignment - 1u) & ~(p_Alignment - 1u);
+
+  // Return the padding in front of the allocation to the free bins
+  const uint32_t paddingSize = alignedOffset - offset;
+  if (paddingSize > 0u)
+  {
+    const uint32_t prevIdx = _nodes[nodeIdx].neighborPrev;
+    const uint32_t paddingIdx =
+        createNode(offset, paddingSize, prevIdx, nodeIdx);
+    if (prevIdx != kInvalidIdx)
+    {
+      _nodes[prevIdx].neighborNext = paddingIdx;
+    }
+
+    _nodes[nodeIdx].neighborPrev = paddingIdx;
+    _nodes[nodeIdx].offset = alignedOffset;
+    _nodes[nodeIdx].size -= paddingSize;
+    insertFreeNode(paddingIdx);
+  }
+
+  // ...and the remainder behind it
+  const uint32_t remainderSize = _nodes[nodeIdx].size - p_Size;
+  if (remainderSize > 0u)
+  {
+    const uint32_t nextIdx = _nodes[nodeIdx].neighborNext;
+    const uint32_t remainderIdx =
+        createNode(alignedOffset + p_Size, remainderSize, nodeIdx, nextIdx);
+    if (nextIdx != kInvalidIdx)
+    {
+      _nodes[nextIdx].neighborPrev = remainderIdx;
+    }
+
+    _nodes[nodeIdx].neighborNext = remainderIdx;
+    _nodes[nodeIdx].size = p_Size;
+    insertFreeNode(remainderIdx);
+  }
+
+  _nodes[nodeIdx].used = true;
+  _freeSizeInBytes -= p_Size;
+  ++_allocationCount;
+
+  p_Allocation.offset = alignedOffset;
+  p_Allocation.nodeIdx = nodeIdx;
+  return true;
+}
+
+// <-
+
+void TlsfOffsetAllocator::free(uint32_t p_NodeIdx)
+{
+  _INTR_ASSERT(p_NodeIdx < _nodes.size() && _nodes[p_NodeIdx].used &&
+               "Tried to free an invalid allocation");
+
+  Node& node = _nodes[p_NodeIdx];
+  _freeSizeInBytes += node.size;
+  --_allocationCount;
+
+  // Merge with the free neighbors
+  const uint32_t prevIdx = node.neighborPrev;
+  if (prevIdx != kInvalidIdx && !_nodes[prevIdx].used)
+  {
+    const Node& prev = _nodes[prevIdx];
+    removeFreeNode(prevIdx);
+
+    node.offset = prev.offset;
+    node.size += prev.size;
+    node.neighborPrev = prev.neighborPrev;
+    if (node.neighborPrev != kInvalidIdx)
+    {
+      _nodes[node.neighborPrev].neighborNext = p_NodeIdx;
+    }
+    destroyNode(prevIdx);
+  }
+
+  const uint32_t nextIdx = node.neighborNext;
+  if (nextIdx != kInvalidIdx && !_nodes[nextIdx].used)
+  {
+    const Node& next = _nodes[nextIdx];
+    removeFreeNode(nextIdx);
+
+    node.size += next.size;
+    node.neighborNext = next.neighborNext;
+    if (node.neighborNext != kInvalidIdx)
+    {
+      _nodes[node.neighborNext].neighborPrev = p_NodeIdx;
+    }
+    destroyNode(nextIdx);
+  }
+
+  node.used = false;
+  insertFreeNode(p_NodeIdx);
+}
+
+// <-
+
+uint32_t TlsfOffsetAllocator::calcLargestFreeBlockInBytes() const
+{
+  if (_flBitmap == 0u)
+  {
+    return 0u;
+  }
+
+  // The largest block has to be in the highest non-empty bin
+  const uint32_t fl = findMsb(_flBitmap);
+  const uint32_t sl = findMsb(_slBitmaps[fl]);
+
+  uint32_t largestFreeBlockInBytes = 0u;
+  for (uint32_t nodeIdx = _binHeads[fl * kSlCount + sl]; nodeIdx != kInvalidIdx;
+       nodeIdx = _nodes[nodeIdx].binNext)
+  {
+    largestFreeBlockInBytes =
+        std::max(largestFreeBlockInBytes, _nodes[nodeIdx].size);
+  }
+
+  return largestFreeBlockInBytes;
+}
+
+// <-
+
+uint32_t TlsfOffsetAllocator::createNode(uint32_t p_Offset, uint32_t p_Size,
+                                         uint32_t p_NeighborPrev,
+                                         uint32_t p_NeighborNext)
+{
+  uint32_t nodeIdx;
+  if (!_unusedNodes.empty())
+  {
+    nodeIdx = _unusedNodes.back();
+    _unusedNodes.pop_back();
+  }
+  else
+  {
+    nodeIdx = (uint32_t)_nodes.size();
+    _nodes.push_back(Node());
+  }
+
+  Node& node = _nodes[nodeIdx];
+  node.offset = p_Offset;
+  node.size = p_Size;
+  node.binPrev = kInvalidIdx;
+  node.binNext = kInvalidIdx;
+  node.neighborPrev = p_NeighborPrev;
+  node.neighborNext = p_NeighborNext;
+  node.used = false;
+
+  return nodeIdx;
+}
+
+// <-
+
+void TlsfOffsetAllocator::destroyNode(uint32_t p_NodeIdx)
+{
+  _unusedNodes.push_back(p_NodeIdx);
+}
+
+// <-
+
+void TlsfOffsetAllocator::insertFreeNode(uint32_t p_NodeIdx)
+{
+  Node& node = _nodes[p_NodeIdx];
+
+  uint32_t fl, sl;
+  mapSizeToBin(node.size, fl, sl);
+  uint32_t& head = _binHeads[fl * kSlCount + sl];
+
+  node.binPrev = kInvalidIdx;
+  node.binNext = head;
+  if (head != kInvalidIdx)
+  {
+    _nodes[head].binPrev = p_NodeIdx;
+  }
+  head = p_NodeIdx;
+
+  _flBitmap |= 1u << fl;
+  _slBitmaps[fl] |= 1u << sl;
+}
+
+// <-
+
+void TlsfOffsetAllocator::removeFreeNode(uint32_t p_NodeIdx)
+{
+  Node& node = _nodes[p_NodeIdx];
+
+  if (node.binPrev != kInvalidIdx)
+  {
+    _nodes[node.binPrev].binNext = node.binNext;
+  }
+  if (node.binNext != kInvalidIdx)
+  {
+    _nodes[node.binNext].binPrev = node.binPrev;
+  }
+
+  uint32_t fl, sl;
+  mapSizeToBin(node.size, fl, sl);
+  uint32_t& head = _binHeads[fl * kSlCount + sl];
+
+  if (head == p_NodeIdx)
+  {
+    head = node.binNext;
+
+    if (head == kInvalidIdx)
+    {
+      _slBitmaps[fl] &= ~(1u << sl);
+      if (_slBitmaps[fl] == 0u)
+      {
+        _flBitmap &= ~(1u << fl);
+      }
+    }
+  }
+
+  node.binPrev = kInvalidIdx;
+  node.binNext = kInvalidIdx;
+}
+
+// <-
+
+uint32_t TlsfOffsetAllocator::findFreeNode(uint64_t p_MinSize) const
+{
+  // Round up to the next bin so all blocks in the bins searched are large
+  // enough
+  uint64_t size = p_MinSize;
+  if (size >= kSlCount)
+  {
+    const uint32_t shift =
+        findMsb(size) - _INTR_TLSF_OFFSET_ALLOCATOR_SL_COUNT_LOG2;
+    size += (1ull << shift) - 1u;
+  }
+
+  uint32_t fl, sl;
+  mapSizeToBin(size, fl, sl);
+  if (fl >= kFlCount)
+  {
+    return kInvalidIdx;
+  }
+
+  uint32_t slBitmap = _slBitmaps[fl] & (~0u << sl);
+  if (slBitmap == 0u)
+  {
+    // Continue with the next larger size class
+    const uint32_t flBitmap =
+        fl + 1u < kFlCount ? _flBitmap & (~0u << (fl + 1u)) : 0u;
+    if (flBitmap == 0u)
+    {
+      return kInvalidIdx;
+    }
+
+    fl = findLsb(flBitmap);
+    slBitmap = _slBitmaps[fl];
+  }
+
+  return _binHeads[fl * kSlCount + findLsb(slBitmap)];
+}
+}
+}
+}
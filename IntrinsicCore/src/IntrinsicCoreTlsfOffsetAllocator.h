@@ -0,0 +1,131 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Each power of two size class is split into 2^N linearly spaced bins
+#define _INTR_TLSF_OFFSET_ALLOCATOR_SL_COUNT_LOG2 3u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+struct TlsfOffsetAllocation
+{
+  uint32_t offset;
+  uint32_t nodeIdx;
+};
+
+// <-
+
+/**
+ * Two level segregated fit allocator handing out offsets into a range of
+ * memory it never touches itself (e.g. a page of GPU memory). All book keeping
+ * is stored in CPU side nodes, so the allocator can be used for any kind of
+ * memory. Allocating and freeing are O(1); free blocks are merged with their
+ * neighbors immediately.
+ */
+struct TlsfOffsetAllocator
+{
+  enum
+  {
+    kInvalidIdx = 0xFFFFFFFFu,
+
+    kSlCount = 1u << _INTR_TLSF_OFFSET_ALLOCATOR_SL_COUNT_LOG2,
+    kFlCount = 32u,
+    kBinCount = kFlCount * kSlCount
+  };
+
+  TlsfOffsetAllocator();
+
+  // <-
+
+  void init(uint32_t p_Size);
+
+  /**
+   * Frees all allocations at once. Outstanding nodes are invalidated.
+   */
+  void reset();
+
+  // <-
+
+  /**
+   * Allocates a block of the given size at an offset aligned to the given
+   * (power of two) alignment. Returns false if no free block large enough is
+   * available.
+   */
+  bool allocate(uint32_t p_Size, uint32_t p_Alignment,
+                TlsfOffsetAllocation& p_Allocation);
+  void free(uint32_t p_NodeIdx);
+
+  // <-
+
+  _INTR_INLINE uint32_t size() const { return _sizeInBytes; }
+  _INTR_INLINE uint32_t calcAvailableMemoryInBytes() const
+  {
+    return _freeSizeInBytes;
+  }
+  _INTR_INLINE uint32_t getAllocationCount() const
+  {
+    return _allocationCount;
+  }
+  _INTR_INLINE uint32_t getAllocationSize(uint32_t p_NodeIdx) const
+  {
+    return _nodes[p_NodeIdx].size;
+  }
+
+  uint32_t calcLargestFreeBlockInBytes() const;
+
+private:
+  struct Node
+  {
+    uint32_t offset;
+    uint32_t size;
+
+    // Links of the bin lists (free nodes only)
+    uint32_t binPrev;
+    uint32_t binNext;
+
+    // Neighbors in memory
+    uint32_t neighborPrev;
+    uint32_t neighborNext;
+
+    bool used;
+  };
+
+  uint32_t createNode(uint32_t p_Offset, uint32_t p_Size,
+                      uint32_t p_NeighborPrev, uint32_t p_NeighborNext);
+  void destroyNode(uint32_t p_NodeIdx);
+
+  void insertFreeNode(uint32_t p_NodeIdx);
+  void removeFreeNode(uint32_t p_NodeIdx);
+  uint32_t findFreeNode(uint64_t p_MinSize) const;
+
+  _INTR_ARRAY(Node) _nodes;
+  _INTR_ARRAY(uint32_t) _unusedNodes;
+
+  uint32_t _binHeads[kBinCount];
+  uint32_t _flBitmap;
+  uint32_t _slBitmaps[kFlCount];
+
+  uint32_t _sizeInBytes;
+  uint32_t _freeSizeInBytes;
+  uint32_t _allocationCount;
+};
+}
+}
+}
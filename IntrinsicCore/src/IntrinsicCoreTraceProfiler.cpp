@@ -0,0 +1,326 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+#if defined(_INTR_TRACE_PROFILING_ENABLED)
+
+namespace Intrinsic
+{
+namespace Core
+{
+// Static members
+std::atomic<bool> TraceProfiler::_capturing(false);
+thread_local TraceProfiler::ThreadBuffer* TraceProfiler::_threadBuffer =
+    nullptr;
+TraceProfiler::ThreadBuffer*
+    TraceProfiler::_threadBuffers[_INTR_TRACE_PROFILER_MAX_THREAD_COUNT];
+std::atomic<uint32_t> TraceProfiler::_threadBufferCount(0u);
+std::mutex TraceProfiler::_threadBufferMutex;
+
+std::atomic<uint32_t> TraceProfiler::_requestedFrameCount(0u);
+bool TraceProfiler::_captureWritePending = false;
+uint32_t TraceProfiler::_captureFirstFrameIdx = 0u;
+uint32_t TraceProfiler::_captureEndFrameIdx = 0u;
+uint64_t TraceProfiler::_captureBeginInNs = 0u;
+_INTR_ARRAY(uint64_t) TraceProfiler::_frameBeginTimesInNs;
+
+// <-
+
+void TraceProfiler::requestCapture(uint32_t p_FrameCount)
+{
+  _requestedFrameCount.store(p_FrameCount, std::memory_order_relaxed);
+}
+
+// <-
+
+void TraceProfiler::onFrameStarted(uint32_t p_FrameIdx)
+{
+  if (Settings::Manager::_traceCaptureFrameCount > 0u &&
+      p_FrameIdx == Settings::Manager::_traceCaptureStartFrame)
+  {
+    requestCapture(Settings::Manager::_traceCaptureFrameCount);
+  }
+
+  if (_capturing.load(std::memory_order_relaxed) &&
+      p_FrameIdx >= _captureEndFrameIdx)
+  {
+    // Scopes opening from now on don't record events anymore
+    _capturing.store(false, std::memory_order_seq_cst);
+    _captureWritePending = true;
+  }
+
+  // Scopes opened during the capture might still be running on the workers,
+  // e.g. in the render task of the last captured frame. The buffers are only
+  // read once all of them have been closed
+  if (_captureWritePending && !hasActiveScopes())
+  {
+    writeCapture();
+    _captureWritePending = false;
+  }
+
+  if (!_capturing.load(std::memory_order_relaxed) && !_captureWritePending &&
+      _requestedFrameCount.load(std::memory_order_relaxed) > 0u)
+  {
+    const uint32_t requestedFrameCount =
+        _requestedFrameCount.exchange(0u, std::memory_order_relaxed);
+
+    // No events are recorded outside of captures, so the write indices are
+    // stable here
+    const uint32_t threadBufferCount =
+        _threadBufferCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0u; i < threadBufferCount; ++i)
+    {
+      _threadBuffers[i]->captureStartIdx =
+          _threadBuffers[i]->writeIdx.load(std::memory_order_acquire);
+    }
+
+    _captureFirstFrameIdx = p_FrameIdx;
+    _captureEndFrameIdx = p_FrameIdx + requestedFrameCount;
+    _captureBeginInNs = getTimeInNs();
+    _frameBeginTimesInNs.clear();
+
+    _INTR_LOG_INFO("Capturing trace of frames %u to %u...",
+                   _captureFirstFrameIdx, _captureEndFrameIdx - 1u);
+    _capturing.store(true, std::memory_order_relaxed);
+  }
+
+  if (_capturing.load(std::memory_order_relaxed))
+  {
+    _frameBeginTimesInNs.push_back(getTimeInNs());
+  }
+}
+
+// <-
+
+TraceProfiler::ThreadBuffer* TraceProfiler::beginEvent()
+{
+  ThreadBuffer* buffer = _threadBuffer;
+  if (buffer == nullptr)
+  {
+    buffer = createThreadBuffer();
+    if (buffer == nullptr)
+    {
+      return nullptr;
+    }
+  }
+
+  // Either the main thread sees the active scope when checking for active
+  // scopes, or this thread sees the capture has ended
+  buffer->activeScopeCount.fetch_add(1u, std::memory_order_seq_cst);
+  if (!_capturing.load(std::memory_order_seq_cst))
+  {
+    buffer->activeScopeCount.fetch_sub(1u, std::memory_order_release);
+    return nullptr;
+  }
+
+  return buffer;
+}
+
+// <-
+
+void TraceProfiler::endEvent(ThreadBuffer* p_Buffer, const char* p_Group,
+                             const char* p_Name, uint64_t p_BeginInNs,
+                             uint64_t p_EndInNs)
+{
+  // Each buffer is only ever written by its owning thread
+  const uint64_t writeIdx = p_Buffer->writeIdx.load(std::memory_order_relaxed);
+  Event& event =
+      p_Buffer->events[writeIdx % _INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD];
+  event.group = p_Group;
+  event.name = p_Name;
+  event.beginInNs = p_BeginInNs;
+  event.endInNs = p_EndInNs;
+  p_Buffer->writeIdx.store(writeIdx + 1u, std::memory_order_release);
+
+  // Publishes the event to the main thread writing the capture
+  p_Buffer->activeScopeCount.fetch_sub(1u, std::memory_order_release);
+}
+
+// <-
+
+bool TraceProfiler::hasActiveScopes()
+{
+  // Sequentially consistent, so buffers created by scopes which still saw the
+  // capture running are not missed
+  const uint32_t threadBufferCount =
+      _threadBufferCount.load(std::memory_order_seq_cst);
+  for (uint32_t i = 0u; i < threadBufferCount; ++i)
+  {
+    if (_threadBuffers[i]->activeScopeCount.load(std::memory_order_seq_cst) !=
+        0u)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// <-
+
+TraceProfiler::ThreadBuffer* TraceProfiler::createThreadBuffer()
+{
+  std::lock_guard<std::mutex> lock(_threadBufferMutex);
+
+  const uint32_t bufferIdx = _threadBufferCount.load(std::memory_order_relaxed);
+  if (bufferIdx >= _INTR_TRACE_PROFILER_MAX_THREAD_COUNT)
+  {
+    return nullptr;
+  }
+
+  ThreadBuffer* buffer = new ThreadBuffer();
+  buffer->writeIdx.store(0u, std::memory_order_relaxed);
+  buffer->captureStartIdx = 0u;
+  buffer->activeScopeCount.store(0u, std::memory_order_relaxed);
+
+  // Publish the buffer only after it has been fully initialized
+  _threadBuffers[bufferIdx] = buffer;
+  _threadBufferCount.store(bufferIdx + 1u, std::memory_order_seq_cst);
+
+  _threadBuffer = buffer;
+  return buffer;
+}
+
+// <-
+
+void TraceProfiler::writeCapture()
+{
+  _INTR_STRING fileName = "trace_frames_" +
+                          StringUtil::toString(_captureFirstFrameIdx) + "_" +
+                          StringUtil::toString(_captureEndFrameIdx - 1u) +
+                          ".json";
+
+  FILE* fp = fopen(fileName.c_str(), "wb");
+
+  if (fp == nullptr)
+  {
+    _INTR_LOG_WARNING("Failed to write trace to file '%s'...",
+                      fileName.c_str());
+    return;
+  }
+
+  char* writeBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+  rapidjson::FileWriteStream os(fp, writeBuffer, 65536u);
+  rapidjson::Writer<rapidjson::FileWriteStream> writer(os);
+
+  writer.StartObject();
+  writer.Key("displayTimeUnit");
+  writer.String("ms");
+  writer.Key("traceEvents");
+  writer.StartArray();
+
+  // Frame markers
+  for (uint32_t i = 0u; i < _frameBeginTimesInNs.size(); ++i)
+  {
+    const _INTR_STRING frameName =
+        "Frame " + StringUtil::toString(_captureFirstFrameIdx + i);
+
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(frameName.c_str());
+    writer.Key("ph");
+    writer.String("i");
+    writer.Key("s");
+    writer.String("g");
+    writer.Key("ts");
+    writer.Double((_frameBeginTimesInNs[i] - _captureBeginInNs) * 0.001);
+    writer.Key("pid");
+    writer.Uint(0u);
+    writer.Key("tid");
+    writer.Uint(0u);
+    writer.EndObject();
+  }
+
+  uint64_t droppedEventCount = 0u;
+  const uint32_t threadBufferCount =
+      _threadBufferCount.load(std::memory_order_acquire);
+  for (uint32_t threadIdx = 0u; threadIdx < threadBufferCount; ++threadIdx)
+  {
+    const ThreadBuffer* buffer = _threadBuffers[threadIdx];
+    const uint64_t writeIdx = buffer->writeIdx.load(std::memory_order_acquire);
+
+    // Only the most recent events survive if the ring buffer wrapped around
+    uint64_t readIdx = buffer->captureStartIdx;
+    if (writeIdx - readIdx > _INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD)
+    {
+      const uint64_t firstIdx =
+          writeIdx - _INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD;
+      droppedEventCount += firstIdx - readIdx;
+      readIdx = firstIdx;
+    }
+
+    const _INTR_STRING threadName = "Thread " + StringUtil::toString(threadIdx);
+
+    writer.StartObject();
+    writer.Key("name");
+    writer.String("thread_name");
+    writer.Key("ph");
+    writer.String("M");
+    writer.Key("pid");
+    writer.Uint(0u);
+    writer.Key("tid");
+    writer.Uint(threadIdx);
+    writer.Key("args");
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(threadName.c_str());
+    writer.EndObject();
+    writer.EndObject();
+
+    for (; readIdx < writeIdx; ++readIdx)
+    {
+      const Event& event =
+          buffer->events[readIdx % _INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD];
+
+      writer.StartObject();
+      writer.Key("name");
+      writer.String(event.name);
+      writer.Key("cat");
+      writer.String(event.group);
+      writer.Key("ph");
+      writer.String("X");
+      writer.Key("ts");
+      writer.Double((event.beginInNs - _captureBeginInNs) * 0.001);
+      writer.Key("dur");
+      writer.Double((event.endInNs - event.beginInNs) * 0.001);
+      writer.Key("pid");
+      writer.Uint(0u);
+      writer.Key("tid");
+      writer.Uint(threadIdx);
+      writer.EndObject();
+    }
+  }
+
+  writer.EndArray();
+  writer.EndObject();
+
+  os.Flush();
+  fclose(fp);
+  Memory::Tlsf::MainAllocator::free(writeBuffer);
+
+  if (droppedEventCount > 0u)
+  {
+    _INTR_LOG_WARNING("Trace ring buffers overflowed, dropped %u events...",
+                      (uint32_t)droppedEventCount);
+  }
+
+  _INTR_LOG_INFO("Trace written to file '%s'...", fileName.c_str());
+}
+}
+}
+
+#endif // _INTR_TRACE_PROFILING_ENABLED
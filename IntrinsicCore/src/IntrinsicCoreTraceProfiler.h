@@ -0,0 +1,148 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#if defined(_INTR_TRACE_PROFILING_ENABLED)
+
+#define _INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD 65536u
+#define _INTR_TRACE_PROFILER_MAX_THREAD_COUNT 64u
+
+namespace Intrinsic
+{
+namespace Core
+{
+/**
+ * Lightweight CPU profiler backing the _INTR_PROFILE_CPU scopes if Microprofile
+ * is not available. Scopes are recorded to lock-free per thread ring buffers
+ * while a capture is running; a capture of a range of frames is written as a
+ * Chrome trace event JSON file (chrome://tracing, Perfetto). If no capture is
+ * running, a scope costs a single relaxed atomic load.
+ *
+ * Scopes opened during a capture are counted per thread, so the capture is
+ * only written once all of them have been closed - including the ones of
+ * tasks still running on the workers after the last captured frame.
+ */
+struct TraceProfiler
+{
+  struct Event
+  {
+    const char* group;
+    const char* name;
+    uint64_t beginInNs;
+    uint64_t endInNs;
+  };
+
+  // <-
+
+  /**
+   * Ring buffer of the events of a single thread. Only written by the owning
+   * thread.
+   */
+  struct ThreadBuffer
+  {
+    Event events[_INTR_TRACE_PROFILER_EVENT_COUNT_PER_THREAD];
+    std::atomic<uint64_t> writeIdx;
+    uint64_t captureStartIdx;
+
+    // Count of scopes of the owning thread which are recording an event
+    std::atomic<uint32_t> activeScopeCount;
+  };
+
+  // <-
+
+  struct Scope
+  {
+    _INTR_INLINE Scope(const char* p_Group, const char* p_Name)
+        : _group(p_Group), _name(p_Name), _buffer(nullptr), _beginInNs(0u)
+    {
+      if (_capturing.load(std::memory_order_relaxed))
+      {
+        _buffer = beginEvent();
+        if (_buffer != nullptr)
+        {
+          _beginInNs = getTimeInNs();
+        }
+      }
+    }
+
+    _INTR_INLINE ~Scope()
+    {
+      if (_buffer != nullptr)
+      {
+        endEvent(_buffer, _group, _name, _beginInNs, getTimeInNs());
+      }
+    }
+
+    const char* _group;
+    const char* _name;
+    ThreadBuffer* _buffer;
+    uint64_t _beginInNs;
+  };
+
+  // <-
+
+  /**
+   * Requests a capture of the given amount of frames, starting with the next
+   * frame. Can be called from any thread.
+   */
+  static void requestCapture(uint32_t p_FrameCount);
+
+  /**
+   * Has to be called on the main thread before any scope of a new frame is
+   * opened. Starts the requested captures and writes the finished ones.
+   */
+  static void onFrameStarted(uint32_t p_FrameIdx);
+
+  // <-
+
+  _INTR_INLINE static uint64_t getTimeInNs()
+  {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static std::atomic<bool> _capturing;
+
+private:
+  /**
+   * Registers a scope opened during a capture. Returns nullptr if the
+   * capture ended in the meantime or no buffer is left for the thread.
+   */
+  static ThreadBuffer* beginEvent();
+  static void endEvent(ThreadBuffer* p_Buffer, const char* p_Group,
+                       const char* p_Name, uint64_t p_BeginInNs,
+                       uint64_t p_EndInNs);
+  static bool hasActiveScopes();
+  static ThreadBuffer* createThreadBuffer();
+  static void writeCapture();
+
+  static thread_local ThreadBuffer* _threadBuffer;
+  static ThreadBuffer* _threadBuffers[_INTR_TRACE_PROFILER_MAX_THREAD_COUNT];
+  static std::atomic<uint32_t> _threadBufferCount;
+  static std::mutex _threadBufferMutex;
+
+  static std::atomic<uint32_t> _requestedFrameCount;
+  static bool _captureWritePending;
+  static uint32_t _captureFirstFrameIdx;
+  static uint32_t _captureEndFrameIdx;
+  static uint64_t _captureBeginInNs;
+  static _INTR_ARRAY(uint64_t) _frameBeginTimesInNs;
+};
+}
+}
+
+#endif // _INTR_TRACE_PROFILING_ENABLED
@@ -31,6 +31,34 @@ _INTR_INLINE bool fileExists(const char* p_FilePath)
 
   return false;
 }
+
+// <-
+
+/**
+ * 64-bit FNV-1a style hash of the given data. Consumes eight bytes per step,
+ * so it is meant for detecting changes in large blobs - not for hash tables.
+ */
+_INTR_INLINE uint64_t calcHash(const void* p_Data, uint64_t p_SizeInBytes)
+{
+  const uint8_t* data = (const uint8_t*)p_Data;
+  uint64_t hash = 0xcbf29ce484222325ull ^ p_SizeInBytes;
+
+  uint64_t offset = 0u;
+  for (; offset + sizeof(uint64_t) <= p_SizeInBytes;
+       offset += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, data + offset, sizeof(uint64_t));
+    hash = (hash ^ word) * 0x100000001b3ull;
+  }
+
+  for (; offset < p_SizeInBytes; ++offset)
+  {
+    hash = (hash ^ data[offset]) * 0x100000001b3ull;
+  }
+
+  return hash;
+}
 }
 }
 }
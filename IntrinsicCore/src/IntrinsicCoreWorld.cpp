@@ -65,6 +65,9 @@ void World::init()
 
 Components::NodeRef World::cloneNodeFull(Components::NodeRef p_Ref)
 {
+  // Creates resources the frame rendered in parallel might be reading
+  TaskManager::waitForRendering();
+
   rapidjson::Document doc;
 
   // Collect entities
@@ -218,6 +221,9 @@ void World::alignNodeWithGround(Components::NodeRef p_NodeRef)
 
 void World::destroyNodeFull(Components::NodeRef p_NodeRef)
 {
+  // Destroys resources the frame rendered in parallel might be reading
+  TaskManager::waitForRendering();
+
   // Collect entities
   Entity::EntityRefArray entities;
   Components::NodeManager::collectEntities(p_NodeRef, entities);
@@ -240,6 +246,8 @@ void World::destroyNodeFull(Components::NodeRef p_NodeRef)
 
 void World::destroy()
 {
+  TaskManager::waitForRendering();
+
   _flags |= WorldFlags::kLoadingUnloading;
   destroyNodeFull(_rootNode);
   _rootNode = Components::NodeRef();
@@ -266,16 +274,13 @@ void World::saveNodeHierarchy(const _INTR_STRING& p_FilePath,
 
   _INTR_ARRAY(Components::NodeRef) storedNodes;
 
-  Components::NodeRef nodeStack[64];
-  uint32_t nodeStackCount = 1u;
-  nodeStack[0] = p_RootNodeRef;
+  _INTR_SCRATCH_ARRAY(Components::NodeRef) nodeStack;
+  nodeStack.push_back(p_RootNodeRef);
 
-  while (nodeStackCount > 0u)
+  while (!nodeStack.empty())
   {
-    _INTR_ASSERT(nodeStackCount <= 64u);
-
-    --nodeStackCount;
-    Components::NodeRef currentNodeRef = nodeStack[nodeStackCount];
+    Components::NodeRef currentNodeRef = nodeStack.back();
+    nodeStack.pop_back();
 
     Entity::EntityRef entityRef =
         Components::NodeManager::_entity(currentNodeRef);
@@ -289,13 +294,11 @@ void World::saveNodeHierarchy(const _INTR_STRING& p_FilePath,
 
     if (firstChild.isValid())
     {
-      nodeStack[nodeStackCount] = firstChild;
-      ++nodeStackCount;
+      nodeStack.push_back(firstChild);
     }
     if (p_RootNodeRef != currentNodeRef && nextSibling.isValid())
     {
-      nodeStack[nodeStackCount] = nextSibling;
-      ++nodeStackCount;
+      nodeStack.push_back(nextSibling);
     }
 
     // Don't serialize spawned objects
@@ -476,6 +479,8 @@ Components::NodeRef World::loadNodeHierarchy(const _INTR_STRING& p_FilePath)
 
 void World::loadNodeResources(Components::NodeRef p_RootNodeRef)
 {
+  TaskManager::waitForRendering();
+
   Components::NodeRefArray nodeRefs;
   Components::NodeManager::collectNodes(p_RootNodeRef, nodeRefs);
 
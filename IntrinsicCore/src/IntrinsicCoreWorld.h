@@ -38,6 +38,11 @@ struct World
 
   // <-
 
+  /**
+   * Destroys/clones the given node hierarchy including all components and
+   * resources. Waits for the frame rendered in parallel first, so both are
+   * safe to call from scripts while pipelined rendering is enabled.
+   */
   static void destroyNodeFull(Components::NodeRef p_Ref);
   static Components::NodeRef cloneNodeFull(Components::NodeRef p_Ref);
   static void alignNodeWithGround(Components::NodeRef p_NodeRef);
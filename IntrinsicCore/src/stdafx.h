@@ -18,6 +18,8 @@
 #if defined(_WIN32)
 #define NOMINMAX
 #include "windows.h"
+#else
+#include <sys/mman.h>
 #endif // _WIN32
 
 // GLM and GLI related includes
@@ -73,6 +75,8 @@
 #include <cmath>
 #include <thread>
 #include <mutex>
+#include <chrono>
+#include <sys/stat.h>
 
 // Core related includes
 #include "IntrinsicCoreVersion.h"
@@ -82,8 +86,10 @@
 #include "IntrinsicCoreLogManager.h"
 
 // STL allocator include
+#include "IntrinsicCoreMemoryTracking.h"
 #include "IntrinsicCoreTlsfAllocator.h"
 #include "IntrinsicCoreStlAllocator.h"
+#include "IntrinsicCoreScratchAllocator.h"
 
 // Lua related includes
 extern "C" {
@@ -154,15 +160,21 @@ namespace CComponents = Intrinsic::Core::Components;
 #include "IntrinsicCoreTriangleOptimizer.h"
 #include "IntrinsicCoreSettingsManager.h"
 #include "IntrinsicCoreLockFreeStack.h"
+#include "IntrinsicCoreLockFreeQueue.h"
+#include "IntrinsicCoreLockFreeAppendArray.h"
 #include "IntrinsicCoreLinearOffsetAllocator.h"
+#include "IntrinsicCoreTlsfOffsetAllocator.h"
 #include "IntrinsicCoreLockFreeFixedBlockAllocator.h"
 #include "IntrinsicCoreStringUtil.h"
 #include "IntrinsicCoreUtil.h"
+#include "IntrinsicCoreMappedFile.h"
 #include "IntrinsicCoreSimd.h"
 #include "IntrinsicCoreMath.h"
 #include "IntrinsicCoreName.h"
 #include "IntrinsicCoreTimingHelper.h"
+#include "IntrinsicCoreTraceProfiler.h"
 #include "IntrinsicCoreDod.h"
+#include "IntrinsicCoreDynamicAABBTree.h"
 #include "IntrinsicCoreRenderingIBL.h"
 #include "IntrinsicCoreJsonHelper.h"
 #include "IntrinsicCoreEntity.h"
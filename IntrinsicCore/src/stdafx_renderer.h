@@ -39,6 +39,7 @@
 #include "IntrinsicRendererRenderStates.h"
 #include "IntrinsicRendererSamplers.h"
 #include "IntrinsicRendererGpuMemoryManager.h"
+#include "IntrinsicRendererUploadManager.h"
 #include "IntrinsicRendererRenderSystem.h"
 #include "IntrinsicRendererRenderProcessUniformManager.h"
 #include "IntrinsicRendererRenderProcess.h"
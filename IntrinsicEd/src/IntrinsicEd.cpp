@@ -648,6 +648,7 @@ spawnDefaultEntity(const Name& p_Name,
     }
 
     Components::NodeManager::_orientation(nodeRef) = p_InitialOrientation;
+    Components::NodeManager::markLocalTransformDirty(nodeRef);
     GameStates::Editing::_currentlySelectedEntity = entityRef;
   }
 
@@ -142,6 +142,8 @@ _INTR_INLINE void IntrinsicEdViewport::positionNodeOnGround(Dod::Ref p_NodeRef)
   {
     NodeManager::_position(p_NodeRef) = worldRay.o + worldRay.d * 10.0f;
   }
+
+  NodeManager::markLocalTransformDirty(p_NodeRef);
 }
 
 void IntrinsicEdViewport::dragMoveEvent(QDragMoveEvent* event)
@@ -199,6 +201,7 @@ void IntrinsicEdViewport::spawnPrefab(const _INTR_STRING& p_PrefabFilePath)
       NodeManager::_orientation(nodeRef) * glm::quat(randomRotEuler);
   NodeManager::_size(nodeRef) *=
       glm::vec3(randomScale.x, randomScale.y, randomScale.x);
+  NodeManager::markLocalTransformDirty(nodeRef);
 
   Components::NodeManager::rebuildTreeAndUpdateTransforms();
   World::loadNodeResources(nodeRef);
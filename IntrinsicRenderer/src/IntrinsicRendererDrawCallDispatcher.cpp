@@ -35,7 +35,19 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
     VkCommandBuffer secondCmdBuffer =
         *RenderSystem::getSecondaryCommandBuffers(_secondaryCmdBufferIdx);
 
+    // State currently bound to the secondary command buffer
     VkPipeline currentPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout currentPipelineLayout = VK_NULL_HANDLE;
+    VkDescriptorSet currentDescSet = VK_NULL_HANDLE;
+    _INTR_ARRAY(uint32_t) currentDynamicOffsets;
+    _INTR_ARRAY(VkBuffer) currentVtxBuffers;
+    _INTR_ARRAY(VkDeviceSize) currentVtxBufferOffsets;
+    VkBuffer currentIndexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize currentIndexBufferOffset = 0u;
+    VkIndexType currentIndexType = VK_INDEX_TYPE_UINT16;
+
+    uint32_t issuedBindCount = 0u;
+    uint32_t skippedBindCount = 0u;
 
     for (uint32_t dcIdx = _rangeStart; dcIdx < _rangeEnd; ++dcIdx)
     {
@@ -54,30 +66,84 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
         vkCmdBindPipeline(secondCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                           newPipeline);
         currentPipeline = newPipeline;
+        ++issuedBindCount;
+      }
+      else
+      {
+        ++skippedBindCount;
       }
 
-      VkDescriptorSet descSets[2] = {
-          Resources::DrawCallManager::_vkDescriptorSet(drawCallRef),
-          Resources::ImageManager::_globalTextureDescriptorSet};
+      // Bind descriptor sets
+      {
+        VkPipelineLayout pipelineLayout =
+            Resources::PipelineLayoutManager::_vkPipelineLayout(
+                pipelineLayoutRef);
+        VkDescriptorSet descSet =
+            Resources::DrawCallManager::_vkDescriptorSet(drawCallRef);
+        const _INTR_ARRAY(uint32_t)& dynamicOffsets =
+            Resources::DrawCallManager::_dynamicOffsets(drawCallRef);
+        _INTR_ASSERT(descSet);
+
+        const bool dynamicOffsetsChanged =
+            dynamicOffsets != currentDynamicOffsets;
+
+        if (pipelineLayout != currentPipelineLayout)
+        {
+          // Rebind the global texture set too, the new layout might not be
+          // compatible with the previous one
+          VkDescriptorSet descSets[2] = {
+              descSet, Resources::ImageManager::_globalTextureDescriptorSet};
+          vkCmdBindDescriptorSets(secondCmdBuffer,
+                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                  pipelineLayout, 0u, 2u, descSets,
+                                  (uint32_t)dynamicOffsets.size(),
+                                  dynamicOffsets.data());
+          ++issuedBindCount;
+        }
+        else if (descSet != currentDescSet || dynamicOffsetsChanged)
+        {
+          // Only the per draw call set changed, keep the global texture set
+          vkCmdBindDescriptorSets(secondCmdBuffer,
+                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                  pipelineLayout, 0u, 1u, &descSet,
+                                  (uint32_t)dynamicOffsets.size(),
+                                  dynamicOffsets.data());
+          ++issuedBindCount;
+        }
+        else
+        {
+          ++skippedBindCount;
+        }
 
-      _INTR_ASSERT(Resources::DrawCallManager::_vkDescriptorSet(drawCallRef));
-      vkCmdBindDescriptorSets(
-          secondCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-          Resources::PipelineLayoutManager::_vkPipelineLayout(
-              pipelineLayoutRef),
-          0u, 2u, descSets,
-          (uint32_t)Resources::DrawCallManager::_dynamicOffsets(drawCallRef)
-              .size(),
-          Resources::DrawCallManager::_dynamicOffsets(drawCallRef).data());
+        currentPipelineLayout = pipelineLayout;
+        currentDescSet = descSet;
+        if (dynamicOffsetsChanged)
+        {
+          currentDynamicOffsets = dynamicOffsets;
+        }
+      }
 
       // Bind vertex buffers
       {
-        _INTR_ARRAY(VkBuffer)& vtxBuffers =
+        const _INTR_ARRAY(VkBuffer)& vtxBuffers =
             Resources::DrawCallManager::_vertexBuffers(drawCallRef);
-        vkCmdBindVertexBuffers(
-            secondCmdBuffer, 0u, (uint32_t)vtxBuffers.size(), vtxBuffers.data(),
-            Resources::DrawCallManager::_vertexBufferOffsets(drawCallRef)
-                .data());
+        const _INTR_ARRAY(VkDeviceSize)& vtxBufferOffsets =
+            Resources::DrawCallManager::_vertexBufferOffsets(drawCallRef);
+
+        if (vtxBuffers != currentVtxBuffers ||
+            vtxBufferOffsets != currentVtxBufferOffsets)
+        {
+          vkCmdBindVertexBuffers(secondCmdBuffer, 0u,
+                                 (uint32_t)vtxBuffers.size(), vtxBuffers.data(),
+                                 vtxBufferOffsets.data());
+          currentVtxBuffers = vtxBuffers;
+          currentVtxBufferOffsets = vtxBufferOffsets;
+          ++issuedBindCount;
+        }
+        else
+        {
+          ++skippedBindCount;
+        }
       }
 
       // Draw
@@ -91,22 +157,38 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
                       BufferType::kIndex16
                   ? VK_INDEX_TYPE_UINT16
                   : VK_INDEX_TYPE_UINT32;
-          vkCmdBindIndexBuffer(
-              secondCmdBuffer,
-              Resources::BufferManager::_vkBuffer(indexBufferRef),
-              Resources::DrawCallManager::_indexBufferOffset(drawCallRef),
-              indexType);
+          VkBuffer indexBuffer =
+              Resources::BufferManager::_vkBuffer(indexBufferRef);
+          const VkDeviceSize indexBufferOffset =
+              Resources::DrawCallManager::_indexBufferOffset(drawCallRef);
+
+          if (indexBuffer != currentIndexBuffer ||
+              indexBufferOffset != currentIndexBufferOffset ||
+              indexType != currentIndexType)
+          {
+            vkCmdBindIndexBuffer(secondCmdBuffer, indexBuffer,
+                                 indexBufferOffset, indexType);
+            currentIndexBuffer = indexBuffer;
+            currentIndexBufferOffset = indexBufferOffset;
+            currentIndexType = indexType;
+            ++issuedBindCount;
+          }
+          else
+          {
+            ++skippedBindCount;
+          }
+
           vkCmdDrawIndexed(
               secondCmdBuffer,
               Resources::DrawCallManager::_descIndexCount(drawCallRef),
-              Resources::DrawCallManager::_descInstanceCount(drawCallRef), 0u,
-              0u, 0u);
+              Resources::DrawCallManager::_instanceCount(drawCallRef), 0u, 0u,
+              0u);
         }
         else
         {
           vkCmdDraw(secondCmdBuffer,
                     Resources::DrawCallManager::_descVertexCount(drawCallRef),
-                    Resources::DrawCallManager::_descInstanceCount(drawCallRef),
+                    Resources::DrawCallManager::_instanceCount(drawCallRef),
                     0u, 0u);
         }
 
@@ -114,6 +196,9 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
       }
     }
 
+    DrawCallDispatcher::_issuedBindCount += issuedBindCount;
+    DrawCallDispatcher::_skippedBindCount += skippedBindCount;
+
     RenderSystem::endSecondaryCommandBuffer(_secondaryCmdBufferIdx);
   }
 
@@ -131,7 +216,11 @@ uint32_t _activeTaskCount = 0u;
 }
 
 std::atomic<uint32_t> DrawCallDispatcher::_dispatchedDrawCallCount;
+std::atomic<uint32_t> DrawCallDispatcher::_issuedBindCount;
+std::atomic<uint32_t> DrawCallDispatcher::_skippedBindCount;
 uint32_t DrawCallDispatcher::_totalDispatchedDrawCallCountPerFrame = 0u;
+uint32_t DrawCallDispatcher::_totalIssuedBindCountPerFrame = 0u;
+uint32_t DrawCallDispatcher::_totalSkippedBindCountPerFrame = 0u;
 uint32_t DrawCallDispatcher::_totalDispatchCallsPerFrame = 0u;
 
 // <-
@@ -143,6 +232,8 @@ void DrawCallDispatcher::queueDrawCalls(Core::Dod::RefArray& p_DrawCalls,
   _INTR_PROFILE_CPU("General", "Queue Draw Calls");
 
   _dispatchedDrawCallCount = 0u;
+  _issuedBindCount = 0u;
+  _skippedBindCount = 0u;
   const uint32_t dcCount = (uint32_t)p_DrawCalls.size();
 
   if (dcCount == 0u)
@@ -195,6 +286,8 @@ void DrawCallDispatcher::queueDrawCalls(Core::Dod::RefArray& p_DrawCalls,
   }
 
   _totalDispatchedDrawCallCountPerFrame += _dispatchedDrawCallCount;
+  _totalIssuedBindCountPerFrame += _issuedBindCount;
+  _totalSkippedBindCountPerFrame += _skippedBindCount;
   ++_totalDispatchCallsPerFrame;
 }
 
@@ -206,9 +299,15 @@ void DrawCallDispatcher::onFrameEnded()
                             _totalDispatchedDrawCallCountPerFrame);
   _INTR_PROFILE_COUNTER_SET("Total Draw Call Dispatch Calls",
                             _totalDispatchCallsPerFrame);
+  _INTR_PROFILE_COUNTER_SET("Total Issued Binds",
+                            _totalIssuedBindCountPerFrame);
+  _INTR_PROFILE_COUNTER_SET("Total Skipped Binds",
+                            _totalSkippedBindCountPerFrame);
 
   _totalDispatchCallsPerFrame = 0u;
   _totalDispatchedDrawCallCountPerFrame = 0u;
+  _totalIssuedBindCountPerFrame = 0u;
+  _totalSkippedBindCountPerFrame = 0u;
   _activeTaskCount = 0u;
 }
 }
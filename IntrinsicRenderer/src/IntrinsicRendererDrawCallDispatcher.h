@@ -26,7 +26,13 @@ struct DrawCallDispatcher
                              Core::Dod::Ref p_Framebuffer);
 
   static std::atomic<uint32_t> _dispatchedDrawCallCount;
+  // Pipeline, descriptor set, vertex and index buffer binds of the last queue
+  static std::atomic<uint32_t> _issuedBindCount;
+  static std::atomic<uint32_t> _skippedBindCount;
+
   static uint32_t _totalDispatchedDrawCallCountPerFrame;
+  static uint32_t _totalIssuedBindCountPerFrame;
+  static uint32_t _totalSkippedBindCountPerFrame;
   static uint32_t _totalDispatchCallsPerFrame;
 };
 }
@@ -52,6 +52,10 @@ struct GpuMemoryAllocationInfo
   uint32_t _sizeInBytes;
   uint32_t _alignmentInBytes;
   uint8_t* _mappedMemory;
+
+  // Used to free the allocation again
+  uint32_t _allocationIdx;
+  uint32_t _poolGeneration;
 };
 
 namespace RenderSize
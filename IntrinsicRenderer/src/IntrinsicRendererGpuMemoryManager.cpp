@@ -22,6 +22,9 @@ namespace Renderer
 // Static members
 _INTR_ARRAY(GpuMemoryPage)
 GpuMemoryManager::_memoryPools[MemoryPoolType::kCount];
+GpuMemoryPoolStats GpuMemoryManager::_memoryPoolStats[MemoryPoolType::kCount] =
+    {};
+uint32_t GpuMemoryManager::_poolGenerations[MemoryPoolType::kCount] = {};
 
 MemoryLocation::Enum
     GpuMemoryManager::_memoryPoolToMemoryLocation[MemoryPoolType::kCount] = {};
@@ -33,6 +36,28 @@ const char* GpuMemoryManager::_memoryPoolNames[MemoryPoolType::kCount] = {};
 
 namespace
 {
+_INTR_INLINE GpuMemoryAllocationInfo
+makeAllocationInfo(MemoryPoolType::Enum p_MemoryPoolType, uint32_t p_PageIdx,
+                   const GpuMemoryPage& p_Page,
+                   const Core::Memory::TlsfOffsetAllocation& p_Allocation,
+                   uint32_t p_Size, uint32_t p_Alignment,
+                   uint32_t p_PoolGeneration)
+{
+  GpuMemoryAllocationInfo info;
+  info._memoryPoolType = p_MemoryPoolType;
+  info._pageIdx = p_PageIdx;
+  info._offset = p_Allocation.offset;
+  info._vkDeviceMemory = p_Page._vkDeviceMemory;
+  info._sizeInBytes = p_Size;
+  info._alignmentInBytes = p_Alignment;
+  info._mappedMemory = p_Page._mappedMemory != nullptr
+                           ? &p_Page._mappedMemory[p_Allocation.offset]
+                           : nullptr;
+  info._allocationIdx = p_Allocation.nodeIdx;
+  info._poolGeneration = p_PoolGeneration;
+
+  return info;
+}
 }
 
 void GpuMemoryManager::init()
@@ -79,12 +104,13 @@ void GpuMemoryManager::init()
 
 // <-
 
-GpuMemoryAllocationInfo
-GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
-                                 uint32_t p_Size, uint32_t p_Alignment,
-                                 uint32_t p_MemoryTypeFlags)
+GpuMemoryAllocationInfo GpuMemoryManager::allocateOffset(
+    MemoryPoolType::Enum p_MemoryPoolType, uint32_t p_Size,
+    uint32_t p_Alignment, uint32_t p_MemoryTypeFlags,
+    uint32_t p_ExcludedPageIdx)
 {
   _INTR_ARRAY(GpuMemoryPage)& poolPages = _memoryPools[p_MemoryPoolType];
+  Core::Memory::TlsfOffsetAllocation allocation;
 
   // Try to find a fitting page
   for (uint32_t pageIdx = 0u; pageIdx < _memoryPools[p_MemoryPoolType].size();
@@ -92,14 +118,15 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
   {
     GpuMemoryPage& page = poolPages[pageIdx];
 
-    if ((p_MemoryTypeFlags & (1u << page._memoryTypeIdx)) > 0u &&
-        page._allocator.fits(p_Size, p_Alignment))
+    if (pageIdx != p_ExcludedPageIdx &&
+        page._vkDeviceMemory != VK_NULL_HANDLE &&
+        (p_MemoryTypeFlags & (1u << page._memoryTypeIdx)) > 0u &&
+        page._allocator.allocate(p_Size, p_Alignment, allocation))
     {
-      const uint32_t offset = page._allocator.allocate(p_Size, p_Alignment);
-      return {p_MemoryPoolType, pageIdx, offset, page._vkDeviceMemory, p_Size,
-              p_Alignment,
-              page._mappedMemory != nullptr ? &page._mappedMemory[offset]
-                                            : nullptr};
+      onAllocation(p_MemoryPoolType);
+      return makeAllocationInfo(p_MemoryPoolType, pageIdx, page, allocation,
+                                p_Size, p_Alignment,
+                                _poolGenerations[p_MemoryPoolType]);
     }
   }
 
@@ -122,11 +149,27 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
             memoryPropertyFlags &&
         (p_MemoryTypeFlags & (1u << memoryTypeIdx)) > 0u)
     {
-      poolPages.resize(poolPages.size() + 1u);
-      GpuMemoryPage& page = poolPages.back();
+      // Reuse the slot of a released page so the indices of the other pages
+      // stay valid
+      uint32_t pageIdx = 0u;
+      for (; pageIdx < poolPages.size(); ++pageIdx)
+      {
+        if (pageIdx != p_ExcludedPageIdx &&
+            poolPages[pageIdx]._vkDeviceMemory == VK_NULL_HANDLE)
+        {
+          break;
+        }
+      }
+      if (pageIdx == poolPages.size())
+      {
+        poolPages.resize(poolPages.size() + 1u);
+      }
+
+      GpuMemoryPage& page = poolPages[pageIdx];
       {
         page._allocator.init(_INTR_GPU_PAGE_SIZE_IN_BYTES);
         page._memoryTypeIdx = memoryTypeIdx;
+        page._mappedMemory = nullptr;
 
         VkMemoryAllocateInfo memAllocInfo = {};
         {
@@ -139,6 +182,13 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
         VkResult result =
             vkAllocateMemory(RenderSystem::_vkDevice, &memAllocInfo, nullptr,
                              &page._vkDeviceMemory);
+        if (result != VK_SUCCESS)
+        {
+          _INTR_LOG_ERROR("Failed to allocate a new page for memory pool '%s'",
+                          _memoryPoolNames[p_MemoryPoolType]);
+          Core::Memory::Tracking::writeReport(
+              "memory_report_out_of_gpu_memory.json");
+        }
         _INTR_VK_CHECK_RESULT(result);
       }
 
@@ -151,14 +201,15 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
         _INTR_VK_CHECK_RESULT(result);
       }
 
-      _INTR_ASSERT(page._allocator.fits(p_Size, p_Alignment) &&
-                   "Allocation does not fit in a single page");
+      const bool allocated =
+          page._allocator.allocate(p_Size, p_Alignment, allocation);
+      _INTR_ASSERT(allocated && "Allocation does not fit in a single page");
+      (void)allocated;
 
-      const uint32_t offset = page._allocator.allocate(p_Size, p_Alignment);
-      return {p_MemoryPoolType, (uint32_t)poolPages.size() - 1u, offset,
-              page._vkDeviceMemory, p_Size, p_Alignment,
-              page._mappedMemory != nullptr ? &page._mappedMemory[offset]
-                                            : nullptr};
+      onAllocation(p_MemoryPoolType);
+      return makeAllocationInfo(p_MemoryPoolType, pageIdx, page, allocation,
+                                p_Size, p_Alignment,
+                                _poolGenerations[p_MemoryPoolType]);
     }
   }
 
@@ -168,8 +219,238 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
 
 // <-
 
+void GpuMemoryManager::freeOffset(
+    const GpuMemoryAllocationInfo& p_AllocationInfo)
+{
+  // Allocations of pools which have been reset since are gone already
+  if (p_AllocationInfo._poolGeneration !=
+      _poolGenerations[p_AllocationInfo._memoryPoolType])
+  {
+    return;
+  }
+
+  GpuMemoryPage& page = _memoryPools[p_AllocationInfo._memoryPoolType]
+                                    [p_AllocationInfo._pageIdx];
+  _INTR_ASSERT(page._vkDeviceMemory == p_AllocationInfo._vkDeviceMemory);
+  page._allocator.free(p_AllocationInfo._allocationIdx);
+}
+
+// <-
+
+void GpuMemoryManager::releaseOffset(GpuMemoryAllocationInfo& p_AllocationInfo)
+{
+  if (p_AllocationInfo._vkDeviceMemory == VK_NULL_HANDLE)
+  {
+    return;
+  }
+
+  _INTR_ASSERT(p_AllocationInfo._pageIdx <= 0xFFFFFFu);
+
+  // Everything needed to free the allocation is packed into the user data of
+  // the release entry
+  const uint64_t userData0 =
+      ((uint64_t)p_AllocationInfo._poolGeneration << 32u) |
+      ((uint64_t)p_AllocationInfo._memoryPoolType << 24u) |
+      p_AllocationInfo._pageIdx;
+  const uint64_t userData1 = p_AllocationInfo._allocationIdx;
+
+  RenderSystem::releaseResource(_N(GpuMemoryAllocation),
+                                (void*)(uintptr_t)userData0,
+                                (void*)(uintptr_t)userData1);
+
+  p_AllocationInfo = {};
+}
+
+// <-
+
+void GpuMemoryManager::freeReleasedOffset(void* p_UserData0,
+                                          void* p_UserData1)
+{
+  const uint64_t userData0 = (uint64_t)(uintptr_t)p_UserData0;
+
+  GpuMemoryAllocationInfo info = {};
+  info._poolGeneration = (uint32_t)(userData0 >> 32u);
+  info._memoryPoolType = (MemoryPoolType::Enum)((userData0 >> 24u) & 0xFFu);
+  info._pageIdx = (uint32_t)(userData0 & 0xFFFFFFu);
+  info._allocationIdx = (uint32_t)(uintptr_t)p_UserData1;
+  info._vkDeviceMemory =
+      _memoryPools[info._memoryPoolType][info._pageIdx]._vkDeviceMemory;
+
+  freeOffset(info);
+}
+
+// <-
+
+uint32_t GpuMemoryManager::selectPageForDefragmentation(
+    MemoryPoolType::Enum p_MemoryPoolType,
+    const _INTR_ARRAY(uint32_t) & p_MovableMemoryPerPageInBytes)
+{
+  const _INTR_ARRAY(GpuMemoryPage)& poolPages = _memoryPools[p_MemoryPoolType];
+
+  uint32_t selectedPageIdx = (uint32_t)-1;
+  uint32_t selectedUsedMemoryInBytes = 0u;
+  uint32_t totalAvailableMemoryInBytes = 0u;
+
+  for (uint32_t pageIdx = 0u; pageIdx < poolPages.size(); ++pageIdx)
+  {
+    const GpuMemoryPage& page = poolPages[pageIdx];
+    if (page._vkDeviceMemory == VK_NULL_HANDLE)
+    {
+      continue;
+    }
+
+    const uint32_t availableMemoryInBytes =
+        page._allocator.calcAvailableMemoryInBytes();
+    const uint32_t usedMemoryInBytes =
+        page._allocator.size() - availableMemoryInBytes;
+    totalAvailableMemoryInBytes += availableMemoryInBytes;
+
+    // Empty pages are released instead and pages without any movable
+    // allocations can't be evacuated at all
+    if (usedMemoryInBytes == 0u ||
+        pageIdx >= p_MovableMemoryPerPageInBytes.size() ||
+        p_MovableMemoryPerPageInBytes[pageIdx] == 0u ||
+        usedMemoryInBytes > _INTR_GPU_DEFRAGMENTATION_MAX_PAGE_USAGE *
+                                _INTR_GPU_PAGE_SIZE_IN_BYTES)
+    {
+      continue;
+    }
+
+    if (selectedPageIdx == (uint32_t)-1 ||
+        usedMemoryInBytes < selectedUsedMemoryInBytes)
+    {
+      selectedPageIdx = pageIdx;
+      selectedUsedMemoryInBytes = usedMemoryInBytes;
+    }
+  }
+
+  // Only worth it if the other pages can take the allocations
+  if (selectedPageIdx != (uint32_t)-1)
+  {
+    const uint32_t otherAvailableMemoryInBytes =
+        totalAvailableMemoryInBytes -
+        poolPages[selectedPageIdx]._allocator.calcAvailableMemoryInBytes();
+    if (otherAvailableMemoryInBytes < selectedUsedMemoryInBytes)
+    {
+      selectedPageIdx = (uint32_t)-1;
+    }
+  }
+
+  return selectedPageIdx;
+}
+
+// <-
+
+void GpuMemoryManager::releaseEmptyPages(MemoryPoolType::Enum p_MemoryPoolType)
+{
+  _INTR_ASSERT(p_MemoryPoolType >= MemoryPoolType::kRangeStartStatic &&
+               p_MemoryPoolType <= MemoryPoolType::kRangeEndStatic &&
+               "Pages of pools which are reset can't be released");
+
+  _INTR_ARRAY(GpuMemoryPage)& poolPages = _memoryPools[p_MemoryPoolType];
+
+  // Keep one page around to avoid allocating a new one right away
+  uint32_t activePageCount = 0u;
+  for (uint32_t pageIdx = 0u; pageIdx < poolPages.size(); ++pageIdx)
+  {
+    activePageCount +=
+        poolPages[pageIdx]._vkDeviceMemory != VK_NULL_HANDLE ? 1u : 0u;
+  }
+
+  for (uint32_t pageIdx = 0u;
+       pageIdx < poolPages.size() && activePageCount > 1u; ++pageIdx)
+  {
+    GpuMemoryPage& page = poolPages[pageIdx];
+
+    // Allocations are only freed once the GPU is done with them, so the memory
+    // of empty pages can be freed right away
+    if (page._vkDeviceMemory != VK_NULL_HANDLE &&
+        page._allocator.getAllocationCount() == 0u)
+    {
+      vkFreeMemory(RenderSystem::_vkDevice, page._vkDeviceMemory, nullptr);
+      page._vkDeviceMemory = VK_NULL_HANDLE;
+      page._mappedMemory = nullptr;
+      page._allocator.init(0u);
+      --activePageCount;
+    }
+  }
+}
+
+// <-
+
+void GpuMemoryManager::onAllocation(MemoryPoolType::Enum p_MemoryPoolType)
+{
+  GpuMemoryPoolStats& stats = _memoryPoolStats[p_MemoryPoolType];
+
+  ++stats.totalAllocationCount;
+  ++stats.currentFrameAllocationCount;
+
+  const uint32_t usedMemoryInBytes =
+      calcPoolSizeInBytes(p_MemoryPoolType) -
+      calcAvailablePoolMemoryInBytes(p_MemoryPoolType);
+  stats.peakUsedMemoryInBytes =
+      std::max(stats.peakUsedMemoryInBytes, usedMemoryInBytes);
+}
+
+// <-
+
+void GpuMemoryManager::compileMemoryStats(rapidjson::Value& p_Pools,
+                                          rapidjson::Document& p_Document)
+{
+  for (uint32_t memoryPoolType = 0u; memoryPoolType < MemoryPoolType::kCount;
+       ++memoryPoolType)
+  {
+    const MemoryPoolType::Enum poolType = (MemoryPoolType::Enum)memoryPoolType;
+    const GpuMemoryPoolStats& stats = _memoryPoolStats[poolType];
+    const uint32_t sizeInBytes = calcPoolSizeInBytes(poolType);
+
+    rapidjson::Value pool = rapidjson::Value(rapidjson::kObjectType);
+    pool.AddMember("name", rapidjson::StringRef(_memoryPoolNames[poolType]),
+                   p_Document.GetAllocator());
+    uint32_t pageCount = 0u;
+    uint32_t largestFreeBlockInBytes = 0u;
+    for (uint32_t pageIdx = 0u; pageIdx < _memoryPools[poolType].size();
+         ++pageIdx)
+    {
+      const GpuMemoryPage& page = _memoryPools[poolType][pageIdx];
+      if (page._vkDeviceMemory != VK_NULL_HANDLE)
+      {
+        ++pageCount;
+        largestFreeBlockInBytes =
+            std::max(largestFreeBlockInBytes,
+                     page._allocator.calcLargestFreeBlockInBytes());
+      }
+    }
+
+    pool.AddMember("pageCount", pageCount, p_Document.GetAllocator());
+    pool.AddMember("sizeInBytes", sizeInBytes, p_Document.GetAllocator());
+    pool.AddMember("usedBytes",
+                   sizeInBytes - calcAvailablePoolMemoryInBytes(poolType),
+                   p_Document.GetAllocator());
+    pool.AddMember("largestFreeBlockInBytes", largestFreeBlockInBytes,
+                   p_Document.GetAllocator());
+    pool.AddMember("peakUsedBytes", stats.peakUsedMemoryInBytes,
+                   p_Document.GetAllocator());
+    pool.AddMember("totalAllocationCount", stats.totalAllocationCount,
+                   p_Document.GetAllocator());
+    pool.AddMember("lastFrameAllocationCount", stats.lastFrameAllocationCount,
+                   p_Document.GetAllocator());
+    p_Pools.PushBack(pool, p_Document.GetAllocator());
+  }
+}
+
+// <-
+
 void GpuMemoryManager::updateMemoryStats()
 {
+  for (uint32_t memoryPoolType = 0u; memoryPoolType < MemoryPoolType::kCount;
+       ++memoryPoolType)
+  {
+    GpuMemoryPoolStats& stats = _memoryPoolStats[memoryPoolType];
+    stats.lastFrameAllocationCount = stats.currentFrameAllocationCount;
+    stats.currentFrameAllocationCount = 0u;
+  }
+
 #if defined(_INTR_PROFILING_ENABLED)
   static MicroProfileToken tokens[MemoryPoolType::kCount][2u];
   static bool init = false;
@@ -15,6 +15,10 @@
 #pragma once
 
 #define _INTR_GPU_PAGE_SIZE_IN_BYTES (80u * 1024u * 1024u)
+// Pages used less than this are evacuated by the defragmentation
+#define _INTR_GPU_DEFRAGMENTATION_MAX_PAGE_USAGE 0.5f
+// Max. amount of memory relocated per frame
+#define _INTR_GPU_DEFRAGMENTATION_BUDGET_IN_BYTES (4u * 1024u * 1024u)
 
 namespace Intrinsic
 {
@@ -22,23 +26,62 @@ namespace Renderer
 {
 struct GpuMemoryPage
 {
-  Core::Memory::LinearOffsetAllocator _allocator;
+  Core::Memory::TlsfOffsetAllocator _allocator;
+  // VK_NULL_HANDLE if the page has been released
   VkDeviceMemory _vkDeviceMemory;
   uint8_t* _mappedMemory;
   uint32_t _memoryTypeIdx;
 };
 
+struct GpuMemoryPoolStats
+{
+  uint32_t peakUsedMemoryInBytes;
+  uint32_t totalAllocationCount;
+  uint32_t lastFrameAllocationCount;
+  uint32_t currentFrameAllocationCount;
+};
+
 struct GpuMemoryManager
 {
   static void init();
   static void destroy();
   static void updateMemoryStats();
 
+  /**
+   * Adds the stats of all memory pools to the given JSON array.
+   */
+  static void compileMemoryStats(rapidjson::Value& p_Pools,
+                                 rapidjson::Document& p_Document);
+
   // <-
 
+  /**
+   * Allocates memory from the given pool. Allocations can be freed again
+   * individually or all at once by resetting the pool. Allocations are never
+   * placed in the given excluded page (used by the defragmentation).
+   */
   static GpuMemoryAllocationInfo
   allocateOffset(MemoryPoolType::Enum p_MemoryPoolType, uint32_t p_Size,
-                 uint32_t p_Alignment, uint32_t p_MemoryTypeFlags);
+                 uint32_t p_Alignment, uint32_t p_MemoryTypeFlags,
+                 uint32_t p_ExcludedPageIdx = (uint32_t)-1);
+
+  /**
+   * Frees the given allocation immediately. Only safe if the memory is not in
+   * use by the GPU anymore.
+   */
+  static void freeOffset(const GpuMemoryAllocationInfo& p_AllocationInfo);
+
+  /**
+   * Frees the given allocation as soon as all frames in flight have finished
+   * and resets the allocation info.
+   */
+  static void releaseOffset(GpuMemoryAllocationInfo& p_AllocationInfo);
+
+  /**
+   * Called by the render system for allocations queued by releaseOffset.
+   */
+  static void freeReleasedOffset(void* p_UserData0, void* p_UserData1);
+
   // <-
 
   _INTR_INLINE static void resetPool(MemoryPoolType::Enum p_MemoryPoolType)
@@ -48,10 +91,32 @@ struct GpuMemoryManager
     {
       _memoryPools[p_MemoryPoolType][pageIdx]._allocator.reset();
     }
+
+    // Invalidates all outstanding allocations of the pool
+    ++_poolGenerations[p_MemoryPoolType];
   }
 
   // <-
 
+  /**
+   * Returns the index of the page of the given pool which should be evacuated
+   * to reduce the fragmentation of the pool or (uint32_t)-1 if there is none.
+   * Moving all allocations of the returned page to the other pages of the pool
+   * allows releasing it. Only pages holding movable allocations, as given
+   * by the caller, are considered.
+   */
+  static uint32_t selectPageForDefragmentation(
+      MemoryPoolType::Enum p_MemoryPoolType,
+      const _INTR_ARRAY(uint32_t) & p_MovableMemoryPerPageInBytes);
+
+  /**
+   * Returns the device memory of all pages of the given pool which don't hold
+   * any allocations. Only allowed for pools which are never reset.
+   */
+  static void releaseEmptyPages(MemoryPoolType::Enum p_MemoryPoolType);
+
+  // <-
+
   _INTR_INLINE static uint32_t
   calcAvailablePoolMemoryInBytes(MemoryPoolType::Enum p_MemoryPoolType)
   {
@@ -79,8 +144,18 @@ struct GpuMemoryManager
     return totalSizeInBytes;
   }
 
+  _INTR_INLINE static const GpuMemoryPoolStats&
+  getPoolStats(MemoryPoolType::Enum p_MemoryPoolType)
+  {
+    return _memoryPoolStats[p_MemoryPoolType];
+  }
+
 private:
+  static void onAllocation(MemoryPoolType::Enum p_MemoryPoolType);
+
   static _INTR_ARRAY(GpuMemoryPage) _memoryPools[MemoryPoolType::kCount];
+  static GpuMemoryPoolStats _memoryPoolStats[MemoryPoolType::kCount];
+  static uint32_t _poolGenerations[MemoryPoolType::kCount];
 
   static MemoryLocation::Enum
       _memoryPoolToMemoryLocation[MemoryPoolType::kCount];
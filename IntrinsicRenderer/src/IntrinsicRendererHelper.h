@@ -572,6 +572,76 @@ _INTR_INLINE static void insertBufferMemoryBarrier(
 
 // <-
 
+/**
+ * Sorts the given copies by offset and merges the ones which overlap or are
+ * less than the given gap apart. Only valid for copies from a mirror of the
+ * destination buffer (matching source and destination offsets).
+ */
+_INTR_INLINE static void
+coalesceBufferCopies(_INTR_ARRAY(VkBufferCopy) & p_Copies,
+                     VkDeviceSize p_MaxGapInBytes)
+{
+  if (p_Copies.size() < 2u)
+  {
+    return;
+  }
+
+  std::sort(p_Copies.begin(), p_Copies.end(),
+            [](const VkBufferCopy& p_Left, const VkBufferCopy& p_Right) {
+              return p_Left.dstOffset < p_Right.dstOffset;
+            });
+
+  uint32_t copyCount = 1u;
+  for (uint32_t i = 1u; i < p_Copies.size(); ++i)
+  {
+    VkBufferCopy& lastCopy = p_Copies[copyCount - 1u];
+    const VkBufferCopy& copy = p_Copies[i];
+    _INTR_ASSERT(copy.srcOffset == copy.dstOffset);
+
+    const VkDeviceSize lastEnd = lastCopy.dstOffset + lastCopy.size;
+    if (copy.dstOffset <= lastEnd + p_MaxGapInBytes)
+    {
+      lastCopy.size =
+          std::max(lastEnd, copy.dstOffset + copy.size) - lastCopy.dstOffset;
+    }
+    else
+    {
+      p_Copies[copyCount++] = copy;
+    }
+  }
+
+  p_Copies.resize(copyCount);
+}
+
+// <-
+
+/**
+ * Records the given copies in a single command. The copies wait for all
+ * previous reads of the destination buffer and are made visible to the given
+ * accesses of subsequent commands.
+ */
+_INTR_INLINE static void
+insertBufferCopies(VkCommandBuffer p_CommandBuffer, VkBuffer p_SrcBuffer,
+                   VkBuffer p_DstBuffer, uint32_t p_DstSizeInBytes,
+                   const _INTR_ARRAY(VkBufferCopy) & p_Copies,
+                   VkAccessFlags p_DstAccessMask)
+{
+  insertBufferMemoryBarrier(p_CommandBuffer, p_DstBuffer, p_DstSizeInBytes, 0u,
+                            p_DstAccessMask, VK_ACCESS_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  vkCmdCopyBuffer(p_CommandBuffer, p_SrcBuffer, p_DstBuffer,
+                  (uint32_t)p_Copies.size(), p_Copies.data());
+
+  insertBufferMemoryBarrier(p_CommandBuffer, p_DstBuffer, p_DstSizeInBytes, 0u,
+                            VK_ACCESS_TRANSFER_WRITE_BIT, p_DstAccessMask,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+}
+
+// <-
+
 _INTR_INLINE static uint32_t computeGpuMemoryTypeIdx(uint32_t p_TypeBits,
                                                      VkFlags p_RequirementsMask)
 {
@@ -24,6 +24,8 @@ Resources::BufferRef MaterialBuffer::_materialBuffer;
 Resources::BufferRef MaterialBuffer::_materialStagingBuffer;
 
 _INTR_ARRAY(uint32_t) MaterialBuffer::_materialBufferEntries;
+_INTR_ARRAY(VkBufferCopy) MaterialBuffer::_dirtyMaterialBufferRanges;
+_INTR_ARRAY(VkBufferCopy) MaterialBuffer::_materialBufferCopies;
 
 void MaterialBuffer::init()
 {
@@ -54,7 +56,7 @@ void MaterialBuffer::init()
     BufferManager::_descMemoryPoolType(_materialStagingBuffer) =
         MemoryPoolType::kStaticStagingBuffers;
     BufferManager::_descSizeInBytes(_materialStagingBuffer) =
-        sizeof(MaterialBufferEntry);
+        sizeof(MaterialBufferEntry) * _INTR_MAX_MATERIAL_COUNT;
     buffersToCreate.push_back(_materialStagingBuffer);
   }
 
@@ -77,5 +79,43 @@ void MaterialBuffer::init()
   updateMaterialBufferEntry(0u, defaultMaterialBufferUnlit);
   updateMaterialBufferEntry(1u, defaultMaterialBufferLit);
 }
+// <-
+
+void MaterialBuffer::prepareMaterialBufferCopies()
+{
+  if (_dirtyMaterialBufferRanges.empty())
+  {
+    return;
+  }
+
+  _materialBufferCopies.insert(_materialBufferCopies.end(),
+                               _dirtyMaterialBufferRanges.begin(),
+                               _dirtyMaterialBufferRanges.end());
+  _dirtyMaterialBufferRanges.clear();
+
+  Helper::coalesceBufferCopies(_materialBufferCopies,
+                               sizeof(MaterialBufferEntry) * 4u);
+}
+
+// <-
+
+void MaterialBuffer::recordMaterialBufferCopies(
+    VkCommandBuffer p_CommandBuffer)
+{
+  if (_materialBufferCopies.empty())
+  {
+    return;
+  }
+
+  _INTR_PROFILE_CPU("Material Buffer", "Copy Material Buffer Entries");
+
+  Helper::insertBufferCopies(
+      p_CommandBuffer, BufferManager::_vkBuffer(_materialStagingBuffer),
+      BufferManager::_vkBuffer(_materialBuffer),
+      sizeof(MaterialBufferEntry) * _INTR_MAX_MATERIAL_COUNT,
+      _materialBufferCopies, VK_ACCESS_SHADER_READ_BIT);
+
+  _materialBufferCopies.clear();
+}
 }
 }
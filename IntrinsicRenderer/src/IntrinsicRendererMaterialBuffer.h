@@ -53,37 +53,48 @@ struct MaterialBuffer
     _materialBufferEntries.push_back(p_Index);
   }
 
+  /**
+   * Updates the host copy of the given entry. The changed entries are copied
+   * to the device in a single batch when the next frame begins.
+   */
   _INTR_INLINE static void
   updateMaterialBufferEntry(const uint32_t p_Index,
                             const MaterialBufferEntry& p_MaterialBufferEntry)
   {
-    // Update staging buffer
-    {
-      memcpy(BufferManager::getGpuMemory(_materialStagingBuffer),
-             &p_MaterialBufferEntry, sizeof(MaterialBufferEntry));
-    }
-
-    // ... and copy to device
-    VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
+    _INTR_ASSERT(p_Index < _INTR_MAX_MATERIAL_COUNT);
 
     VkBufferCopy bufferCopy = {};
     {
-      bufferCopy.dstOffset = p_Index * sizeof(MaterialBufferEntry);
-      bufferCopy.srcOffset = 0u;
+      bufferCopy.srcOffset = p_Index * sizeof(MaterialBufferEntry);
+      bufferCopy.dstOffset = bufferCopy.srcOffset;
       bufferCopy.size = sizeof(MaterialBufferEntry);
     }
 
-    vkCmdCopyBuffer(copyCmd, BufferManager::_vkBuffer(_materialStagingBuffer),
-                    BufferManager::_vkBuffer(_materialBuffer), 1u, &bufferCopy);
-
-    RenderSystem::flushTemporaryCommandBuffer();
+    memcpy(BufferManager::getGpuMemory(_materialStagingBuffer) +
+               bufferCopy.srcOffset,
+           &p_MaterialBufferEntry, sizeof(MaterialBufferEntry));
+    _dirtyMaterialBufferRanges.push_back(bufferCopy);
   }
 
+  /**
+   * Coalesces the entries changed since the last call into the copies of the
+   * next frame. Only safe to call while rendering is idle.
+   */
+  static void prepareMaterialBufferCopies();
+
+  /**
+   * Records the prepared material buffer copies.
+   */
+  static void recordMaterialBufferCopies(VkCommandBuffer p_CommandBuffer);
+
   static BufferRef _materialBuffer;
 
 private:
   static _INTR_ARRAY(uint32_t) _materialBufferEntries;
   static BufferRef _materialStagingBuffer;
+
+  static _INTR_ARRAY(VkBufferCopy) _dirtyMaterialBufferRanges;
+  static _INTR_ARRAY(VkBufferCopy) _materialBufferCopies;
 };
 }
 }
@@ -22,6 +22,8 @@
 #define _INTR_VK_PER_INSTANCE_BLOCK_SMALL_COUNT _INTR_MAX_DRAW_CALL_COUNT
 #define _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES 2048u
 #define _INTR_VK_PER_INSTANCE_BLOCK_LARGE_COUNT 256u
+#define _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES 16384u
+#define _INTR_VK_PER_INSTANCE_BLOCK_HUGE_COUNT 256u
 
 #define _INTR_VK_PER_FRAME_BLOCK_SIZE_IN_BYTES 512u
 #define _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES 256u
@@ -33,7 +35,10 @@
        _INTR_VK_PER_INSTANCE_BLOCK_SMALL_COUNT +                               \
    _INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT *                                   \
        _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES *                       \
-       _INTR_VK_PER_INSTANCE_BLOCK_LARGE_COUNT)
+       _INTR_VK_PER_INSTANCE_BLOCK_LARGE_COUNT +                               \
+   _INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT *                                   \
+       _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES *                        \
+       _INTR_VK_PER_INSTANCE_BLOCK_HUGE_COUNT)
 #define _INTR_VK_PER_MATERIAL_UNIFORM_MEMORY_IN_BYTES                          \
   (_INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES *                                 \
    _INTR_VK_PER_MATERIAL_BLOCK_COUNT)
@@ -119,7 +119,7 @@ _INTR_INLINE void dispatchAvgLum(VkCommandBuffer p_CommandBuffer)
       avgLumData.data.y = 0.0f;
     }
 
-    avgLumData.data.x = TaskManager::_lastDeltaT;
+    avgLumData.data.x = RenderProcess::Default::_renderPacket.deltaT;
   }
 
   ComputeCallManager::updateUniformMemory({_avgLumComputeCallRef}, &avgLumData,
@@ -384,21 +384,23 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
 {
   _INTR_PROFILE_CPU("Clustered", "Cull And Write Buffers");
 
+  const RenderProcess::RenderPacket& renderPacket =
+      RenderProcess::Default::_renderPacket;
+
   // TODO: Add frustum culling broad phase
   {
     _INTR_PROFILE_CPU("Clustered", "Write Buffers");
 
     _currentLightCount = 0u;
-    for (uint32_t i = 0u; i < Components::LightManager::_activeRefs.size(); ++i)
+    for (uint32_t i = 0u; i < renderPacket.lights.size(); ++i)
     {
-      Components::LightRef lightRef = Components::LightManager::_activeRefs[i];
-      Components::NodeRef lightNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::LightManager::_entity(lightRef));
+      Components::LightRef lightRef = renderPacket.lights[i];
+      Components::NodeRef lightNodeRef = renderPacket.lightNodes[i];
 
       const glm::vec3 lightPosVS =
           Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(lightNodeRef), 1.0);
+          glm::vec4(Components::NodeManager::_renderWorldPosition(lightNodeRef),
+                    1.0);
       _lightBufferMemory[_currentLightCount] = {
           glm::vec4(lightPosVS,
                     Components::LightManager::_descRadius(lightRef)),
@@ -409,20 +411,18 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
     }
 
     _currentDecalCount = 0u;
-    for (uint32_t i = 0u; i < Components::DecalManager::_activeRefs.size(); ++i)
+    for (uint32_t i = 0u; i < renderPacket.decals.size(); ++i)
     {
-      Components::DecalRef decalRef = Components::DecalManager::_activeRefs[i];
-      Components::NodeRef decalNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::DecalManager::_entity(decalRef));
+      Components::DecalRef decalRef = renderPacket.decals[i];
+      Components::NodeRef decalNodeRef = renderPacket.decalNodes[i];
 
       const glm::vec3 decalHalfExtent =
           Components::DecalManager::_descHalfExtent(decalRef) *
-          Components::NodeManager::_worldSize(decalNodeRef);
+          Components::NodeManager::_renderWorldSize(decalNodeRef);
       const glm::vec3 decalWorldPos =
-          Components::NodeManager::_worldPosition(decalNodeRef);
+          Components::NodeManager::_renderWorldPosition(decalNodeRef);
       const glm::quat decalWorldOrientation =
-          Components::NodeManager::_worldOrientation(decalNodeRef);
+          Components::NodeManager::_renderWorldOrientation(decalNodeRef);
 
       const glm::vec3 right =
           decalWorldOrientation * glm::vec3(decalHalfExtent.x, 0.0f, 0.0f);
@@ -488,24 +488,15 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
       ++_currentLightCount;
     }
 
-    // Sort probes by priority
-    // TODO: Could be done once if a priority changes
+    // Probes are sorted by priority when snapshotting the render packet
     _currentIrradProbeCount = 0u;
     _currentSpecProbeCount = 0u;
 
-    Components::IrradianceProbeManager::sortByPriority(
-        Components::IrradianceProbeManager::_activeRefs);
-    Components::SpecularProbeManager::sortByPriority(
-        Components::SpecularProbeManager::_activeRefs);
-
-    for (uint32_t i = 0u;
-         i < Components::IrradianceProbeManager::_activeRefs.size(); ++i)
+    for (uint32_t i = 0u; i < renderPacket.irradProbes.size(); ++i)
     {
       Components::IrradianceProbeRef irradProbeRef =
-          Components::IrradianceProbeManager::_activeRefs[i];
-      Components::NodeRef irradNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::IrradianceProbeManager::_entity(irradProbeRef));
+          renderPacket.irradProbes[i];
+      Components::NodeRef irradNodeRef = renderPacket.irradProbeNodes[i];
       const _INTR_ARRAY(Rendering::IBL::SH9)& shs =
           Components::IrradianceProbeManager::_descSHs(irradProbeRef);
 
@@ -516,7 +507,8 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
 
       const glm::vec3 irradProbePosVS =
           Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(irradNodeRef), 1.0);
+          glm::vec4(Components::NodeManager::_renderWorldPosition(irradNodeRef),
+                    1.0);
       _irradProbeBufferMemory[_currentIrradProbeCount].posAndRadiusVS =
           glm::vec4(
               irradProbePosVS,
@@ -531,14 +523,14 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
       Rendering::IBL::SH9 blendedSH;
       {
         const uint32_t leftIdx =
-            std::min((uint32_t)(World::_currentTime * shs.size()),
+            std::min((uint32_t)(renderPacket.currentTime * shs.size()),
                      (uint32_t)shs.size() - 1u);
 
         const float leftPerc = leftIdx / (float)shs.size();
         const float rightPerc = (leftIdx + 1u) / (float)shs.size();
 
         const float interp =
-            (World::_currentTime - leftPerc) / (rightPerc - leftPerc);
+            (renderPacket.currentTime - leftPerc) / (rightPerc - leftPerc);
 
         const Rendering::IBL::SH9& left = shs[leftIdx];
         const Rendering::IBL::SH9& right = shs[(leftIdx + 1u) % shs.size()];
@@ -551,15 +543,10 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
       ++_currentIrradProbeCount;
     }
 
-    for (uint32_t i = 0u;
-         i < Components::SpecularProbeManager::_activeRefs.size(); ++i)
+    for (uint32_t i = 0u; i < renderPacket.specProbes.size(); ++i)
     {
-      Components::SpecularProbeRef specProbeRef =
-          Components::SpecularProbeManager::_activeRefs[i];
-
-      Components::NodeRef specNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::SpecularProbeManager::_entity(specProbeRef));
+      Components::SpecularProbeRef specProbeRef = renderPacket.specProbes[i];
+      Components::NodeRef specNodeRef = renderPacket.specProbeNodes[i];
 
       SpecProbe& probe = _specProbeBufferMemory[_currentSpecProbeCount];
       _INTR_ARRAY(Name)& texNames =
@@ -574,7 +561,8 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
 
       const glm::vec3 specProbePosVS =
           Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(specNodeRef), 1.0);
+          glm::vec4(Components::NodeManager::_renderWorldPosition(specNodeRef),
+                    1.0);
       probe.posAndRadiusVS = glm::vec4(
           specProbePosVS,
           Components::SpecularProbeManager::_descRadius(specProbeRef));
@@ -584,11 +572,11 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
           (float)texNames.size(),
           *((float*)&Components::SpecularProbeManager::_flags(specProbeRef)));
       probe.minExtentWS = glm::vec4(
-          Components::NodeManager::_worldPosition(specNodeRef) +
+          Components::NodeManager::_renderWorldPosition(specNodeRef) +
               Components::SpecularProbeManager::_descMinExtent(specProbeRef),
           0.0f);
       probe.maxExtentWS = glm::vec4(
-          Components::NodeManager::_worldPosition(specNodeRef) +
+          Components::NodeManager::_renderWorldPosition(specNodeRef) +
               Components::SpecularProbeManager::_descMaxExtent(specProbeRef),
           0.0f);
 
@@ -608,7 +596,7 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
 
   // Find objects intersecting the depth slices and kick jobs for populated
   // ones
-  _INTR_ARRAY(uint32_t) _activeTaskSets;
+  _INTR_SCRATCH_ARRAY(uint32_t) _activeTaskSets;
   _activeTaskSets.reserve(GRID_DEPTH_SLICE_COUNT);
   {
     _INTR_PROFILE_CPU("Lighting", "Find Slice And Kick Jobs");
@@ -742,10 +730,12 @@ _INTR_INLINE void renderLighting(FramebufferRef p_FramebufferRef,
   // Update per instance data
   {
     // Post effect data
-    _lightingPerInstanceData.data0.x = TaskManager::_totalTimePassed;
+    _lightingPerInstanceData.data0.x =
+        RenderProcess::Default::_renderPacket.totalTimePassed;
     _lightingPerInstanceData.data0.y = Clustering::_globalIrradianceFactor;
     _lightingPerInstanceData.data0.z = Clustering::_globalSpecularFactor;
-    _lightingPerInstanceData.data0.w = World::_currentTime;
+    _lightingPerInstanceData.data0.w =
+        RenderProcess::Default::_renderPacket.currentTime;
 
     const _INTR_ARRAY(FrustumRef)& shadowFrustums =
         RenderProcess::Default::_shadowFrustums[p_CameraRef];
@@ -1428,6 +1418,9 @@ void spawnAndSimulateTestLights(Components::CameraRef p_CameraRef)
     }
   }
 
+  const float totalTimePassed =
+      RenderProcess::Default::_renderPacket.totalTimePassed;
+
   // Update position and lights
   for (uint32_t i = 0u; i < _testLights.size(); ++i)
   {
@@ -1435,7 +1428,7 @@ void spawnAndSimulateTestLights(Components::CameraRef p_CameraRef)
     const glm::vec3 worldPos = glm::vec3(
         light.spawnPos.x,
         light.spawnPos.y + 2000.0f * sin(light.spawnPos.x + light.spawnPos.y +
-                                         TaskManager::_totalTimePassed * 0.1f),
+                                         totalTimePassed * 0.1f),
         light.spawnPos.z);
 
     light.light.posAndRadiusVS = glm::vec4(
@@ -1453,7 +1446,8 @@ void Clustering::render(float p_DeltaT, Components::CameraRef p_CameraRef)
 
   // Testing code for profiling purposes
   {
-    Components::NodeRef rootNodeRef = World::_rootNode;
+    Components::NodeRef rootNodeRef =
+        RenderProcess::Default::_renderPacket.rootNode;
     Entity::EntityRef rootEntityRef =
         Components::NodeManager::_entity(rootNodeRef);
 
@@ -524,7 +524,7 @@ void Debug::render(float p_DeltaT, Components::CameraRef p_CameraRef)
   visibleMeshDrawCalls.clear();
   visibleDrawCalls.clear();
 
-  if (GameStates::Manager::getActiveGameState() !=
+  if (RenderProcess::Default::_renderPacket.gameState !=
       GameStates::GameState::kEditing)
   {
     return;
@@ -587,8 +587,9 @@ void Debug::render(float p_DeltaT, Components::CameraRef p_CameraRef)
         p_CameraRef, 0u,
         MaterialManager::getMaterialPassId(_N(GBufferWireframe)))
         .copy(visibleMeshDrawCalls);
-    // Update per mesh uniform data
-    CComponents::MeshManager::updateUniformData(visibleMeshDrawCalls);
+    // Update per mesh uniform data (without instancing since draw calls are
+    // filtered by entity below)
+    CComponents::MeshManager::updateUniformData(visibleMeshDrawCalls, false);
 
     if ((_activeDebugStageFlags & DebugStageFlags::kWireframeRendering) > 0u)
     {
@@ -619,6 +620,10 @@ void Debug::render(float p_DeltaT, Components::CameraRef p_CameraRef)
                                        _framebufferRef);
     _INTR_PROFILE_COUNTER_SET("Dispatched Draw Calls (Debug)",
                               DrawCallDispatcher::_dispatchedDrawCallCount);
+    _INTR_PROFILE_COUNTER_SET("Issued Binds (Debug)",
+                              DrawCallDispatcher::_issuedBindCount);
+    _INTR_PROFILE_COUNTER_SET("Skipped Binds (Debug)",
+                              DrawCallDispatcher::_skippedBindCount);
   }
   RenderSystem::endRenderPass(_renderPassRef);
 
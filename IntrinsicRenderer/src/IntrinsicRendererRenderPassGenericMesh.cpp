@@ -47,6 +47,20 @@ void GenericMesh::init(const rapidjson::Value& p_RenderPassDesc)
   {
     _INTR_ASSERT(false && "Unknown render order");
   }
+
+#if defined(_INTR_PROFILING_ENABLED)
+  // Generic mesh passes are data driven, so their counters are named at
+  // runtime
+  {
+    char charBuffer[128];
+    sprintf(charBuffer, "Dispatched Draw Calls (%s)", _name.c_str());
+    _dispatchedDrawCallCounter = MicroProfileGetCounterToken(charBuffer);
+    sprintf(charBuffer, "Issued Binds (%s)", _name.c_str());
+    _issuedBindCounter = MicroProfileGetCounterToken(charBuffer);
+    sprintf(charBuffer, "Skipped Binds (%s)", _name.c_str());
+    _skippedBindCounter = MicroProfileGetCounterToken(charBuffer);
+  }
+#endif // _INTR_PROFILING_ENABLED
 }
 
 // <-
@@ -98,7 +112,9 @@ void GenericMesh::render(float p_DeltaT, Components::CameraRef p_CameraRef)
 
   // Update per mesh uniform data
   {
-    CComponents::MeshManager::updateUniformData(visibleDrawCalls);
+    // Instancing would break the ordering of transparent draw calls
+    CComponents::MeshManager::updateUniformData(
+        visibleDrawCalls, _renderOrder != RenderOrder::kBackToFront);
   }
 
   VkCommandBuffer primaryCmdBuffer = RenderSystem::getPrimaryCommandBuffer();
@@ -111,6 +127,15 @@ void GenericMesh::render(float p_DeltaT, Components::CameraRef p_CameraRef)
       (uint32_t)_clearValues.size(), _clearValues.data());
   {
     DrawCallDispatcher::queueDrawCalls(visibleDrawCalls, _renderPassRef, fbRef);
+
+#if defined(_INTR_PROFILING_ENABLED)
+    MicroProfileCounterSet(_dispatchedDrawCallCounter,
+                           DrawCallDispatcher::_dispatchedDrawCallCount);
+    MicroProfileCounterSet(_issuedBindCounter,
+                           DrawCallDispatcher::_issuedBindCount);
+    MicroProfileCounterSet(_skippedBindCounter,
+                           DrawCallDispatcher::_skippedBindCount);
+#endif // _INTR_PROFILING_ENABLED
   }
   RenderSystem::endRenderPass(_renderPassRef);
 }
@@ -35,6 +35,13 @@ private:
   _INTR_ARRAY(_INTR_STRING) _materialPassNames;
   _INTR_ARRAY(uint8_t) _materialPassIds;
   RenderOrder::Enum _renderOrder;
+
+#if defined(_INTR_PROFILING_ENABLED)
+  // Per pass dispatch counters
+  MicroProfileToken _dispatchedDrawCallCounter;
+  MicroProfileToken _issuedBindCounter;
+  MicroProfileToken _skippedBindCounter;
+#endif // _INTR_PROFILING_ENABLED
 };
 }
 }
@@ -224,6 +224,10 @@ void PerPixelPicking::render(float p_DeltaT, Components::CameraRef p_CameraRef)
                                        _framebufferRef);
     _INTR_PROFILE_COUNTER_SET("Dispatched Draw Calls (Per Pixel Picking)",
                               DrawCallDispatcher::_dispatchedDrawCallCount);
+    _INTR_PROFILE_COUNTER_SET("Issued Binds (Per Pixel Picking)",
+                              DrawCallDispatcher::_issuedBindCount);
+    _INTR_PROFILE_COUNTER_SET("Skipped Binds (Per Pixel Picking)",
+                              DrawCallDispatcher::_skippedBindCount);
   }
   RenderSystem::endRenderPass(_renderPassRef);
 
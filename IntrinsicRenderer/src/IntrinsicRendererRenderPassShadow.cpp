@@ -52,8 +52,7 @@ _INTR_INLINE void calculateFrustumForSplit(uint32_t p_SplitIdx,
   const glm::vec3 worldBoundsCenter = Math::calcAABBCenter(worldBounds);
 
   glm::vec3 euler =
-      glm::eulerAngles(PostEffectManager::calcActualSunOrientation(
-          PostEffectManager::_blendTargetRef));
+      glm::eulerAngles(RenderProcess::Default::_renderPacket.sunOrientation);
   const glm::vec3 sunDir = glm::quat(euler) * glm::vec3(0.0f, 0.0f, 1.0f);
 
   const glm::vec3 eye = worldBoundsHalfExtentLength * sunDir;
@@ -258,6 +257,10 @@ void Shadow::render(float p_DeltaT, Components::CameraRef p_CameraRef)
 
   _INTR_PROFILE_COUNTER_SET("Dispatched Draw Calls (Shadows)",
                             DrawCallDispatcher::_dispatchedDrawCallCount);
+  _INTR_PROFILE_COUNTER_SET("Issued Binds (Shadows)",
+                            DrawCallDispatcher::_issuedBindCount);
+  _INTR_PROFILE_COUNTER_SET("Skipped Binds (Shadows)",
+                            DrawCallDispatcher::_skippedBindCount);
 
   const _INTR_ARRAY(FrustumRef)& shadowFrustums =
       RenderProcess::Default::_shadowFrustums[p_CameraRef];
@@ -312,6 +315,10 @@ void Shadow::render(float p_DeltaT, Components::CameraRef p_CameraRef)
                                          _framebufferRefs[shadowMapIdx]);
       _INTR_PROFILE_COUNTER_ADD("Dispatched Draw Calls (Shadows)",
                                 DrawCallDispatcher::_dispatchedDrawCallCount);
+      _INTR_PROFILE_COUNTER_ADD("Issued Binds (Shadows)",
+                                DrawCallDispatcher::_issuedBindCount);
+      _INTR_PROFILE_COUNTER_ADD("Skipped Binds (Shadows)",
+                                DrawCallDispatcher::_skippedBindCount);
     }
     RenderSystem::endRenderPass(_renderPassRef);
 
@@ -91,6 +91,8 @@ _INTR_INLINE void
 updatePerInstanceData(CameraRef p_CameraRef,
                       ComputeCallRef p_CurrentAccumComputeCallRef)
 {
+  const RenderProcess::RenderPacket& renderPacket =
+      RenderProcess::Default::_renderPacket;
   NodeRef camNodeRef =
       NodeManager::getComponentForEntity(CameraManager::_entity(p_CameraRef));
 
@@ -98,10 +100,11 @@ updatePerInstanceData(CameraRef p_CameraRef,
   {
     const glm::vec2 scattering =
         PostEffectManager::_descVolumetricLightingScatteringDayNight(
-            PostEffectManager::_blendTargetRef);
+            PostEffectManager::_renderTargetRef);
 
     _perInstanceData.data0.x =
-        glm::mix(scattering.y, scattering.x, World::_currentDayNightFactor) *
+        glm::mix(scattering.y, scattering.x,
+                 renderPacket.currentDayNightFactor) *
         VolumetricLighting::_globalScatteringFactor;
     _perInstanceData.data0.z = Clustering::_globalIrradianceFactor;
   }
@@ -113,8 +116,9 @@ updatePerInstanceData(CameraRef p_CameraRef,
   prevViewProjMatrix = CameraManager::_viewProjectionMatrix(p_CameraRef);
   _perInstanceData.projMatrix = CameraManager::_projectionMatrix(p_CameraRef);
 
-  _perInstanceData.camPos = glm::vec4(NodeManager::_worldPosition(camNodeRef),
-                                      TaskManager::_frameCounter);
+  _perInstanceData.camPos =
+      glm::vec4(NodeManager::_renderWorldPosition(camNodeRef),
+                renderPacket.frameCounter);
 
   _perInstanceData.eyeVSVectorX = glm::vec4(
       glm::vec3(1.0 / _perInstanceData.projMatrix[0][0], 0.0, 0.0), 0.0);
@@ -124,7 +128,7 @@ updatePerInstanceData(CameraRef p_CameraRef,
   _perInstanceData.eyeWSVectorX =
       CameraManager::_inverseViewMatrix(p_CameraRef) *
       _perInstanceData.eyeVSVectorX;
-  _perInstanceData.eyeWSVectorX.w = TaskManager::_totalTimePassed;
+  _perInstanceData.eyeWSVectorX.w = renderPacket.totalTimePassed;
   _perInstanceData.eyeWSVectorY =
       CameraManager::_inverseViewMatrix(p_CameraRef) *
       _perInstanceData.eyeVSVectorY;
@@ -777,7 +781,7 @@ void VolumetricLighting::render(float p_DeltaT, CameraRef p_CameraRef)
   blurExponentialShadowMaps(shadowMapCount);
 
   ComputeCallRef accumComputeCallRefToUse = _computeCallAccumRef;
-  if ((TaskManager::_frameCounter % 2u) != 0u)
+  if ((RenderProcess::Default::_renderPacket.frameCounter % 2u) != 0u)
   {
     accumComputeCallRefToUse = _computeCallAccumPrevFrameRef;
 
@@ -819,7 +823,7 @@ void VolumetricLighting::render(float p_DeltaT, CameraRef p_CameraRef)
   }
 
   ComputeCallRef scatteringComputeCalltoUse = _computeCallScatteringRef;
-  if ((TaskManager::_frameCounter % 2u) != 0u)
+  if ((RenderProcess::Default::_renderPacket.frameCounter % 2u) != 0u)
   {
     scatteringComputeCalltoUse = _computeCallScatteringPrevFrameRef;
 
@@ -119,7 +119,7 @@ _INTR_ARRAY(Components::CameraRef) _cameras;
 
 _INTR_INLINE void executeRenderSteps(float p_DeltaT)
 {
-  Components::CameraRef activeCamera = World::_activeCamera;
+  Components::CameraRef activeCamera = Default::_renderPacket.activeCamera;
   Components::CameraRef currentActiveCamera = Components::CameraRef();
 
   for (uint32_t i = 0u; i < _renderSteps.size(); ++i)
@@ -175,9 +175,73 @@ _INTR_INLINE void executeRenderSteps(float p_DeltaT)
     _INTR_ASSERT(false && "Failed to execute render step");
   }
 }
+
+// <-
+
+template <typename ManagerType>
+_INTR_INLINE void collectComponentsAndNodes(
+    _INTR_ARRAY(Dod::Ref) & p_Components,
+    _INTR_ARRAY(Components::NodeRef) & p_Nodes)
+{
+  p_Components = ManagerType::_activeRefs;
+
+  p_Nodes.resize(p_Components.size());
+  for (uint32_t i = 0u; i < p_Components.size(); ++i)
+  {
+    p_Nodes[i] = Components::NodeManager::getComponentForEntity(
+        ManagerType::_entity(p_Components[i]));
+  }
+}
+
+// <-
+
+_INTR_INLINE void snapshotRenderPacket(float p_DeltaT)
+{
+  _INTR_PROFILE_CPU("Render Process", "Snapshot Render Packet");
+
+  RenderPacket& packet = Default::_renderPacket;
+
+  packet.deltaT = p_DeltaT;
+  packet.totalTimePassed = TaskManager::_totalTimePassed;
+  packet.frameCounter = TaskManager::_frameCounter;
+  packet.gameState = GameStates::Manager::getActiveGameState();
+
+  packet.activeCamera = World::_activeCamera;
+  packet.rootNode = World::_rootNode;
+
+  packet.currentTime = World::_currentTime;
+  packet.currentDayNightFactor = World::_currentDayNightFactor;
+  packet.sunOrientation = PostEffectManager::calcActualSunOrientation(
+      PostEffectManager::_blendTargetRef);
+  packet.sunLightColorAndIntensity = World::_currentSunLightColorAndIntensity;
+
+  // Copy of the blended post effect parameters
+  PostEffectManager::blendPostEffect(PostEffectManager::_renderTargetRef,
+                                     PostEffectManager::_blendTargetRef,
+                                     PostEffectManager::_blendTargetRef, 0.0f);
+
+  Components::NodeManager::snapshotRenderState();
+
+  // Sort probes by priority
+  // TODO: Could be done once if a priority changes
+  Components::IrradianceProbeManager::sortByPriority(
+      Components::IrradianceProbeManager::_activeRefs);
+  Components::SpecularProbeManager::sortByPriority(
+      Components::SpecularProbeManager::_activeRefs);
+
+  collectComponentsAndNodes<Components::LightManager>(packet.lights,
+                                                      packet.lightNodes);
+  collectComponentsAndNodes<Components::DecalManager>(packet.decals,
+                                                      packet.decalNodes);
+  collectComponentsAndNodes<Components::IrradianceProbeManager>(
+      packet.irradProbes, packet.irradProbeNodes);
+  collectComponentsAndNodes<Components::SpecularProbeManager>(
+      packet.specProbes, packet.specProbeNodes);
+}
 }
 
 // Static members
+RenderPacket Default::_renderPacket;
 Dod::RefArray Default::_activeFrustums;
 
 _INTR_HASH_MAP(Components::CameraRef, _INTR_ARRAY(Dod::Ref))
@@ -185,10 +249,10 @@ Default::_shadowFrustums;
 _INTR_HASH_MAP(Components::CameraRef, uint8_t)
 Default::_cameraToIdMapping;
 
-Containers::LockFreeStack<Core::Dod::Ref, _INTR_MAX_DRAW_CALL_COUNT>
+Containers::LockFreeAppendArray<Core::Dod::Ref, _INTR_MAX_DRAW_CALL_COUNT>
     RenderProcess::Default::_visibleDrawCallsPerMaterialPass
         [_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT][_INTR_MAX_MATERIAL_PASS_COUNT];
-Containers::LockFreeStack<Dod::Ref, _INTR_MAX_MESH_COMPONENT_COUNT>
+Containers::LockFreeAppendArray<Dod::Ref, _INTR_MAX_MESH_COMPONENT_COUNT>
     RenderProcess::Default::_visibleMeshComponents
         [_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT];
 
@@ -355,73 +419,99 @@ void Default::loadRendererConfig()
   }
 }
 
-void Default::renderFrame(float p_DeltaT)
+void Default::prepareFrame(float p_DeltaT)
 {
+  _INTR_PROFILE_CPU("Render Process", "Prepare Frame");
+  _INTR_MEMORY_TAG(kRenderer);
+
   // Resize the swap chain (if necessary)
   RenderSystem::resizeSwapChain();
 
-  RenderSystem::beginFrame();
+  RenderSystem::releaseQueuedResources();
+  UploadManager::update();
+
+  // Return unused GPU memory and compact the static buffers. Rendering is idle
+  // at this point, so resources can be swapped safely. The buffer copies are
+  // recorded by the next frame
+  GpuMemoryManager::releaseEmptyPages(MemoryPoolType::kStaticImages);
+  GpuMemoryManager::releaseEmptyPages(MemoryPoolType::kStaticBuffers);
+  BufferManager::defragmentMemory(_INTR_GPU_DEFRAGMENTATION_BUDGET_IN_BYTES);
+
+  // Material updates of the last frame are copied by the next one
+  Renderer::UniformManager::preparePerMaterialDataCopies();
+  MaterialBuffer::prepareMaterialBufferCopies();
+
+  snapshotRenderPacket(p_DeltaT);
+
   {
-    _INTR_PROFILE_GPU("Render Frame");
-    _INTR_PROFILE_CPU("Render Process", "Render Frame");
+    _INTR_PROFILE_CPU("Render Process", "Culling");
 
-    // Preparation
+    // Update camera array
     {
-      _INTR_PROFILE_CPU("Render Process", "Culling");
-
-      // Update camera array
+      _cameras.clear();
+      if (!_cameraNames.empty())
       {
-        _cameras.clear();
-        if (!_cameraNames.empty())
+        for (uint32_t i = 0u; i < _cameraNames.size(); ++i)
         {
-          for (uint32_t i = 0u; i < _cameraNames.size(); ++i)
-          {
-            const Name& cameraName = _cameraNames[i];
+          const Name& cameraName = _cameraNames[i];
 
-            Components::CameraRef cam = World::_activeCamera;
-            if (cameraName != _N(ActiveCamera))
-              cam = Components::CameraManager::getComponentForEntity(
-                  Entity::EntityManager::getEntityByName(cameraName));
+          Components::CameraRef cam = _renderPacket.activeCamera;
+          if (cameraName != _N(ActiveCamera))
+            cam = Components::CameraManager::getComponentForEntity(
+                Entity::EntityManager::getEntityByName(cameraName));
 
-            _cameras.push_back(cam);
-          }
-        }
-        else
-        {
-          _cameras.push_back(World::_activeCamera);
+          _cameras.push_back(cam);
         }
       }
-
-      // Collect frustums for culling
-      _activeFrustums.clear();
-      for (uint32_t i = 0u; i < _cameras.size(); ++i)
+      else
       {
-        Components::CameraRef camRef = _cameras[i];
+        _cameras.push_back(_renderPacket.activeCamera);
+      }
+    }
 
-        FrustumRef frustumRef = Components::CameraManager::_frustum(camRef);
-        _cameraToIdMapping[camRef] = (uint8_t)_activeFrustums.size();
-        _activeFrustums.push_back(frustumRef);
+    // Collect frustums for culling
+    _activeFrustums.clear();
+    for (uint32_t i = 0u; i < _cameras.size(); ++i)
+    {
+      Components::CameraRef camRef = _cameras[i];
 
-        // Only allow shadows for the main view
-        if (_cameraNames[i] == _N(ActiveCamera))
-        {
-          _INTR_ARRAY(FrustumRef)& shadowFrustums = _shadowFrustums[camRef];
-          RenderPass::Shadow::prepareFrustums(camRef, shadowFrustums);
-          _activeFrustums.insert(RenderProcess::Default::_activeFrustums.end(),
-                                 shadowFrustums.begin(), shadowFrustums.end());
-        }
+      FrustumRef frustumRef = Components::CameraManager::_frustum(camRef);
+      _cameraToIdMapping[camRef] = (uint8_t)_activeFrustums.size();
+      _activeFrustums.push_back(frustumRef);
+
+      // Only allow shadows for the main view
+      if (_cameraNames[i] == _N(ActiveCamera))
+      {
+        _INTR_ARRAY(FrustumRef)& shadowFrustums = _shadowFrustums[camRef];
+        RenderPass::Shadow::prepareFrustums(camRef, shadowFrustums);
+        _activeFrustums.insert(RenderProcess::Default::_activeFrustums.end(),
+                               shadowFrustums.begin(), shadowFrustums.end());
       }
+    }
 
-      Components::CameraManager::updateFrustumsAndMatrices(
-          Components::CameraManager::_activeRefs);
-      FrustumManager::prepareForRendering(FrustumManager::_activeRefs);
+    Components::CameraManager::updateFrustumsAndMatrices(
+        Components::CameraManager::_activeRefs);
+    FrustumManager::prepareForRendering(FrustumManager::_activeRefs);
 
-      FrustumManager::cullNodes(RenderProcess::Default::_activeFrustums);
+    FrustumManager::cullNodes(RenderProcess::Default::_activeFrustums);
 
-      // Collect visible draw calls and mesh components
-      Components::MeshManager::collectDrawCallsAndMeshComponents();
-      UniformManager::resetAllocator();
-    }
+    // Collect visible draw calls and mesh components
+    Components::MeshManager::collectDrawCallsAndMeshComponents();
+  }
+}
+
+// <-
+
+void Default::renderFrame(float p_DeltaT)
+{
+  _INTR_MEMORY_TAG(kRenderer);
+
+  RenderSystem::beginFrame();
+  {
+    _INTR_PROFILE_GPU("Render Frame");
+    _INTR_PROFILE_CPU("Render Process", "Render Frame");
+
+    UniformManager::resetAllocator();
 
     // Execute render steps
     {
@@ -20,42 +20,88 @@ namespace Renderer
 {
 namespace RenderProcess
 {
+/**
+ * The render relevant simulation state of a single frame. Snapshotted at the
+ * sync point between simulation and rendering so the render steps never read
+ * state the simulation of the next frame is writing to.
+ */
+struct RenderPacket
+{
+  float deltaT;
+  float totalTimePassed;
+  uint32_t frameCounter;
+  GameStates::GameState::Enum gameState;
+
+  Components::CameraRef activeCamera;
+  Components::NodeRef rootNode;
+
+  float currentTime;
+  float currentDayNightFactor;
+  glm::quat sunOrientation;
+  glm::vec4 sunLightColorAndIntensity;
+
+  // Active components and their Nodes
+  _INTR_ARRAY(Components::LightRef) lights;
+  _INTR_ARRAY(Components::NodeRef) lightNodes;
+  _INTR_ARRAY(Components::DecalRef) decals;
+  _INTR_ARRAY(Components::NodeRef) decalNodes;
+  _INTR_ARRAY(Components::IrradianceProbeRef) irradProbes;
+  _INTR_ARRAY(Components::NodeRef) irradProbeNodes;
+  _INTR_ARRAY(Components::SpecularProbeRef) specProbes;
+  _INTR_ARRAY(Components::NodeRef) specProbeNodes;
+};
+
 struct Default
 {
   static void loadRendererConfig();
+
+  /**
+   * Snapshots the render packet, culls and collects the visible draw calls.
+   * Has to be called from the main thread while no frame is being rendered.
+   */
+  static void prepareFrame(float p_DeltaT);
+
+  /**
+   * Records and submits the frame prepared by the last call to prepareFrame.
+   * Only reads the render packet and can run concurrently to the simulation
+   * of the next frame.
+   */
   static void renderFrame(float p_DeltaT);
 
   // Static members
   // ->
 
+  static RenderPacket _renderPacket;
+
   static Core::Dod::RefArray _activeFrustums;
   static _INTR_HASH_MAP(Components::CameraRef,
                         _INTR_ARRAY(Dod::Ref)) _shadowFrustums;
   static _INTR_HASH_MAP(CResources::FrustumRef, uint8_t) _cameraToIdMapping;
 
-  static _INTR_INLINE const
-      Containers::LockFreeStack<Core::Dod::Ref, _INTR_MAX_DRAW_CALL_COUNT>&
-      getVisibleDrawCalls(Components::CameraRef p_CameraRef,
-                          uint32_t p_FrustumIdx, uint32_t p_MaterialPassIdx)
+  static _INTR_INLINE const Containers::LockFreeAppendArray<
+      Core::Dod::Ref, _INTR_MAX_DRAW_CALL_COUNT>&
+  getVisibleDrawCalls(Components::CameraRef p_CameraRef, uint32_t p_FrustumIdx,
+                      uint32_t p_MaterialPassIdx)
   {
     return _visibleDrawCallsPerMaterialPass[_cameraToIdMapping[p_CameraRef] +
                                             p_FrustumIdx][p_MaterialPassIdx];
   }
 
-  static _INTR_INLINE const
-      Containers::LockFreeStack<Core::Dod::Ref, _INTR_MAX_MESH_COMPONENT_COUNT>&
-      getVisibleMeshComponents(Components::CameraRef p_CameraRef,
-                               uint32_t p_FrustumIdx)
+  static _INTR_INLINE const Containers::LockFreeAppendArray<
+      Core::Dod::Ref, _INTR_MAX_MESH_COMPONENT_COUNT>&
+  getVisibleMeshComponents(Components::CameraRef p_CameraRef,
+                           uint32_t p_FrustumIdx)
   {
     return _visibleMeshComponents[_cameraToIdMapping[p_CameraRef] +
                                   p_FrustumIdx];
   }
 
-  static Containers::LockFreeStack<Core::Dod::Ref, _INTR_MAX_DRAW_CALL_COUNT>
+  static Containers::LockFreeAppendArray<Core::Dod::Ref,
+                                         _INTR_MAX_DRAW_CALL_COUNT>
       _visibleDrawCallsPerMaterialPass[_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT]
                                       [_INTR_MAX_MATERIAL_PASS_COUNT];
-  static Containers::LockFreeStack<Core::Dod::Ref,
-                                   _INTR_MAX_MESH_COMPONENT_COUNT>
+  static Containers::LockFreeAppendArray<Core::Dod::Ref,
+                                         _INTR_MAX_MESH_COMPONENT_COUNT>
       _visibleMeshComponents[_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT];
 
   // <-
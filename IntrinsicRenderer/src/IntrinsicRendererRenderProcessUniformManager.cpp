@@ -194,18 +194,20 @@ void UniformManager::updatePerFrameUniformBufferData(Dod::Ref p_Camera)
 {
   _INTR_PROFILE_CPU("General", "Update Per Frame Uniform Buffer Data");
 
+  const RenderPacket& renderPacket = Default::_renderPacket;
+
   // Uniforms for the render passes
   {
     UniformManager::_uniformDataSource.postParams0.x =
         RenderPass::Clustering::_globalIrradianceFactor;
     UniformManager::_uniformDataSource.postParams0.y =
-        World::_currentDayNightFactor;
+        renderPacket.currentDayNightFactor;
     UniformManager::_uniformDataSource.postParams0.z =
         PostEffectManager::_descDoFStartDistance(
-            PostEffectManager::_blendTargetRef);
+            PostEffectManager::_renderTargetRef);
     UniformManager::_uniformDataSource.postParams0.w =
         PostEffectManager::_descCloudShadowsIntensity(
-            PostEffectManager::_blendTargetRef);
+            PostEffectManager::_renderTargetRef);
 
     UniformManager::_uniformDataSource.cameraParameters.x =
         Components::CameraManager::_descNearPlane(p_Camera);
@@ -232,20 +234,21 @@ void UniformManager::updatePerFrameUniformBufferData(Dod::Ref p_Camera)
         Components::NodeManager::getComponentForEntity(
             Components::CameraManager::_entity(p_Camera));
     UniformManager::_uniformDataSource.cameraWorldPosition =
-        glm::vec4(Components::NodeManager::_worldPosition(cameraNode), 0.0f);
+        glm::vec4(Components::NodeManager::_renderWorldPosition(cameraNode),
+                  0.0f);
 
     UniformManager::_uniformDataSource.haltonSamples = glm::vec4(
-        _haltonSamples[TaskManager::_frameCounter % _INTR_HALTON_SAMPLE_COUNT]
+        _haltonSamples[renderPacket.frameCounter % _INTR_HALTON_SAMPLE_COUNT]
             .x,
-        _haltonSamples[TaskManager::_frameCounter % _INTR_HALTON_SAMPLE_COUNT]
+        _haltonSamples[renderPacket.frameCounter % _INTR_HALTON_SAMPLE_COUNT]
             .y,
-        _haltonSamples[TaskManager::_frameCounter % _INTR_HALTON_SAMPLE_COUNT]
+        _haltonSamples[renderPacket.frameCounter % _INTR_HALTON_SAMPLE_COUNT]
             .z,
         0.0f);
     UniformManager::_uniformDataSource.haltonSamples32 =
-        glm::vec4(_haltonSamples[TaskManager::_frameCounter % 32].x,
-                  _haltonSamples[TaskManager::_frameCounter % 32].y,
-                  _haltonSamples[TaskManager::_frameCounter % 32].z, 0.0f);
+        glm::vec4(_haltonSamples[renderPacket.frameCounter % 32].x,
+                  _haltonSamples[renderPacket.frameCounter % 32].y,
+                  _haltonSamples[renderPacket.frameCounter % 32].z, 0.0f);
 
     glm::vec2 backbufferSize = glm::vec2(RenderSystem::_backbufferDimensions);
     UniformManager::_uniformDataSource.backbufferSize =
@@ -290,18 +293,17 @@ void UniformManager::updatePerFrameUniformBufferData(Dod::Ref p_Camera)
           UniformManager::_uniformDataSource.inverseViewMatrix;
 
       // Sky
-      const glm::vec3 sunDir = PostEffectManager::calcActualSunOrientation(
-                                   PostEffectManager::_blendTargetRef) *
-                               glm::vec3(0.0f, 0.0f, 1.0f);
+      const glm::vec3 sunDir =
+          renderPacket.sunOrientation * glm::vec3(0.0f, 0.0f, 1.0f);
       fragmentData.sunLightDirWS = glm::vec4(sunDir, 0.0f);
       fragmentData.sunLightDirVS =
           UniformManager::_uniformDataSource.viewMatrix *
           fragmentData.sunLightDirWS;
       fragmentData.sunLightColorAndIntensity =
-          World::_currentSunLightColorAndIntensity;
+          renderPacket.sunLightColorAndIntensity;
       fragmentData.sunLightColorAndIntensity.w *=
           PostEffectManager::_descSunIntensity(
-              PostEffectManager::_blendTargetRef);
+              PostEffectManager::_renderTargetRef);
 
       const float elevation =
           glm::half_pi<float>() -
@@ -312,13 +314,13 @@ void UniformManager::updatePerFrameUniformBufferData(Dod::Ref p_Camera)
       Rendering::SkyModel::ArHosekSkyModelState skyModel =
           Rendering::SkyModel::createSkyModelStateRGB(
               PostEffectManager::_descSkyTurbidity(
-                  PostEffectManager::_blendTargetRef),
+                  PostEffectManager::_renderTargetRef),
               PostEffectManager::_descSkyAlbedo(
-                  PostEffectManager::_blendTargetRef),
+                  PostEffectManager::_renderTargetRef),
               elevation);
-      const float radianceFactor = World::_currentDayNightFactor *
+      const float radianceFactor = renderPacket.currentDayNightFactor *
                                    PostEffectManager::_descSkyLightIntensity(
-                                       PostEffectManager::_blendTargetRef);
+                                       PostEffectManager::_renderTargetRef);
       skyModel.radiances[0] *= radianceFactor;
       skyModel.radiances[1] *= radianceFactor;
       skyModel.radiances[2] *= radianceFactor;
@@ -45,6 +45,28 @@ _INTR_STRING getPipelineCacheFilePath()
 {
   return "media/pipeline_caches/" + getPipelineCacheUUID() + ".pc";
 }
+
+// <-
+
+bool isPipelineCacheDataCompatible(const _INTR_ARRAY(uint8_t) & p_Data)
+{
+  // Header layout: length, version, vendor ID, device ID and cache UUID
+  const uint32_t headerSizeInBytes = 4u * sizeof(uint32_t) + VK_UUID_SIZE;
+  if (p_Data.size() < headerSizeInBytes)
+  {
+    return false;
+  }
+
+  uint32_t header[4];
+  memcpy(header, p_Data.data(), sizeof(header));
+
+  return header[0] >= headerSizeInBytes &&
+         header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header[2] == _vkPhysicalDeviceProps.vendorID &&
+         header[3] == _vkPhysicalDeviceProps.deviceID &&
+         memcmp(p_Data.data() + sizeof(header),
+                _vkPhysicalDeviceProps.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
 }
 
 // Public static members
@@ -65,8 +87,11 @@ glm::uvec2 RenderSystem::_backbufferDimensions = glm::uvec2(0u, 0u);
 glm::uvec2 RenderSystem::_customBackbufferDimensions = glm::uvec2(0u, 0u);
 
 VkQueue RenderSystem::_vkQueue = nullptr;
+VkQueue RenderSystem::_vkTransferQueue = nullptr;
+std::mutex RenderSystem::_vkQueueMutex;
 
 uint32_t RenderSystem::_vkGraphicsAndComputeQueueFamilyIndex = (uint32_t)-1;
+uint32_t RenderSystem::_vkTransferQueueFamilyIndex = (uint32_t)-1;
 
 // <-
 
@@ -95,6 +120,7 @@ _INTR_ARRAY(ResourceReleaseEntry) RenderSystem::_resourcesToFree;
 void RenderSystem::init(void* p_PlatformHandle, void* p_PlatformWindow)
 {
   _INTR_PROFILE_AUTO("Initializes Vulkan Render System");
+  _INTR_MEMORY_TAG(kRenderer);
 
   _INTR_LOG_INFO("Inititializing Vulkan Render System...");
   _INTR_LOG_PUSH();
@@ -119,6 +145,7 @@ void RenderSystem::init(void* p_PlatformHandle, void* p_PlatformWindow)
 
   {
     GpuMemoryManager::init();
+    UploadManager::init();
     Samplers::init();
     initManagers();
   }
@@ -189,12 +216,24 @@ void RenderSystem::init(void* p_PlatformHandle, void* p_PlatformWindow)
   MaterialManager::loadMaterialPassConfig();
   MaterialManager::createAllResources();
 
+  // Persist the pipelines created during startup right away, so the next
+  // start is prewarmed even if this session does not shut down cleanly
+  savePipelineCache();
+
   _INTR_LOG_POP();
 }
 
 // <-
 
 void RenderSystem::shutdown()
+{
+  UploadManager::waitForUploads();
+  savePipelineCache();
+}
+
+// <-
+
+void RenderSystem::savePipelineCache()
 {
   _INTR_ARRAY(uint8_t) pipelineData;
 
@@ -260,6 +299,11 @@ void RenderSystem::releaseQueuedResources()
         vkDestroyPipeline(RenderSystem::_vkDevice, (VkPipeline)entry.userData0,
                           nullptr);
       }
+      else if (entry.typeName == _N(GpuMemoryAllocation))
+      {
+        GpuMemoryManager::freeReleasedOffset(entry.userData0,
+                                             entry.userData1);
+      }
       else
       {
         _INTR_ASSERT(false);
@@ -382,12 +426,12 @@ void RenderSystem::dispatchDrawCall(Dod::Ref p_DrawCall,
           DrawCallManager::_indexBufferOffset(p_DrawCall), indexType);
       vkCmdDrawIndexed(
           p_CommandBuffer, DrawCallManager::_descIndexCount(p_DrawCall),
-          DrawCallManager::_descInstanceCount(p_DrawCall), 0u, 0u, 0u);
+          DrawCallManager::_instanceCount(p_DrawCall), 0u, 0u, 0u);
     }
     else
     {
       vkCmdDraw(p_CommandBuffer, DrawCallManager::_descVertexCount(p_DrawCall),
-                DrawCallManager::_descInstanceCount(p_DrawCall), 0u, 0u);
+                DrawCallManager::_instanceCount(p_DrawCall), 0u, 0u);
     }
   }
 }
@@ -665,16 +709,41 @@ void RenderSystem::initVkDevice()
 
     _INTR_ASSERT(_vkGraphicsAndComputeQueueFamilyIndex != (uint32_t)-1 &&
                  "Unable to locate a matching queue");
+
+    // Prefer a dedicated transfer queue (usually backed by a DMA engine) for
+    // uploads and fall back to the graphics queue if there is none
+    _vkTransferQueueFamilyIndex = _vkGraphicsAndComputeQueueFamilyIndex;
+    for (uint32_t queueIdx = 0; queueIdx < queueCount; queueIdx++)
+    {
+      const VkQueueFlags queueFlags = queueProps[queueIdx].queueFlags;
+      if ((queueFlags & VK_QUEUE_TRANSFER_BIT) > 0u &&
+          (queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0u &&
+          (queueFlags & VK_QUEUE_COMPUTE_BIT) == 0u)
+      {
+        _INTR_LOG_INFO("Using queue #%u for transfers...", queueIdx);
+        _vkTransferQueueFamilyIndex = queueIdx;
+        break;
+      }
+    }
   }
 
-  // Setup device queue
+  // Setup device queues
   const float queuePriorities[1] = {0.0f};
-  VkDeviceQueueCreateInfo queueCreateInfo = {};
+  VkDeviceQueueCreateInfo queueCreateInfos[2] = {};
+  uint32_t queueCreateInfoCount = 1u;
   {
-    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = _vkGraphicsAndComputeQueueFamilyIndex;
-    queueCreateInfo.queueCount = 1u;
-    queueCreateInfo.pQueuePriorities = queuePriorities;
+    queueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueCreateInfos[0].queueFamilyIndex =
+        _vkGraphicsAndComputeQueueFamilyIndex;
+    queueCreateInfos[0].queueCount = 1u;
+    queueCreateInfos[0].pQueuePriorities = queuePriorities;
+
+    if (_vkTransferQueueFamilyIndex != _vkGraphicsAndComputeQueueFamilyIndex)
+    {
+      queueCreateInfos[1] = queueCreateInfos[0];
+      queueCreateInfos[1].queueFamilyIndex = _vkTransferQueueFamilyIndex;
+      ++queueCreateInfoCount;
+    }
   }
 
   // Check if debug marker extension is supported
@@ -717,8 +786,8 @@ void RenderSystem::initVkDevice()
   {
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceCreateInfo.pNext = nullptr;
-    deviceCreateInfo.queueCreateInfoCount = 1u;
-    deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+    deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
+    deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
     deviceCreateInfo.pEnabledFeatures = &_vkPhysicalDeviceFeatures;
 
     if (enabledExtensions.size() > 0)
@@ -739,9 +808,11 @@ void RenderSystem::initVkDevice()
     _INTR_VK_CHECK_RESULT(result);
   }
 
-  // Retrieve device queue
+  // Retrieve device queues
   vkGetDeviceQueue(_vkDevice, _vkGraphicsAndComputeQueueFamilyIndex, 0u,
                    &_vkQueue);
+  vkGetDeviceQueue(_vkDevice, _vkTransferQueueFamilyIndex, 0u,
+                   &_vkTransferQueue);
 
   // Enable debug markers (if available)
   if (debugMarkerExtPresent)
@@ -1075,6 +1146,23 @@ void RenderSystem::initVkPipelineCache()
 
   ifs.close();
 
+  // The persisted cache prewarms all pipelines created later on, but only if
+  // it has been written by the same device and driver
+  if (!pipelineCacheData.empty())
+  {
+    if (isPipelineCacheDataCompatible(pipelineCacheData))
+    {
+      const uint32_t sizeInBytes = (uint32_t)pipelineCacheData.size();
+      _INTR_LOG_INFO("Prewarming pipeline cache with %.2f MB of data...",
+                     Math::bytesToMegaBytes(sizeInBytes));
+    }
+    else
+    {
+      _INTR_LOG_WARNING("Pipeline cache is incompatible, discarding it...");
+      pipelineCacheData.clear();
+    }
+  }
+
   VkPipelineCacheCreateInfo pipelineCache = {};
   {
     pipelineCache.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
@@ -1287,7 +1375,11 @@ void RenderSystem::resizeSwapChain(bool p_Force)
        _timePassedSinceLastSwapChainUpdate >= _timeBetweenSwapChainUpdates) ||
       p_Force)
   {
-    vkDeviceWaitIdle(_vkDevice);
+    {
+      // Waiting for the device requires access to all of its queues
+      std::lock_guard<std::mutex> lock(_vkQueueMutex);
+      vkDeviceWaitIdle(_vkDevice);
+    }
 
     initOrUpdateVkSwapChain();
     reinitRendering();
@@ -1336,10 +1428,6 @@ void RenderSystem::beginFrame()
 {
   _INTR_PROFILE_CPU("Render System", "Begin Frame");
 
-  {
-    releaseQueuedResources();
-  }
-
   {
     _INTR_PROFILE_CPU("Render System", "Acquire Next Image");
 
@@ -1358,6 +1446,11 @@ void RenderSystem::beginFrame()
   {
     _allocatedSecondaryCmdBufferCount = 0u;
     beginPrimaryCommandBuffer();
+    UploadManager::acquireUploads(getPrimaryCommandBuffer(),
+                                  _backbufferIndex);
+    BufferManager::recordBufferMoves(getPrimaryCommandBuffer());
+    UniformManager::recordPerMaterialDataCopies(getPrimaryCommandBuffer());
+    MaterialBuffer::recordMaterialBufferCopies(getPrimaryCommandBuffer());
 
 #if defined(_INTR_PROFILING_ENABLED)
     MicroProfileFlip(getPrimaryCommandBuffer());
@@ -1377,8 +1470,9 @@ void RenderSystem::endFrame()
   _INTR_PROFILE_CPU("Render System", "End Frame");
 
   {
-    // Wait for any remaining tasks
-    Application::_scheduler.WaitforAll();
+    // Task sets spawned while recording are waited for by their owners. Not
+    // waiting for all tasks here since the simulation of the next frame might
+    // be running concurrently
 
     // Insert pre-present barrier and end primary command buffer
     insertPrePresentBarrier();
@@ -1388,20 +1482,27 @@ void RenderSystem::endFrame()
   {
     _INTR_PROFILE_CPU("Render System", "Queue Submit");
 
-    VkPipelineStageFlags pipeStageFlags = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    // Wait for the swapchain image and the uploads acquired in this frame
+    _INTR_ARRAY(VkSemaphore) waitSemaphores = {_vkImageAcquiredSemaphore};
+    _INTR_ARRAY(VkPipelineStageFlags)
+    waitStages = {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+    UploadManager::appendWaitSemaphores(_backbufferIndex, waitSemaphores,
+                                        waitStages);
+
     VkSubmitInfo submitInfo = {};
     {
       submitInfo.pNext = nullptr;
       submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-      submitInfo.waitSemaphoreCount = 1u;
-      submitInfo.pWaitSemaphores = &_vkImageAcquiredSemaphore;
-      submitInfo.pWaitDstStageMask = &pipeStageFlags;
+      submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+      submitInfo.pWaitSemaphores = waitSemaphores.data();
+      submitInfo.pWaitDstStageMask = waitStages.data();
       submitInfo.commandBufferCount = 1u;
       submitInfo.pCommandBuffers = &_vkCommandBuffers[_backbufferIndex];
       submitInfo.signalSemaphoreCount = 0u;
       submitInfo.pSignalSemaphores = nullptr;
     }
 
+    std::lock_guard<std::mutex> lock(_vkQueueMutex);
     VkResult result = vkQueueSubmit(_vkQueue, 1u, &submitInfo,
                                     _vkDrawFences[_backbufferIndex]);
     _INTR_VK_CHECK_RESULT(result);
@@ -1424,6 +1525,7 @@ void RenderSystem::endFrame()
       present.pResults = nullptr;
     }
 
+    std::lock_guard<std::mutex> lock(_vkQueueMutex);
     VkResult result = vkQueuePresentKHR(_vkQueue, &present);
     _INTR_VK_CHECK_RESULT(result);
   }
@@ -27,6 +27,7 @@ struct RenderSystem
 
   static void beginFrame();
   static void endFrame();
+  static void releaseQueuedResources();
 
   // <-
 
@@ -163,6 +164,11 @@ struct RenderSystem
     VkResult result = vkBeginCommandBuffer(_vkTempCommandBuffer, &cmdBufInfo);
     _INTR_VK_CHECK_RESULT(result);
 
+    // The previous submit of the temporary command buffer has been waited for
+    // in flushTemporaryCommandBuffer()
+    UploadManager::acquireUploads(_vkTempCommandBuffer,
+                                  _INTR_UPLOAD_TEMPORARY_FRAME_IDX);
+
     return _vkTempCommandBuffer;
   }
 
@@ -172,20 +178,34 @@ struct RenderSystem
   {
     vkEndCommandBuffer(_vkTempCommandBuffer);
 
+    // Wait for the transfer queue to release the uploads acquired in
+    // beginTemporaryCommandBuffer()
+    _INTR_ARRAY(VkSemaphore) waitSemaphores;
+    _INTR_ARRAY(VkPipelineStageFlags) waitStages;
+    UploadManager::appendWaitSemaphores(_INTR_UPLOAD_TEMPORARY_FRAME_IDX,
+                                        waitSemaphores, waitStages);
+
     VkSubmitInfo submitInfo = {};
     {
       submitInfo.pNext = nullptr;
       submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+      submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+      submitInfo.pWaitSemaphores = waitSemaphores.data();
+      submitInfo.pWaitDstStageMask = waitStages.data();
       submitInfo.commandBufferCount = 1u;
       submitInfo.pCommandBuffers = &_vkTempCommandBuffer;
     }
 
-    VkResult result = vkQueueSubmit(RenderSystem::_vkQueue, 1, &submitInfo,
-                                    _vkTempCommandBufferFence);
-    _INTR_VK_CHECK_RESULT(result);
+    {
+      std::lock_guard<std::mutex> lock(_vkQueueMutex);
+      VkResult result = vkQueueSubmit(RenderSystem::_vkQueue, 1, &submitInfo,
+                                      _vkTempCommandBufferFence);
+      _INTR_VK_CHECK_RESULT(result);
+    }
 
-    result = vkWaitForFences(RenderSystem::_vkDevice, 1u,
-                             &_vkTempCommandBufferFence, VK_TRUE, UINT64_MAX);
+    VkResult result =
+        vkWaitForFences(RenderSystem::_vkDevice, 1u,
+                        &_vkTempCommandBufferFence, VK_TRUE, UINT64_MAX);
     _INTR_VK_CHECK_RESULT(result);
 
     result =
@@ -296,8 +316,15 @@ struct RenderSystem
   static glm::uvec2 _customBackbufferDimensions;
 
   static VkQueue _vkQueue;
+  // Equals the graphics queue if there is no dedicated transfer queue
+  static VkQueue _vkTransferQueue;
+  // Guards all submits and presents to the queues above. The frame is
+  // submitted by the render task while the main thread might already be
+  // submitting uploads or temporary command buffers
+  static std::mutex _vkQueueMutex;
 
   static uint32_t _vkGraphicsAndComputeQueueFamilyIndex;
+  static uint32_t _vkTransferQueueFamilyIndex;
 
   // <-
 
@@ -317,6 +344,7 @@ private:
   static void initVkSurface(void* p_PlatformHandle, void* p_PlatformWindow);
   static void initOrUpdateVkSwapChain();
   static void initVkPipelineCache();
+  static void savePipelineCache();
   static void initVkCommandPools();
   static void initVkCommandBuffers();
   static void initVkTempCommandBuffer();
@@ -385,7 +413,6 @@ private:
 
   // <-
 
-  static void releaseQueuedResources();
   static void reinitRendering();
 
   // <-
@@ -21,30 +21,59 @@ namespace Renderer
 {
 namespace Resources
 {
-void BufferManager::createResources(const BufferRefArray& p_Buffers)
+// Static members
+_INTR_ARRAY(BufferMove) BufferManager::_pendingBufferMoves;
+
+// <-
+
+namespace
+{
+_INTR_INLINE void fillBufferCreateInfo(BufferRef p_Ref,
+                                       VkBufferCreateInfo& p_CreateInfo)
+{
+  p_CreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  p_CreateInfo.pNext = nullptr;
+  p_CreateInfo.usage = Helper::mapBufferTypeToVkUsageFlagBits(
+                           BufferManager::_descBufferType(p_Ref)) |
+                       VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  p_CreateInfo.size = BufferManager::_descSizeInBytes(p_Ref);
+  p_CreateInfo.queueFamilyIndexCount = 0;
+  p_CreateInfo.pQueueFamilyIndices = nullptr;
+  p_CreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  p_CreateInfo.flags = 0u;
+}
+
+// <-
+
+_INTR_INLINE bool isMovable(BufferRef p_Ref)
 {
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
+  const GpuMemoryAllocationInfo& memoryAllocationInfo =
+      BufferManager::_memoryAllocationInfo(p_Ref);
+  const BufferType::Enum bufferType = BufferManager::_descBufferType(p_Ref);
+
+  // Uniform and storage buffers are referenced by descriptor sets which
+  // would have to be rewritten
+  return BufferManager::_vkBuffer(p_Ref) != VK_NULL_HANDLE &&
+         memoryAllocationInfo._vkDeviceMemory != VK_NULL_HANDLE &&
+         memoryAllocationInfo._memoryPoolType ==
+             MemoryPoolType::kStaticBuffers &&
+         (bufferType == BufferType::kVertex ||
+          bufferType == BufferType::kIndex16 ||
+          bufferType == BufferType::kIndex32);
+}
+}
 
-  _INTR_ARRAY(VkBuffer) stagingBuffersToDestroy;
-  stagingBuffersToDestroy.reserve(p_Buffers.size());
+// <-
 
+void BufferManager::createResources(const BufferRefArray& p_Buffers)
+{
   for (uint32_t i = 0u; i < p_Buffers.size(); ++i)
   {
     BufferRef bufferRef = p_Buffers[i];
 
     VkBufferCreateInfo bufferCreateInfo = {};
-    {
-      bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-      bufferCreateInfo.pNext = nullptr;
-      bufferCreateInfo.usage =
-          Helper::mapBufferTypeToVkUsageFlagBits(_descBufferType(bufferRef)) |
-          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-      bufferCreateInfo.size = _descSizeInBytes(bufferRef);
-      bufferCreateInfo.queueFamilyIndexCount = 0;
-      bufferCreateInfo.pQueueFamilyIndices = nullptr;
-      bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-      bufferCreateInfo.flags = 0u;
-    }
+    fillBufferCreateInfo(bufferRef, bufferCreateInfo);
 
     VkBuffer& buffer = _vkBuffer(bufferRef);
     _INTR_ASSERT(buffer == VK_NULL_HANDLE);
@@ -60,26 +89,13 @@ void BufferManager::createResources(const BufferRefArray& p_Buffers)
     GpuMemoryAllocationInfo& memoryAllocationInfo =
         _memoryAllocationInfo(bufferRef);
 
-    bool needsAlloc = true;
-
-    // Try to keep memory for static buffers
-    if (memoryPoolType >= MemoryPoolType::kRangeStartStatic &&
-        memoryPoolType <= MemoryPoolType::kRangeEndStatic)
-    {
-      if (memoryAllocationInfo._memoryPoolType == memoryPoolType &&
-          memReqs.size <= memoryAllocationInfo._sizeInBytes &&
-          memReqs.alignment == memoryAllocationInfo._alignmentInBytes)
-      {
-        needsAlloc = false;
-      }
-    }
+    // Memory is returned when the resources get destroyed, this only catches
+    // buffers recreated without destroying them first
+    GpuMemoryManager::releaseOffset(memoryAllocationInfo);
 
-    if (needsAlloc)
-    {
-      memoryAllocationInfo = GpuMemoryManager::allocateOffset(
-          memoryPoolType, (uint32_t)memReqs.size, (uint32_t)memReqs.alignment,
-          memReqs.memoryTypeBits);
-    }
+    memoryAllocationInfo = GpuMemoryManager::allocateOffset(
+        memoryPoolType, (uint32_t)memReqs.size, (uint32_t)memReqs.alignment,
+        memReqs.memoryTypeBits);
 
     result = vkBindBufferMemory(RenderSystem::_vkDevice, buffer,
                                 memoryAllocationInfo._vkDeviceMemory,
@@ -89,58 +105,148 @@ void BufferManager::createResources(const BufferRefArray& p_Buffers)
     void* initialData = _descInitialData(bufferRef);
     if (initialData)
     {
-      VkBufferCreateInfo stagingBufferCreateInfo = bufferCreateInfo;
+      UploadManager::uploadBuffer(buffer, initialData,
+                                  _descSizeInBytes(bufferRef));
+    }
+  }
+
+  UploadManager::submit();
+}
+
+// <-
+
+void BufferManager::defragmentMemory(uint32_t p_MaxSizeInBytes)
+{
+  _INTR_PROFILE_CPU("Buffer Manager", "Defragment Memory");
+
+  _INTR_ARRAY(uint32_t) movableMemoryPerPageInBytes;
+  for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+  {
+    BufferRef bufferRef = _activeRefs[i];
+    if (isMovable(bufferRef))
+    {
+      const GpuMemoryAllocationInfo& memoryAllocationInfo =
+          _memoryAllocationInfo(bufferRef);
+      if (memoryAllocationInfo._pageIdx >= movableMemoryPerPageInBytes.size())
       {
-        stagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        movableMemoryPerPageInBytes.resize(memoryAllocationInfo._pageIdx + 1u);
       }
+      movableMemoryPerPageInBytes[memoryAllocationInfo._pageIdx] +=
+          memoryAllocationInfo._sizeInBytes;
+    }
+  }
+
+  const uint32_t pageIdx = GpuMemoryManager::selectPageForDefragmentation(
+      MemoryPoolType::kStaticBuffers, movableMemoryPerPageInBytes);
+  if (pageIdx == (uint32_t)-1)
+  {
+    return;
+  }
+
+  uint32_t movedSizeInBytes = 0u;
+
+  for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+  {
+    BufferRef bufferRef = _activeRefs[i];
+    GpuMemoryAllocationInfo& memoryAllocationInfo =
+        _memoryAllocationInfo(bufferRef);
 
-      VkBuffer stagingBuffer;
-      result = vkCreateBuffer(RenderSystem::_vkDevice, &stagingBufferCreateInfo,
-                              nullptr, &stagingBuffer);
-      _INTR_VK_CHECK_RESULT(result);
+    if (!isMovable(bufferRef) || memoryAllocationInfo._pageIdx != pageIdx)
+    {
+      continue;
+    }
 
-      VkMemoryRequirements stagingMemReqs;
-      vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                    &stagingMemReqs);
+    if (movedSizeInBytes > 0u &&
+        movedSizeInBytes + memoryAllocationInfo._sizeInBytes > p_MaxSizeInBytes)
+    {
+      break;
+    }
 
-      const GpuMemoryAllocationInfo stagingGpuAllocInfo =
-          GpuMemoryManager::allocateOffset(
-              MemoryPoolType::kVolatileStagingBuffers,
-              (uint32_t)stagingMemReqs.size, (uint32_t)stagingMemReqs.alignment,
-              stagingMemReqs.memoryTypeBits);
+    VkBufferCreateInfo bufferCreateInfo = {};
+    fillBufferCreateInfo(bufferRef, bufferCreateInfo);
 
-      result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                                  stagingGpuAllocInfo._vkDeviceMemory,
-                                  stagingGpuAllocInfo._offset);
-      _INTR_VK_CHECK_RESULT(result);
+    VkBuffer buffer;
+    VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
+                                     nullptr, &buffer);
+    _INTR_VK_CHECK_RESULT(result);
 
-      // Copy initial data to staging memory
-      {
-        memcpy(stagingGpuAllocInfo._mappedMemory, initialData,
-               _descSizeInBytes(bufferRef));
-      }
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, buffer, &memReqs);
 
-      VkBufferCopy bufferCopy = {};
-      {
-        bufferCopy.dstOffset = 0u;
-        bufferCopy.srcOffset = 0u;
-        bufferCopy.size = _descSizeInBytes(bufferRef);
-      }
+    const GpuMemoryAllocationInfo newMemoryAllocationInfo =
+        GpuMemoryManager::allocateOffset(
+            MemoryPoolType::kStaticBuffers, (uint32_t)memReqs.size,
+            (uint32_t)memReqs.alignment, memReqs.memoryTypeBits, pageIdx);
+
+    result = vkBindBufferMemory(RenderSystem::_vkDevice, buffer,
+                                newMemoryAllocationInfo._vkDeviceMemory,
+                                newMemoryAllocationInfo._offset);
+    _INTR_VK_CHECK_RESULT(result);
 
-      // Finally copy from the staging buffer to the actual buffer
-      vkCmdCopyBuffer(copyCmd, stagingBuffer, buffer, 1u, &bufferCopy);
+    // The copy is recorded by the next frame. Frames in flight keep using the
+    // old buffer and memory, both are only released once they are done
+    BufferMove bufferMove = {};
+    {
+      bufferMove.srcBuffer = _vkBuffer(bufferRef);
+      bufferMove.dstBuffer = buffer;
+      bufferMove.sizeInBytes = _descSizeInBytes(bufferRef);
     }
+    _pendingBufferMoves.push_back(bufferMove);
+
+    RenderSystem::releaseResource(_N(VkBuffer), (void*)_vkBuffer(bufferRef),
+                                  nullptr);
+    GpuMemoryManager::releaseOffset(memoryAllocationInfo);
+
+    _vkBuffer(bufferRef) = buffer;
+    memoryAllocationInfo = newMemoryAllocationInfo;
+
+    movedSizeInBytes += memoryAllocationInfo._sizeInBytes;
   }
 
-  RenderSystem::flushTemporaryCommandBuffer();
+  if (movedSizeInBytes > 0u)
+  {
+    DrawCallManager::updateVertexBuffers(DrawCallManager::_activeRefs);
+  }
+}
 
-  for (uint32_t i = 0u; i < stagingBuffersToDestroy.size(); ++i)
+// <-
+
+void BufferManager::recordBufferMoves(VkCommandBuffer p_CommandBuffer)
+{
+  if (_pendingBufferMoves.empty())
   {
-    vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffersToDestroy[i],
-                    nullptr);
+    return;
   }
 
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
+  _INTR_PROFILE_CPU("Buffer Manager", "Record Buffer Moves");
+
+  for (uint32_t i = 0u; i < _pendingBufferMoves.size(); ++i)
+  {
+    const BufferMove& bufferMove = _pendingBufferMoves[i];
+
+    VkBufferCopy bufferCopy = {};
+    {
+      bufferCopy.dstOffset = 0u;
+      bufferCopy.srcOffset = 0u;
+      bufferCopy.size = bufferMove.sizeInBytes;
+    }
+    vkCmdCopyBuffer(p_CommandBuffer, bufferMove.srcBuffer,
+                    bufferMove.dstBuffer, 1u, &bufferCopy);
+  }
+  _pendingBufferMoves.clear();
+
+  // Make the moved vertex and index data visible to the draw calls following
+  VkMemoryBarrier memoryBarrier = {};
+  {
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.pNext = nullptr;
+    memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memoryBarrier.dstAccessMask =
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+  }
+  vkCmdPipelineBarrier(p_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0u, 1u,
+                       &memoryBarrier, 0u, nullptr, 0u, nullptr);
 }
 }
 }
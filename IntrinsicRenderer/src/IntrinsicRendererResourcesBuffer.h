@@ -24,6 +24,14 @@ namespace Resources
 typedef Dod::Ref BufferRef;
 typedef _INTR_ARRAY(BufferRef) BufferRefArray;
 
+// Buffer moved to new memory by the defragmentation
+struct BufferMove
+{
+  VkBuffer srcBuffer;
+  VkBuffer dstBuffer;
+  uint32_t sizeInBytes;
+};
+
 struct BufferData : Dod::Resources::ResourceDataBase
 {
   BufferData() : Dod::Resources::ResourceDataBase(_INTR_MAX_BUFFER_COUNT)
@@ -142,6 +150,20 @@ struct BufferManager
 
   static void createResources(const BufferRefArray& p_Buffers);
 
+  /**
+   * Moves vertex and index buffers out of a sparsely used page of the static
+   * buffer pool so the page can be released once it is empty. At most the
+   * given amount of memory is copied per call. The copies are recorded by
+   * the next frame via recordBufferMoves.
+   */
+  static void defragmentMemory(uint32_t p_MaxSizeInBytes);
+
+  /**
+   * Records the copies of the buffers moved by defragmentMemory. Has to be
+   * called before the first draw call of the frame.
+   */
+  static void recordBufferMoves(VkCommandBuffer p_CommandBuffer);
+
   // <-
 
   _INTR_INLINE static void destroyResources(const BufferRefArray& p_Buffers)
@@ -156,6 +178,7 @@ struct BufferManager
         RenderSystem::releaseResource(_N(VkBuffer), (void*)buffer, nullptr);
         buffer = VK_NULL_HANDLE;
       }
+      GpuMemoryManager::releaseOffset(_memoryAllocationInfo(ref));
     }
   }
 
@@ -223,6 +246,8 @@ struct BufferManager
   {
     return _data.memoryAllocationInfo[p_Ref._id];
   }
+
+  static _INTR_ARRAY(BufferMove) _pendingBufferMoves;
 };
 }
 }
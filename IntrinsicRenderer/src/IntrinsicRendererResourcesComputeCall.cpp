@@ -37,7 +37,7 @@ void ComputeCallManager::createResources(
     _INTR_ASSERT(descSet == VK_NULL_HANDLE);
 
     // Allocate and init. descriptor set
-    descSet = Resources::PipelineLayoutManager::allocateAndWriteDescriptorSet(
+    descSet = Resources::PipelineLayoutManager::acquireDescriptorSet(
         pipelineLayout, bindInfs);
 
     _INTR_ARRAY(BindingInfo)& bindInfos = _descBindInfos(computeCallRef);
@@ -151,12 +151,7 @@ struct ComputeCallManager
 
       if (vkDescSet != VK_NULL_HANDLE)
       {
-        VkDescriptorPool vkDescPool =
-            PipelineLayoutManager::_vkDescriptorPool(pipelineLayout);
-        _INTR_ASSERT(vkDescPool != VK_NULL_HANDLE);
-
-        RenderSystem::releaseResource(_N(VkDescriptorSet), (void*)vkDescSet,
-                                      (void*)vkDescPool);
+        PipelineLayoutManager::releaseDescriptorSet(pipelineLayout, vkDescSet);
         vkDescSet = VK_NULL_HANDLE;
       }
 
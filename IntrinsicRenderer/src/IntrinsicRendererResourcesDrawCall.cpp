@@ -45,11 +45,12 @@ void DrawCallManager::createResources(const DrawCallRefArray& p_DrawCalls)
     VkDescriptorSet& descSet = _vkDescriptorSet(drawCallRef);
     _INTR_ASSERT(descSet == VK_NULL_HANDLE);
 
-    descSet = Resources::PipelineLayoutManager::allocateAndWriteDescriptorSet(
+    descSet = Resources::PipelineLayoutManager::acquireDescriptorSet(
         pipelineLayout, bindInfos);
 
     // Defaults for now
     _indexBufferOffset(drawCallRef) = 0ull;
+    _instanceCount(drawCallRef) = 1u;
     _vertexBufferOffsets(drawCallRef).resize(descVtxBuffers.size());
     _vertexBuffers(drawCallRef).resize(descVtxBuffers.size());
 
@@ -83,6 +84,24 @@ void DrawCallManager::createResources(const DrawCallRefArray& p_DrawCalls)
 
 // <-
 
+void DrawCallManager::updateVertexBuffers(const DrawCallRefArray& p_DrawCalls)
+{
+  for (uint32_t dcIdx = 0u; dcIdx < p_DrawCalls.size(); ++dcIdx)
+  {
+    DrawCallRef drawCallRef = p_DrawCalls[dcIdx];
+
+    _INTR_ARRAY(BufferRef)& descVtxBuffers = _descVertexBuffers(drawCallRef);
+    _INTR_ARRAY(VkBuffer)& vtxBuffers = _vertexBuffers(drawCallRef);
+
+    for (uint32_t i = 0u; i < vtxBuffers.size(); ++i)
+    {
+      vtxBuffers[i] = BufferManager::_vkBuffer(descVtxBuffers[i]);
+    }
+  }
+}
+
+// <-
+
 void DrawCallManager::bindImage(DrawCallRef p_DrawCallRef, const Name& p_Name,
                                 uint8_t p_ShaderStage, Dod::Ref p_ImageRef,
                                 uint8_t p_SamplerIdx, uint8_t p_BindingFlags,
@@ -175,8 +194,18 @@ void DrawCallManager::bindBuffer(DrawCallRef p_DrawCallRef, const Name& p_Name,
 DrawCallRef DrawCallManager::createDrawCallForMesh(
     const Name& p_Name, Dod::Ref p_Mesh, Dod::Ref p_Material,
     uint8_t p_MaterialPass, uint32_t p_PerInstanceDataVertexSize,
-    uint32_t p_PerInstanceDataFragmentSize, uint32_t p_SubMeshIdx)
+    uint32_t p_PerInstanceDataFragmentSize, uint32_t p_SubMeshIdx,
+    uint32_t p_MaxInstanceCount)
 {
+  _INTR_ASSERT(p_MaxInstanceCount > 0u &&
+               p_MaxInstanceCount <= _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL);
+  // The huge blocks are placed last in the per instance buffer, so ranges
+  // exceeding the allocated memory stay inside of the buffer
+  _INTR_ASSERT(std::max(p_PerInstanceDataVertexSize,
+                        p_PerInstanceDataFragmentSize) *
+                   _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL <=
+               _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES);
+
   if (!p_Mesh.isValid())
   {
     return Dod::Ref();
@@ -205,6 +234,7 @@ DrawCallRef DrawCallManager::createDrawCallForMesh(
             .size();
     _descMaterial(drawCallMesh) = p_Material;
     _descMaterialPass(drawCallMesh) = p_MaterialPass;
+    _descInstanceCount(drawCallMesh) = p_MaxInstanceCount;
 
     MaterialPass::BoundResources& boundResources =
         MaterialManager::_materialPassBoundResources
@@ -253,9 +283,10 @@ DrawCallRef DrawCallManager::createDrawCallForMesh(
               entry.shaderStage == GpuProgramType::kFragment
                   ? UboType::kPerInstanceFragment
                   : UboType::kPerInstanceVertex,
-              entry.shaderStage == GpuProgramType::kFragment
-                  ? p_PerInstanceDataFragmentSize
-                  : p_PerInstanceDataVertexSize);
+              (entry.shaderStage == GpuProgramType::kFragment
+                   ? p_PerInstanceDataFragmentSize
+                   : p_PerInstanceDataVertexSize) *
+                  _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL);
         }
         else if (entry.resourceName == _N(PerFrame))
         {
@@ -46,6 +46,7 @@ struct DrawCallData : Dod::Resources::ResourceDataBase
     vertexBufferOffsets.resize(_INTR_MAX_DRAW_CALL_COUNT);
     indexBufferOffset.resize(_INTR_MAX_DRAW_CALL_COUNT);
     sortingHash.resize(_INTR_MAX_DRAW_CALL_COUNT);
+    instanceCount.resize(_INTR_MAX_DRAW_CALL_COUNT);
   }
 
   // Description
@@ -68,6 +69,7 @@ struct DrawCallData : Dod::Resources::ResourceDataBase
   _INTR_ARRAY(_INTR_ARRAY(VkBuffer)) vertexBuffers;
   _INTR_ARRAY(VkDeviceSize) indexBufferOffset;
   _INTR_ARRAY(uint32_t) sortingHash;
+  _INTR_ARRAY(uint32_t) instanceCount;
 };
 
 struct DrawCallManager
@@ -100,6 +102,13 @@ struct DrawCallManager
         sizeof(RenderProcess::PerFrameDataVertex) +
         sizeof(RenderProcess::PerFrameDataFrament);
 
+    // The per instance bindings always cover the full per instance arrays of
+    // the shaders, so only allocate the memory required for the current
+    // instance count. The remainder of the range overlaps the following
+    // blocks which is fine since it is never read
+    _INTR_ASSERT(_instanceCount(p_DrawCall) <= _descInstanceCount(p_DrawCall));
+    const uint32_t instanceCount = _instanceCount(p_DrawCall);
+
     uint32_t dynamicOffsetIndex = 0u;
     for (uint32_t bIdx = 0u; bIdx < bindInfos.size(); ++bIdx)
     {
@@ -110,13 +119,15 @@ struct DrawCallManager
         if (bindInfo.bufferData.uboType == UboType::kPerInstanceVertex)
         {
           UniformManager::allocatePerInstanceDataMemory(
-              bindInfo.bufferData.rangeInBytes,
+              bindInfo.bufferData.rangeInBytes /
+                  _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL * instanceCount,
               _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex]);
         }
         else if (bindInfo.bufferData.uboType == UboType::kPerInstanceFragment)
         {
           UniformManager::allocatePerInstanceDataMemory(
-              bindInfo.bufferData.rangeInBytes,
+              bindInfo.bufferData.rangeInBytes /
+                  _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL * instanceCount,
               _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex]);
         }
         else if (bindInfo.bufferData.uboType == UboType::kPerMaterialVertex)
@@ -166,9 +177,11 @@ struct DrawCallManager
   updateUniformMemory(DrawCallRef p_DrawCall, void* p_PerInstanceDataVertex,
                       uint32_t p_PerInstanceDataVertexSize,
                       void* p_PerInstanceDataFragment,
-                      uint32_t p_PerInstanceDataFragmentSize)
+                      uint32_t p_PerInstanceDataFragmentSize,
+                      uint32_t p_InstanceIdx = 0u)
   {
     _INTR_ARRAY(BindingInfo)& bindInfos = _descBindInfos(p_DrawCall);
+    _INTR_ASSERT(p_InstanceIdx < _instanceCount(p_DrawCall));
 
     uint32_t dynamicOffsetIndex = 0u;
     for (uint32_t bIdx = 0u; bIdx < bindInfos.size(); ++bIdx)
@@ -182,12 +195,15 @@ struct DrawCallManager
 
         if (bindInfo.bufferData.uboType == UboType::kPerInstanceVertex)
         {
-          uint8_t* gpuMem = &UniformManager::_perInstanceMemory[dynamicOffset];
+          uint8_t* gpuMem =
+              &UniformManager::_perInstanceMemory
+                  [dynamicOffset + p_InstanceIdx * p_PerInstanceDataVertexSize];
           memcpy(gpuMem, p_PerInstanceDataVertex, p_PerInstanceDataVertexSize);
         }
         else if (bindInfo.bufferData.uboType == UboType::kPerInstanceFragment)
         {
-          uint8_t* gpuMem = &UniformManager::_perInstanceMemory[dynamicOffset];
+          uint8_t* gpuMem = &UniformManager::_perInstanceMemory
+              [dynamicOffset + p_InstanceIdx * p_PerInstanceDataFragmentSize];
           memcpy(gpuMem, p_PerInstanceDataFragment,
                  p_PerInstanceDataFragmentSize);
         }
@@ -240,10 +256,17 @@ struct DrawCallManager
 
   // <-
 
+  /**
+   * Creates a draw call for the given sub mesh which can draw up to
+   * p_MaxInstanceCount instances. The per instance bindings always span
+   * _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL elements to match the per instance
+   * arrays declared in the shaders.
+   */
   static DrawCallRef createDrawCallForMesh(
       const Name& p_Name, Dod::Ref p_Mesh, Dod::Ref p_Material,
       uint8_t p_MaterialPass, uint32_t p_PerInstanceDataVertexSize,
-      uint32_t p_PerInstanceDataFragmentSize, uint32_t p_SubMeshIdx = 0u);
+      uint32_t p_PerInstanceDataFragmentSize, uint32_t p_SubMeshIdx = 0u,
+      uint32_t p_MaxInstanceCount = 1u);
 
   // <-
 
@@ -318,6 +341,12 @@ struct DrawCallManager
 
   static void createResources(const DrawCallRefArray& p_DrawCalls);
 
+  /**
+   * Refreshes the cached vertex buffer handles of the given draw calls, e.g.
+   * after the buffers have been relocated.
+   */
+  static void updateVertexBuffers(const DrawCallRefArray& p_DrawCalls);
+
   // <-
 
   _INTR_INLINE static void destroyResources(const DrawCallRefArray& p_DrawCalls)
@@ -335,12 +364,7 @@ struct DrawCallManager
 
       if (vkDescSet != VK_NULL_HANDLE)
       {
-        VkDescriptorPool vkDescPool =
-            PipelineLayoutManager::_vkDescriptorPool(pipelineLayout);
-        _INTR_ASSERT(vkDescPool != VK_NULL_HANDLE);
-
-        RenderSystem::releaseResource(_N(VkDescriptorSet), (void*)vkDescSet,
-                                      (void*)vkDescPool);
+        PipelineLayoutManager::releaseDescriptorSet(pipelineLayout, vkDescSet);
         vkDescSet = VK_NULL_HANDLE;
       }
 
@@ -438,6 +462,7 @@ struct DrawCallManager
   {
     return _data.descIndexCount[p_Ref._id];
   }
+  // Max. instance count the draw call can be dispatched with
   _INTR_INLINE static uint32_t& _descInstanceCount(DrawCallRef p_Ref)
   {
     return _data.descInstanceCount[p_Ref._id];
@@ -481,6 +506,11 @@ struct DrawCallManager
   {
     return _data.sortingHash[p_Ref._id];
   }
+  // Instance count used for the next dispatch
+  _INTR_INLINE static uint32_t& _instanceCount(DrawCallRef p_Ref)
+  {
+    return _data.instanceCount[p_Ref._id];
+  }
   _INTR_INLINE static _INTR_ARRAY(uint32_t) & _dynamicOffsets(DrawCallRef p_Ref)
   {
     return _data.dynamicOffsets[p_Ref._id];
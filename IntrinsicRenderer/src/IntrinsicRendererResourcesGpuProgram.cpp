@@ -62,7 +62,7 @@ public:
     Memory::Tlsf::MainAllocator::free((void*)result->headerData);
     delete result;
   }
-} _includer;
+};
 
 TBuiltInResource _defaultResource;
 rapidjson::Document _shaderCache = rapidjson::Document(rapidjson::kObjectType);
@@ -136,8 +136,6 @@ void addShaderToCache(uint32_t p_ShaderHash, const char* p_GpuProgramName,
   of.write((const char*)p_SpirvBuffer.data(),
            p_SpirvBuffer.size() * sizeof(uint32_t));
   of.close();
-
-  saveShaderCache();
 }
 
 void loadShaderFromCache(const char* p_GpuProgranName,
@@ -164,6 +162,186 @@ void loadShaderFromCache(const char* p_GpuProgranName,
   ifs.close();
 }
 
+// <-
+
+struct IncludeFileInfo
+{
+  uint32_t contentHash;
+  _INTR_ARRAY(_INTR_STRING) includes;
+};
+typedef _INTR_HASH_MAP(uint32_t, IncludeFileInfo) IncludeFileCache;
+
+void collectIncludes(const _INTR_STRING& p_Source,
+                     _INTR_ARRAY(_INTR_STRING) & p_Includes)
+{
+  const _INTR_STRING directive = "#include";
+
+  size_t pos = p_Source.find(directive);
+  while (pos != _INTR_STRING::npos)
+  {
+    const size_t lineEnd = p_Source.find('\n', pos);
+    const size_t nameBegin = p_Source.find('"', pos + directive.size());
+
+    if (nameBegin != _INTR_STRING::npos && nameBegin < lineEnd)
+    {
+      const size_t nameEnd = p_Source.find('"', nameBegin + 1u);
+      if (nameEnd != _INTR_STRING::npos && nameEnd < lineEnd)
+      {
+        p_Includes.push_back(
+            p_Source.substr(nameBegin + 1u, nameEnd - nameBegin - 1u));
+      }
+    }
+
+    pos = p_Source.find(directive, pos + directive.size());
+  }
+}
+
+// <-
+
+const IncludeFileInfo& getIncludeFileInfo(const _INTR_STRING& p_FileName,
+                                          IncludeFileCache& p_Cache)
+{
+  const uint32_t nameHash =
+      Math::hash(p_FileName.c_str(), sizeof(char) * p_FileName.length());
+
+  auto it = p_Cache.find(nameHash);
+  if (it != p_Cache.end())
+  {
+    return it->second;
+  }
+
+  IncludeFileInfo& info = p_Cache[nameHash];
+  info.contentHash = 0u;
+
+  const _INTR_STRING filePath = _shaderPath + p_FileName;
+  _INTR_FSTREAM inFileStream =
+      _INTR_FSTREAM(filePath.c_str(), std::ios::in | std::ios::binary);
+  if (inFileStream)
+  {
+    _INTR_OSTRINGSTREAM contents;
+    contents << inFileStream.rdbuf();
+    inFileStream.close();
+
+    const _INTR_STRING source = contents.str();
+    info.contentHash =
+        Math::hash(source.c_str(), sizeof(char) * source.length());
+    collectIncludes(source, info.includes);
+  }
+
+  return info;
+}
+
+// <-
+
+/**
+ * Hashes the given source and the contents of all files it (transitively)
+ * includes, so changes to shared includes invalidate the cached SPIR-V.
+ */
+uint32_t calcShaderHash(const _INTR_STRING& p_GlslString,
+                        IncludeFileCache& p_IncludeFileCache)
+{
+  uint32_t shaderHash =
+      Math::hash(p_GlslString.c_str(), sizeof(char) * p_GlslString.length());
+
+  _INTR_ARRAY(_INTR_STRING) pendingIncludes;
+  collectIncludes(p_GlslString, pendingIncludes);
+  _INTR_ARRAY(_INTR_STRING) visitedIncludes;
+
+  while (!pendingIncludes.empty())
+  {
+    const _INTR_STRING include = pendingIncludes.back();
+    pendingIncludes.pop_back();
+
+    if (std::find(visitedIncludes.begin(), visitedIncludes.end(), include) !=
+        visitedIncludes.end())
+    {
+      continue;
+    }
+    visitedIncludes.push_back(include);
+
+    const IncludeFileInfo& info =
+        getIncludeFileInfo(include, p_IncludeFileCache);
+
+    // Combine djb2 style, the include name is part of the key as well
+    shaderHash = ((shaderHash << 5) + shaderHash) +
+                 Math::hash(include.c_str(), include.length());
+    shaderHash = ((shaderHash << 5) + shaderHash) + info.contentHash;
+
+    pendingIncludes.insert(pendingIncludes.end(), info.includes.begin(),
+                           info.includes.end());
+  }
+
+  return shaderHash;
+}
+
+// <-
+
+struct ShaderCompileJob
+{
+  GpuProgramRef ref;
+  _INTR_STRING gpuProgramName;
+  _INTR_STRING glslString;
+  uint32_t shaderHash;
+  EShLanguage stage;
+
+  // Results
+  SpirvBuffer spirvBuffer;
+  _INTR_STRING infoLog;
+  bool succeeded;
+};
+
+void compileShaderJob(ShaderCompileJob& p_Job)
+{
+  // Each job uses its own shader, program and includer instance
+  GlslangIncluder includer;
+  glslang::TShader shader(p_Job.stage);
+  glslang::TProgram program;
+
+  const EShMessages messages =
+      (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
+
+  const char* glslStringChar = p_Job.glslString.c_str();
+  shader.setStrings(&glslStringChar, 1);
+
+  p_Job.succeeded = shader.parse(&_defaultResource, 100, ECoreProfile, false,
+                                 false, messages, includer);
+  if (p_Job.succeeded)
+  {
+    program.addShader(&shader);
+    p_Job.succeeded = program.link(messages);
+  }
+
+  p_Job.infoLog = _INTR_STRING(shader.getInfoLog()) + shader.getInfoDebugLog();
+
+  if (p_Job.succeeded)
+  {
+    glslang::GlslangToSpv(*program.getIntermediate(p_Job.stage),
+                          p_Job.spirvBuffer);
+  }
+}
+
+// <-
+
+struct ShaderCompileParallelTaskSet : enki::ITaskSet
+{
+  virtual ~ShaderCompileParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("General", "GPU Program Compile Job");
+
+    for (uint32_t jobIdx = p_Range.start; jobIdx < p_Range.end; ++jobIdx)
+    {
+      compileShaderJob((*_jobs)[jobIdx]);
+    }
+  }
+
+  _INTR_ARRAY(ShaderCompileJob) * _jobs;
+};
+
+// <-
+
 void GpuProgramManager::init()
 {
   _INTR_LOG_INFO("Inititializing GPU Program Manager...");
@@ -327,6 +505,8 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
   _INTR_LOG_INFO("Loading/Compiling GPU Programs...");
 
   GpuProgramRefArray changedGpuPrograms;
+  _INTR_ARRAY(ShaderCompileJob) compileJobs;
+  IncludeFileCache includeFileCache;
 
   for (uint32_t gpIdx = 0u; gpIdx < p_Refs.size(); ++gpIdx)
   {
@@ -337,14 +517,6 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
     SpirvBuffer& spirvBuffer = _spirvBuffer(ref);
     spirvBuffer.clear();
 
-    EShLanguage stage = Helper::mapGpuProgramTypeToEshLang(
-        (GpuProgramType::Enum)_descGpuProgramType(ref));
-    glslang::TShader shader(stage);
-    glslang::TProgram program;
-
-    const EShMessages messages =
-        (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
-
     const _INTR_STRING& fileName = _descGpuProgramName(ref);
     _INTR_STRING filePath = _shaderPath + fileName;
 
@@ -378,8 +550,7 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
                             defineStr);
       }
 
-      shaderHash =
-          Math::hash(glslString.c_str(), sizeof(char) * glslString.length());
+      shaderHash = calcShaderHash(glslString, includeFileCache);
 
       if (!p_ForceRecompile)
       {
@@ -402,41 +573,62 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
     _INTR_LOG_INFO("Compiling GPU program '%s'...",
                    _descGpuProgramName(ref).c_str());
 
-    const char* glslStringChar = glslString.c_str();
-    shader.setStrings(&glslStringChar, 1);
-
-    if (!shader.parse(&_defaultResource, 100, ECoreProfile, false, false,
-                      messages, _includer))
+    ShaderCompileJob job;
     {
-      _INTR_LOG_WARNING("Parsing of GPU program failed...");
-      _INTR_LOG_WARNING(shader.getInfoLog());
-      _INTR_LOG_WARNING(shader.getInfoDebugLog());
-
-      // Try to load the previous shader from the cache
-      loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
-      continue;
+      job.ref = ref;
+      job.gpuProgramName = gpuProgramName;
+      job.glslString = std::move(glslString);
+      job.shaderHash = shaderHash;
+      job.stage = Helper::mapGpuProgramTypeToEshLang(
+          (GpuProgramType::Enum)_descGpuProgramType(ref));
+      job.succeeded = false;
     }
+    compileJobs.push_back(std::move(job));
+  }
 
-    program.addShader(&shader);
+  // Compile all outdated GPU programs in parallel
+  if (!compileJobs.empty())
+  {
+    _INTR_PROFILE_CPU("General", "Compile GPU Programs");
+
+    ShaderCompileParallelTaskSet compileTaskSet;
+    compileTaskSet._jobs = &compileJobs;
+    compileTaskSet.m_SetSize = (uint32_t)compileJobs.size();
+
+    Application::_scheduler.AddTaskSetToPipe(&compileTaskSet);
+    Application::_scheduler.WaitforTaskSet(&compileTaskSet);
+  }
+
+  for (uint32_t jobIdx = 0u; jobIdx < compileJobs.size(); ++jobIdx)
+  {
+    ShaderCompileJob& job = compileJobs[jobIdx];
 
-    if (!program.link(messages))
+    if (!job.succeeded)
     {
-      _INTR_LOG_WARNING("Linking of GPU program failed...");
-      _INTR_LOG_WARNING(shader.getInfoLog());
-      _INTR_LOG_WARNING(shader.getInfoDebugLog());
+      _INTR_LOG_WARNING("Compiling GPU program '%s' failed...",
+                        _descGpuProgramName(job.ref).c_str());
+      _INTR_LOG_WARNING("%s", job.infoLog.c_str());
 
       // Try to load the previous shader from the cache
-      loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
+      loadShaderFromCache(job.gpuProgramName.c_str(), _spirvBuffer(job.ref));
       continue;
     }
 
-    _INTR_LOG_WARNING(shader.getInfoLog());
-    _INTR_LOG_WARNING(shader.getInfoDebugLog());
+    if (!job.infoLog.empty())
+    {
+      _INTR_LOG_WARNING("%s", job.infoLog.c_str());
+    }
+
+    _spirvBuffer(job.ref) = std::move(job.spirvBuffer);
+    addShaderToCache(job.shaderHash, job.gpuProgramName.c_str(),
+                     _spirvBuffer(job.ref));
 
-    glslang::GlslangToSpv(*program.getIntermediate(stage), spirvBuffer);
-    addShaderToCache(shaderHash, gpuProgramName.c_str(), spirvBuffer);
+    changedGpuPrograms.push_back(job.ref);
+  }
 
-    changedGpuPrograms.push_back(ref);
+  if (!changedGpuPrograms.empty())
+  {
+    saveShaderCache();
   }
 
   // Update all pipelines which reference this GPU program
@@ -200,26 +200,17 @@ _INTR_INLINE void allocateMemory(GpuMemoryAllocationInfo& p_MemAllocInfo,
                                  MemoryPoolType::Enum p_PoolType,
                                  const VkMemoryRequirements& p_MemReqs)
 {
-  // Try to keep memory for static images
-  bool needsAlloc = true;
-  if (p_PoolType >= MemoryPoolType::kRangeStartStatic &&
-      p_PoolType <= MemoryPoolType::kRangeEndStatic)
-  {
-    if (p_MemAllocInfo._sizeInBytes <= p_MemReqs.size &&
-        p_MemAllocInfo._alignmentInBytes == p_MemReqs.alignment &&
-        p_MemAllocInfo._memoryPoolType == p_PoolType)
-    {
-      needsAlloc = false;
-    }
-  }
+  // Memory is returned when the resources get destroyed, this only catches
+  // images recreated without destroying them first
+  GpuMemoryManager::releaseOffset(p_MemAllocInfo);
 
-  if (needsAlloc)
-  {
-    p_MemAllocInfo = GpuMemoryManager::allocateOffset(
-        p_PoolType, (uint32_t)p_MemReqs.size, (uint32_t)p_MemReqs.alignment,
-        p_MemReqs.memoryTypeBits);
-  }
+  p_MemAllocInfo = GpuMemoryManager::allocateOffset(
+      p_PoolType, (uint32_t)p_MemReqs.size, (uint32_t)p_MemReqs.alignment,
+      p_MemReqs.memoryTypeBits);
 }
+
+// <-
+
 void createTexture(ImageRef p_Ref)
 {
   VkImage& vkImage = ImageManager::_vkImage(p_Ref);
@@ -486,40 +477,6 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
   ImageManager::_descArrayLayerCount(p_Ref) = 1u;
   ImageManager::_descImageFlags(p_Ref) = ImageFlags::kUsageSampled;
 
-  VkBuffer stagingBuffer;
-
-  VkBufferCreateInfo bufferCreateInfo = {};
-  {
-    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferCreateInfo.pNext = nullptr;
-    bufferCreateInfo.size = texCube.size();
-    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  }
-
-  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
-                                   nullptr, &stagingBuffer);
-  _INTR_VK_CHECK_RESULT(result);
-  VkMemoryRequirements stagingMemReqs;
-  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                &stagingMemReqs);
-
-  GpuMemoryAllocationInfo stagingGpuAllocInfo =
-      GpuMemoryManager::allocateOffset(MemoryPoolType::kVolatileStagingBuffers,
-                                       (uint32_t)stagingMemReqs.size,
-                                       (uint32_t)stagingMemReqs.alignment,
-                                       stagingMemReqs.memoryTypeBits);
-
-  result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                              stagingGpuAllocInfo._vkDeviceMemory,
-                              stagingGpuAllocInfo._offset);
-  _INTR_VK_CHECK_RESULT(result);
-
-  uint8_t* data = stagingGpuAllocInfo._mappedMemory;
-  {
-    memcpy(data, texCube.data(), texCube.size());
-  }
-
   _INTR_ARRAY(VkBufferImageCopy) bufferCopyRegions;
   uint32_t offset = 0;
 
@@ -571,8 +528,8 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
   }
 
   VkImage& vkImage = ImageManager::_vkImage(p_Ref);
-  result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo, nullptr,
-                         &vkImage);
+  VkResult result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo,
+                                  nullptr, &vkImage);
   _INTR_VK_CHECK_RESULT(result);
 
   VkMemoryRequirements memReqs;
@@ -585,31 +542,15 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
                              memoryAllocationInfo._offset);
   _INTR_VK_CHECK_RESULT(result);
 
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
   VkImageSubresourceRange subresourceRange = {};
   subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   subresourceRange.baseMipLevel = 0;
   subresourceRange.levelCount = mipLevels;
   subresourceRange.layerCount = faces;
 
-  Helper::insertImageMemoryBarrier(copyCmd, vkImage, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                   subresourceRange);
-
-  vkCmdCopyBufferToImage(copyCmd, stagingBuffer, vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                         static_cast<uint32_t>(bufferCopyRegions.size()),
-                         bufferCopyRegions.data());
-
-  Helper::insertImageMemoryBarrier(
-      copyCmd, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-
-  RenderSystem::flushTemporaryCommandBuffer();
-
-  vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffer, nullptr);
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
+  UploadManager::uploadImage(vkImage, subresourceRange, texCube.data(),
+                             (uint32_t)texCube.size(), bufferCopyRegions.data(),
+                             (uint32_t)bufferCopyRegions.size());
 
   VkImageViewCreateInfo view = {};
   {
@@ -662,41 +603,6 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
   ImageManager::_descArrayLayerCount(p_Ref) = 1u;
   ImageManager::_descImageFlags(p_Ref) = ImageFlags::kUsageSampled;
 
-  VkBuffer stagingBuffer;
-
-  VkBufferCreateInfo bufferCreateInfo = {};
-  {
-    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferCreateInfo.pNext = nullptr;
-    bufferCreateInfo.size = tex2D.size();
-    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  }
-
-  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
-                                   nullptr, &stagingBuffer);
-  _INTR_VK_CHECK_RESULT(result);
-
-  VkMemoryRequirements stagingMemReqs;
-  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                &stagingMemReqs);
-
-  GpuMemoryAllocationInfo stagingGpuAllocInfo =
-      GpuMemoryManager::allocateOffset(MemoryPoolType::kVolatileStagingBuffers,
-                                       (uint32_t)stagingMemReqs.size,
-                                       (uint32_t)stagingMemReqs.alignment,
-                                       stagingMemReqs.memoryTypeBits);
-
-  result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                              stagingGpuAllocInfo._vkDeviceMemory,
-                              stagingGpuAllocInfo._offset);
-  _INTR_VK_CHECK_RESULT(result);
-
-  uint8_t* data = stagingGpuAllocInfo._mappedMemory;
-  {
-    memcpy(data, tex2D.data(), tex2D.size());
-  }
-
   _INTR_ARRAY(VkBufferImageCopy) bufferCopyRegions;
   uint32_t offset = 0;
 
@@ -744,8 +650,8 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
   }
 
   VkImage& vkImage = ImageManager::_vkImage(p_Ref);
-  result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo, nullptr,
-                         &vkImage);
+  VkResult result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo,
+                                  nullptr, &vkImage);
   _INTR_VK_CHECK_RESULT(result);
 
   VkMemoryRequirements memReqs;
@@ -758,31 +664,15 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
                              memoryAllocationInfo._offset);
   _INTR_VK_CHECK_RESULT(result);
 
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
   VkImageSubresourceRange subresourceRange = {};
   subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   subresourceRange.baseMipLevel = 0;
   subresourceRange.levelCount = mipLevels;
   subresourceRange.layerCount = 1;
 
-  Helper::insertImageMemoryBarrier(copyCmd, vkImage, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                   subresourceRange);
-
-  vkCmdCopyBufferToImage(copyCmd, stagingBuffer, vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                         static_cast<uint32_t>(bufferCopyRegions.size()),
-                         bufferCopyRegions.data());
-
-  Helper::insertImageMemoryBarrier(
-      copyCmd, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-
-  RenderSystem::flushTemporaryCommandBuffer();
-
-  vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffer, nullptr);
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
+  UploadManager::uploadImage(vkImage, subresourceRange, tex2D.data(),
+                             (uint32_t)tex2D.size(), bufferCopyRegions.data(),
+                             (uint32_t)bufferCopyRegions.size());
 
   VkImageViewCreateInfo view = {};
   {
@@ -863,6 +753,8 @@ void ImageManager::createResources(const ImageRefArray& p_Images)
       createTextureFromFile(ref);
     }
   }
+
+  UploadManager::submit();
 }
 
 void ImageManager::updateGlobalDescriptorSets()
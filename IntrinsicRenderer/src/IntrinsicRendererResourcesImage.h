@@ -210,6 +210,7 @@ struct ImageManager
         {
           RenderSystem::releaseResource(_N(VkImage), (void*)vkImage, nullptr);
         }
+        GpuMemoryManager::releaseOffset(_memoryAllocationInfo(ref));
       }
       vkImage = VK_NULL_HANDLE;
 
@@ -21,6 +21,231 @@ namespace Renderer
 {
 namespace Resources
 {
+// Static members
+_INTR_HASH_MAP(uint32_t, SharedPipeline) PipelineManager::_sharedPipelines;
+
+// <-
+
+struct GpuProgramIdentity
+{
+  GpuProgramRef canonicalProgramRef;
+  uint32_t hash;
+};
+
+struct GpuProgramIdentityCache
+{
+  _INTR_HASH_MAP(uint32_t, GpuProgramIdentity) identities;
+  _INTR_HASH_MAP(uint32_t, GpuProgramRefArray) programsPerHash;
+};
+
+// <-
+
+void resolveAbsoluteDimensions(PipelineRef p_PipelineRef)
+{
+  glm::uvec2& dimScissor =
+      PipelineManager::_descAbsoluteScissorDimensions(p_PipelineRef);
+  if (PipelineManager::_descScissorRenderSize(p_PipelineRef) !=
+      RenderSize::kCustom)
+  {
+    dimScissor = RenderSystem::getAbsoluteRenderSize(
+        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
+            p_PipelineRef));
+  }
+
+  glm::uvec2& dimViewport =
+      PipelineManager::_descAbsoluteViewportDimensions(p_PipelineRef);
+  if (PipelineManager::_descViewportRenderSize(p_PipelineRef) !=
+      RenderSize::kCustom)
+  {
+    dimViewport = RenderSystem::getAbsoluteRenderSize(
+        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
+            p_PipelineRef));
+  }
+}
+
+// <-
+
+_INTR_INLINE void appendToStateKey(_INTR_ARRAY(uint32_t) & p_StateKey,
+                                   const void* p_Data, uint32_t p_SizeInBytes)
+{
+  _INTR_ASSERT(p_SizeInBytes % sizeof(uint32_t) == 0u);
+  if (p_SizeInBytes == 0u)
+  {
+    return;
+  }
+
+  const uint32_t offset = (uint32_t)p_StateKey.size();
+  p_StateKey.resize(offset + p_SizeInBytes / sizeof(uint32_t));
+  memcpy(&p_StateKey[offset], p_Data, p_SizeInBytes);
+}
+
+// <-
+
+template <typename T>
+_INTR_INLINE void appendHandleToStateKey(_INTR_ARRAY(uint32_t) & p_StateKey,
+                                         T p_Handle)
+{
+  const uint64_t handle = (uint64_t)p_Handle;
+  p_StateKey.push_back((uint32_t)handle);
+  p_StateKey.push_back((uint32_t)(handle >> 32u));
+}
+
+// <-
+
+bool isSameGpuProgram(GpuProgramRef p_Lhs, GpuProgramRef p_Rhs)
+{
+  const SpirvBuffer& lhsSpirv = GpuProgramManager::_spirvBuffer(p_Lhs);
+  const SpirvBuffer& rhsSpirv = GpuProgramManager::_spirvBuffer(p_Rhs);
+
+  return lhsSpirv.size() == rhsSpirv.size() &&
+         GpuProgramManager::_descEntryPoint(p_Lhs) ==
+             GpuProgramManager::_descEntryPoint(p_Rhs) &&
+         memcmp(lhsSpirv.data(), rhsSpirv.data(),
+                lhsSpirv.size() * sizeof(uint32_t)) == 0;
+}
+
+// <-
+
+void appendGpuProgramToStateKey(_INTR_ARRAY(uint32_t) & p_StateKey,
+                                GpuProgramRef p_GpuProgramRef,
+                                GpuProgramIdentityCache& p_IdentityCache)
+{
+  if (!p_GpuProgramRef.isValid())
+  {
+    p_StateKey.push_back(0u);
+    p_StateKey.push_back(0u);
+    return;
+  }
+
+  // Programs with equal SPIR-V and entry point stored in different resources
+  // resolve to the first of them, so they share the same state. The hash only
+  // narrows down the candidates, the contents are always compared in full
+  auto identity = p_IdentityCache.identities.find(p_GpuProgramRef._id);
+  if (identity == p_IdentityCache.identities.end())
+  {
+    const SpirvBuffer& spirvBuffer =
+        GpuProgramManager::_spirvBuffer(p_GpuProgramRef);
+    const _INTR_STRING& entryPoint =
+        GpuProgramManager::_descEntryPoint(p_GpuProgramRef);
+
+    GpuProgramIdentity newIdentity;
+    newIdentity.hash = Math::hash((const char*)spirvBuffer.data(),
+                                  spirvBuffer.size() * sizeof(uint32_t)) ^
+                       Math::hash(entryPoint.c_str(), entryPoint.size());
+    newIdentity.canonicalProgramRef = p_GpuProgramRef;
+
+    GpuProgramRefArray& candidates =
+        p_IdentityCache.programsPerHash[newIdentity.hash];
+    for (uint32_t i = 0u; i < candidates.size(); ++i)
+    {
+      if (isSameGpuProgram(candidates[i], p_GpuProgramRef))
+      {
+        newIdentity.canonicalProgramRef = candidates[i];
+        break;
+      }
+    }
+
+    if (newIdentity.canonicalProgramRef == p_GpuProgramRef)
+    {
+      candidates.push_back(p_GpuProgramRef);
+    }
+
+    identity = p_IdentityCache.identities
+                   .insert(std::make_pair(p_GpuProgramRef._id, newIdentity))
+                   .first;
+  }
+
+  // The hash stays part of the key so states created before the canonical
+  // program got recompiled are never matched again
+  const GpuProgramRef canonicalProgramRef =
+      identity->second.canonicalProgramRef;
+  p_StateKey.push_back(((uint32_t)canonicalProgramRef._generation << 24u) |
+                       canonicalProgramRef._id);
+  p_StateKey.push_back(identity->second.hash);
+}
+
+// <-
+
+void buildPipelineStateKey(PipelineRef p_PipelineRef,
+                           _INTR_ARRAY(uint32_t) & p_StateKey,
+                           GpuProgramIdentityCache& p_IdentityCache)
+{
+  p_StateKey.clear();
+
+  appendHandleToStateKey(p_StateKey,
+                         PipelineLayoutManager::_vkPipelineLayout(
+                             PipelineManager::_descPipelineLayout(
+                                 p_PipelineRef)));
+
+  GpuProgramRef cp = PipelineManager::_descComputeProgram(p_PipelineRef);
+  if (cp.isValid())
+  {
+    p_StateKey.push_back(1u);
+    appendGpuProgramToStateKey(p_StateKey, cp, p_IdentityCache);
+    return;
+  }
+
+  p_StateKey.push_back(0u);
+  appendGpuProgramToStateKey(p_StateKey,
+                             PipelineManager::_descVertexProgram(p_PipelineRef),
+                             p_IdentityCache);
+  appendGpuProgramToStateKey(
+      p_StateKey, PipelineManager::_descFragmentProgram(p_PipelineRef),
+      p_IdentityCache);
+  appendGpuProgramToStateKey(
+      p_StateKey, PipelineManager::_descGeometryProgram(p_PipelineRef),
+      p_IdentityCache);
+
+  appendHandleToStateKey(p_StateKey,
+                         RenderPassManager::_vkRenderPass(
+                             PipelineManager::_descRenderPass(p_PipelineRef)));
+
+  VertexLayoutRef vtxLayout = PipelineManager::_descVertexLayout(p_PipelineRef);
+  if (vtxLayout.isValid())
+  {
+    const VkPipelineVertexInputStateCreateInfo& vtxInputState =
+        VertexLayoutManager::_vkPipelineVertexInputStateCreateInfo(vtxLayout);
+
+    p_StateKey.push_back(vtxInputState.vertexBindingDescriptionCount);
+    appendToStateKey(p_StateKey, vtxInputState.pVertexBindingDescriptions,
+                     vtxInputState.vertexBindingDescriptionCount *
+                         sizeof(VkVertexInputBindingDescription));
+    p_StateKey.push_back(vtxInputState.vertexAttributeDescriptionCount);
+    appendToStateKey(p_StateKey, vtxInputState.pVertexAttributeDescriptions,
+                     vtxInputState.vertexAttributeDescriptionCount *
+                         sizeof(VkVertexInputAttributeDescription));
+  }
+  else
+  {
+    p_StateKey.push_back(0u);
+    p_StateKey.push_back(0u);
+  }
+
+  p_StateKey.push_back(
+      PipelineManager::_descDepthStencilState(p_PipelineRef) |
+      (PipelineManager::_descInputAssemblyState(p_PipelineRef) << 8u) |
+      (PipelineManager::_descRasterizationState(p_PipelineRef) << 16u));
+
+  const _INTR_ARRAY(uint8_t)& blendStates =
+      PipelineManager::_descBlendStates(p_PipelineRef);
+  p_StateKey.push_back((uint32_t)blendStates.size());
+  for (uint32_t i = 0u; i < (uint32_t)blendStates.size(); ++i)
+  {
+    p_StateKey.push_back(blendStates[i]);
+  }
+
+  appendToStateKey(
+      p_StateKey,
+      &PipelineManager::_descAbsoluteScissorDimensions(p_PipelineRef),
+      sizeof(glm::uvec2));
+  appendToStateKey(
+      p_StateKey,
+      &PipelineManager::_descAbsoluteViewportDimensions(p_PipelineRef),
+      sizeof(glm::uvec2));
+}
+
+// <-
+
 void createGraphicsPipeline(PipelineRef p_PipelineRef)
 {
   _INTR_ARRAY(uint8_t)& blendStates =
@@ -48,25 +273,10 @@ void createGraphicsPipeline(PipelineRef p_PipelineRef)
     cb.blendConstants[3] = 1.0f;
   }
 
-  glm::uvec2& dimScissor =
+  const glm::uvec2& dimScissor =
       PipelineManager::_descAbsoluteScissorDimensions(p_PipelineRef);
-  if (PipelineManager::_descScissorRenderSize(p_PipelineRef) !=
-      RenderSize::kCustom)
-  {
-    dimScissor = RenderSystem::getAbsoluteRenderSize(
-        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
-            p_PipelineRef));
-  }
-
-  glm::uvec2& dimViewport =
+  const glm::uvec2& dimViewport =
       PipelineManager::_descAbsoluteViewportDimensions(p_PipelineRef);
-  if (PipelineManager::_descViewportRenderSize(p_PipelineRef) !=
-      RenderSize::kCustom)
-  {
-    dimViewport = RenderSystem::getAbsoluteRenderSize(
-        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
-            p_PipelineRef));
-  }
 
   VkViewport viewport = {};
   {
@@ -222,19 +432,203 @@ void createComputePipeline(PipelineRef p_PipelineRef)
   _INTR_VK_CHECK_RESULT(result);
 }
 
+// <-
+
+struct PipelineCreationParallelTaskSet : enki::ITaskSet
+{
+  virtual ~PipelineCreationParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("General", "Pipeline Creation Job");
+
+    for (uint32_t i = p_Range.start; i < p_Range.end; ++i)
+    {
+      PipelineRef pipelineRef = (*_pipelines)[i];
+      const uint64_t startTimeInUs = TimingHelper::getMicroseconds();
+
+      if (PipelineManager::_descComputeProgram(pipelineRef).isValid())
+      {
+        createComputePipeline(pipelineRef);
+      }
+      else
+      {
+        createGraphicsPipeline(pipelineRef);
+      }
+
+      (*_creationTimesInUs)[i] =
+          (uint32_t)(TimingHelper::getMicroseconds() - startTimeInUs);
+    }
+  }
+
+  const PipelineRefArray* _pipelines;
+  _INTR_ARRAY(uint32_t) * _creationTimesInUs;
+};
+
+// <-
+
 void PipelineManager::createResources(const PipelineRefArray& p_Pipelines)
 {
+  if (p_Pipelines.empty())
+  {
+    return;
+  }
+
+  _INTR_PROFILE_CPU("Pipeline Manager", "Create Pipelines");
+
+  const uint64_t startTimeInUs = TimingHelper::getMicroseconds();
+
+  // Resolve the canonical state of each pipeline and only create a Vulkan
+  // pipeline for states which are not shared yet
+  PipelineRefArray pipelinesToCreate;
+  uint32_t sharedPipelineCount = 0u;
+  {
+    GpuProgramIdentityCache gpuProgramIdentities;
+    _INTR_ARRAY(uint32_t) stateKey;
+
+    for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
+    {
+      PipelineRef pipelineRef = p_Pipelines[i];
+
+      if (!_descComputeProgram(pipelineRef).isValid())
+      {
+        resolveAbsoluteDimensions(pipelineRef);
+      }
+
+      buildPipelineStateKey(pipelineRef, stateKey, gpuProgramIdentities);
+      const uint32_t stateHash =
+          Math::hash((const char*)stateKey.data(),
+                     stateKey.size() * sizeof(uint32_t));
+
+      _pipelineStateHash(pipelineRef) = 0u;
+
+      auto sharedPipeline = _sharedPipelines.find(stateHash);
+      if (sharedPipeline == _sharedPipelines.end())
+      {
+        if (stateHash != 0u)
+        {
+          SharedPipeline& newSharedPipeline = _sharedPipelines[stateHash];
+          newSharedPipeline.stateKey = stateKey;
+          newSharedPipeline.vkPipeline = VK_NULL_HANDLE;
+          newSharedPipeline.refCount = 1u;
+
+          _pipelineStateHash(pipelineRef) = stateHash;
+        }
+
+        pipelinesToCreate.push_back(pipelineRef);
+      }
+      else if (sharedPipeline->second.stateKey == stateKey)
+      {
+        ++sharedPipeline->second.refCount;
+        _pipelineStateHash(pipelineRef) = stateHash;
+        ++sharedPipelineCount;
+      }
+      else
+      {
+        // Hash collision, fall back to a pipeline of its own
+        pipelinesToCreate.push_back(pipelineRef);
+      }
+    }
+  }
+
+  // The pipeline cache is internally synchronized, so the pipelines can be
+  // created concurrently
+  _INTR_ARRAY(uint32_t) creationTimesInUs;
+  creationTimesInUs.resize(pipelinesToCreate.size());
+
+  PipelineCreationParallelTaskSet creationTaskSet;
+  creationTaskSet._pipelines = &pipelinesToCreate;
+  creationTaskSet._creationTimesInUs = &creationTimesInUs;
+  creationTaskSet.m_SetSize = (uint32_t)pipelinesToCreate.size();
+
+  if (!pipelinesToCreate.empty())
+  {
+    Application::_scheduler.AddTaskSetToPipe(&creationTaskSet);
+    Application::_scheduler.WaitforTaskSet(&creationTaskSet);
+  }
+
+  // Hand the new pipelines out to all resources sharing their state
+  for (uint32_t i = 0u; i < pipelinesToCreate.size(); ++i)
+  {
+    PipelineRef pipelineRef = pipelinesToCreate[i];
+    const uint32_t stateHash = _pipelineStateHash(pipelineRef);
+
+    if (stateHash != 0u)
+    {
+      _sharedPipelines[stateHash].vkPipeline = _vkPipeline(pipelineRef);
+    }
+  }
   for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
   {
-    RenderPassRef pipelineRef = p_Pipelines[i];
+    PipelineRef pipelineRef = p_Pipelines[i];
+    const uint32_t stateHash = _pipelineStateHash(pipelineRef);
 
-    if (_descComputeProgram(pipelineRef).isValid())
+    if (stateHash != 0u)
     {
-      createComputePipeline(pipelineRef);
+      _vkPipeline(pipelineRef) = _sharedPipelines[stateHash].vkPipeline;
     }
-    else
+  }
+
+  // Report the creation times
+  uint64_t totalCreationTimeInUs = 0u;
+  for (uint32_t i = 0u; i < pipelinesToCreate.size(); ++i)
+  {
+    totalCreationTimeInUs += creationTimesInUs[i];
+
+    const float creationTimeInMs = creationTimesInUs[i] / 1000.0f;
+    if (creationTimeInMs >= _INTR_PIPELINE_CREATION_WARNING_THRESHOLD_IN_MS)
+    {
+      _INTR_LOG_WARNING("Creating pipeline '%s' took %.2f ms...",
+                        _name(pipelinesToCreate[i]).getString().c_str(),
+                        creationTimeInMs);
+    }
+  }
+
+  _INTR_LOG_INFO(
+      "Created %u pipelines in %.2f ms (%.2f ms spent in pipeline creation)...",
+      (uint32_t)pipelinesToCreate.size(),
+      (TimingHelper::getMicroseconds() - startTimeInUs) / 1000.0f,
+      totalCreationTimeInUs / 1000.0f);
+  _INTR_LOG_INFO("Deduplicated %u of %u pipelines, %u shared pipeline states "
+                 "in use...",
+                 sharedPipelineCount, (uint32_t)p_Pipelines.size(),
+                 (uint32_t)_sharedPipelines.size());
+}
+
+// <-
+
+void PipelineManager::destroyResources(const PipelineRefArray& p_Pipelines)
+{
+  for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
+  {
+    PipelineRef ref = p_Pipelines[i];
+    VkPipeline& pipeline = _vkPipeline(ref);
+
+    if (pipeline != VK_NULL_HANDLE)
     {
-      createGraphicsPipeline(pipelineRef);
+      bool releasePipeline = true;
+
+      uint32_t& stateHash = _pipelineStateHash(ref);
+      if (stateHash != 0u)
+      {
+        auto sharedPipeline = _sharedPipelines.find(stateHash);
+        _INTR_ASSERT(sharedPipeline != _sharedPipelines.end());
+
+        releasePipeline = --sharedPipeline->second.refCount == 0u;
+        if (releasePipeline)
+        {
+          _sharedPipelines.erase(sharedPipeline);
+        }
+
+        stateHash = 0u;
+      }
+
+      if (releasePipeline)
+      {
+        RenderSystem::releaseResource(_N(VkPipeline), (void*)pipeline, nullptr);
+      }
+      pipeline = VK_NULL_HANDLE;
     }
   }
 }
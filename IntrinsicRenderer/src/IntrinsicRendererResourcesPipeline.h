@@ -14,6 +14,9 @@
 
 #pragma once
 
+// Pipelines taking longer than this to create are reported
+#define _INTR_PIPELINE_CREATION_WARNING_THRESHOLD_IN_MS 10.0f
+
 namespace Intrinsic
 {
 namespace Renderer
@@ -24,6 +27,17 @@ namespace Resources
 typedef Dod::Ref PipelineRef;
 typedef _INTR_ARRAY(PipelineRef) PipelineRefArray;
 
+/**
+ * A Vulkan pipeline shared by all pipeline resources resolving to the same
+ * canonical pipeline state.
+ */
+struct SharedPipeline
+{
+  _INTR_ARRAY(uint32_t) stateKey;
+  VkPipeline vkPipeline;
+  uint32_t refCount;
+};
+
 struct PipelineData : Dod::Resources::ResourceDataBase
 {
   PipelineData() : Dod::Resources::ResourceDataBase(_INTR_MAX_PIPELINE_COUNT)
@@ -46,7 +60,8 @@ struct PipelineData : Dod::Resources::ResourceDataBase
     descAbsoluteScissorDimensions.resize(_INTR_MAX_PIPELINE_COUNT);
     descAbsoluteViewportDimensions.resize(_INTR_MAX_PIPELINE_COUNT);
 
-    vkPipeline.resize(_INTR_MAX_RENDER_PASS_COUNT);
+    vkPipeline.resize(_INTR_MAX_PIPELINE_COUNT);
+    pipelineStateHash.resize(_INTR_MAX_PIPELINE_COUNT);
   }
 
   // Description
@@ -70,6 +85,7 @@ struct PipelineData : Dod::Resources::ResourceDataBase
 
   // Resources
   _INTR_ARRAY(VkPipeline) vkPipeline;
+  _INTR_ARRAY(uint32_t) pipelineStateHash;
 };
 
 struct PipelineManager
@@ -168,24 +184,19 @@ struct PipelineManager
 
   // <-
 
+  /**
+   * Creates the Vulkan pipelines of the given pipeline resources. Resources
+   * resolving to the same canonical pipeline state (GPU programs, vertex
+   * layout, pipeline layout, render pass and render states) share a single
+   * reference counted Vulkan pipeline.
+   */
   static void createResources(const PipelineRefArray& p_Pipelines);
 
-  // <-
-
-  _INTR_INLINE static void destroyResources(const PipelineRefArray& p_Pipelines)
-  {
-    for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
-    {
-      PipelineRef ref = p_Pipelines[i];
-      VkPipeline& pipeline = _vkPipeline(ref);
-
-      if (pipeline != VK_NULL_HANDLE)
-      {
-        RenderSystem::releaseResource(_N(VkPipeline), (void*)pipeline, nullptr);
-        pipeline = VK_NULL_HANDLE;
-      }
-    }
-  }
+  /**
+   * Releases the Vulkan pipelines of the given pipeline resources. Shared
+   * pipelines are only released when their last user is destroyed.
+   */
+  static void destroyResources(const PipelineRefArray& p_Pipelines);
 
   // <-
 
@@ -270,6 +281,13 @@ struct PipelineManager
   {
     return _data.vkPipeline[p_Ref._id];
   }
+  _INTR_INLINE static uint32_t& _pipelineStateHash(PipelineRef p_Ref)
+  {
+    return _data.pipelineStateHash[p_Ref._id];
+  }
+
+  // Shared pipelines by canonical pipeline state hash
+  static _INTR_HASH_MAP(uint32_t, SharedPipeline) _sharedPipelines;
 };
 }
 }
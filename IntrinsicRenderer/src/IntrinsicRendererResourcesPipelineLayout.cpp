@@ -54,6 +54,24 @@ void PipelineLayoutManager::createResources(
       layoutBindings[biIdx].pImmutableSamplers = nullptr;
     }
 
+    // Prepare the writes for each binding once, so writing a descriptor set
+    // only requires patching in the target set and the resource infos
+    _INTR_ARRAY(VkWriteDescriptorSet)& writeTemplates =
+        _vkDescriptorWriteTemplates(ref);
+    writeTemplates.resize(layoutBindings.size());
+    for (uint32_t biIdx = 0u; biIdx < layoutBindings.size(); ++biIdx)
+    {
+      VkWriteDescriptorSet& write = writeTemplates[biIdx];
+      write = {};
+      write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      write.pNext = nullptr;
+      write.dstSet = VK_NULL_HANDLE;
+      write.dstBinding = layoutBindings[biIdx].binding;
+      write.dstArrayElement = 0u;
+      write.descriptorCount = layoutBindings[biIdx].descriptorCount;
+      write.descriptorType = layoutBindings[biIdx].descriptorType;
+    }
+
     VkDescriptorSetLayoutCreateInfo descLayout = {};
     {
       descLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -145,9 +163,13 @@ void PipelineLayoutManager::destroyResources(
     VkDescriptorPool& descPool = _vkDescriptorPool(ref);
     if (descPool != VK_NULL_HANDLE)
     {
+      // Destroying the pool releases all of its descriptor sets in one go
       vkDestroyDescriptorPool(RenderSystem::_vkDevice, descPool, nullptr);
       descPool = VK_NULL_HANDLE;
 
+      _descriptorSetCache(ref).clear();
+      _descriptorSetHashes(ref).clear();
+
       // Invalidate descriptor sets allocated from this pool
       for (uint32_t dcIdx = 0u; dcIdx < DrawCallManager::_activeRefs.size();
            ++dcIdx)
@@ -166,119 +188,248 @@ void PipelineLayoutManager::destroyResources(
         }
       }
     }
+
+    _vkDescriptorWriteTemplates(ref).clear();
   }
 }
 
 // <-
 
-VkDescriptorSet PipelineLayoutManager::allocateAndWriteDescriptorSet(
-    PipelineLayoutRef p_Ref, const _INTR_ARRAY(BindingInfo) & p_BindInfos)
+_INTR_INLINE void appendHandleToKey(_INTR_ARRAY(uint32_t) & p_Key,
+                                    uint64_t p_Handle)
 {
-  if (_vkDescriptorPool(p_Ref))
-  {
-    VkDescriptorSetAllocateInfo allocInfo = {};
-    {
-      allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-      allocInfo.pNext = nullptr;
-      allocInfo.descriptorPool = _vkDescriptorPool(p_Ref);
-      allocInfo.descriptorSetCount = 1u;
-      allocInfo.pSetLayouts = &_vkDescriptorSetLayout(p_Ref);
-    }
+  p_Key.push_back((uint32_t)p_Handle);
+  p_Key.push_back((uint32_t)(p_Handle >> 32u));
+}
+
+// <-
 
-    VkDescriptorSet descSet;
-    VkResult result =
-        vkAllocateDescriptorSets(RenderSystem::_vkDevice, &allocInfo, &descSet);
-    _INTR_VK_CHECK_RESULT(result);
+void resolveDescriptorInfos(const _INTR_ARRAY(BindingInfo) & p_BindInfos,
+                            _INTR_ARRAY(VkDescriptorImageInfo) & p_ImageInfos,
+                            _INTR_ARRAY(VkDescriptorBufferInfo) &
+                                p_BufferInfos,
+                            _INTR_ARRAY(uint32_t) & p_Key)
+{
+  p_ImageInfos.clear();
+  p_ImageInfos.resize(p_BindInfos.size());
+  p_BufferInfos.clear();
+  p_BufferInfos.resize(p_BindInfos.size());
+  p_Key.clear();
 
-    _INTR_ARRAY(VkWriteDescriptorSet) writes;
-    _INTR_ARRAY(VkDescriptorImageInfo) imageInfos;
-    _INTR_ARRAY(VkDescriptorBufferInfo) bufferInfos;
+  for (uint32_t i = 0u; i < p_BindInfos.size(); ++i)
+  {
+    const BindingInfo& info = p_BindInfos[i];
 
-    writes.resize(p_BindInfos.size());
-    imageInfos.resize(p_BindInfos.size());
-    bufferInfos.resize(p_BindInfos.size());
+    p_Key.push_back(info.binding | (info.bindingType << 8u));
 
-    for (uint32_t i = 0u; i < p_BindInfos.size(); ++i)
+    if (info.bindingType >= BindingType::kRangeStartBuffer &&
+        info.bindingType <= BindingType::kRangeEndBuffer)
     {
-      const BindingInfo& info = p_BindInfos[i];
+      VkDescriptorBufferInfo& bufferInfo = p_BufferInfos[i];
+      bufferInfo.buffer = Resources::BufferManager::_vkBuffer(info.resource);
+      bufferInfo.offset = 0u;
+      bufferInfo.range = info.bufferData.rangeInBytes;
 
-      writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      writes[i].pNext = nullptr;
-      writes[i].dstSet = descSet;
-      writes[i].descriptorCount = 1u;
-      writes[i].descriptorType = Helper::mapBindingTypeToVkDescriptorType(
-          (BindingType::Enum)info.bindingType);
-
-      if (info.bindingType >= BindingType::kRangeStartBuffer &&
-          info.bindingType <= BindingType::kRangeEndBuffer)
-      {
-        VkDescriptorBufferInfo& bufferInfo = bufferInfos[i];
-        bufferInfo.buffer = Resources::BufferManager::_vkBuffer(info.resource);
-        bufferInfo.offset = 0u;
-        bufferInfo.range = info.bufferData.rangeInBytes;
+      appendHandleToKey(p_Key, (uint64_t)bufferInfo.buffer);
+      appendHandleToKey(p_Key, bufferInfo.range);
+    }
+    else if (info.bindingType >= BindingType::kRangeStartImage &&
+             info.bindingType <= BindingType::kRangeEndImage)
+    {
+      VkDescriptorImageInfo& imageInfo = p_ImageInfos[i];
 
-        writes[i].pBufferInfo = &bufferInfo;
-      }
-      else if (info.bindingType >= BindingType::kRangeStartImage &&
-               info.bindingType <= BindingType::kRangeEndImage)
+      if (info.bindingType == BindingType::kImageAndSamplerCombined ||
+          info.bindingType == BindingType::kStorageImage ||
+          info.bindingType == BindingType::kSampledImage)
       {
-        VkDescriptorImageInfo& imageInfo = imageInfos[i];
-
-        if (info.bindingType == BindingType::kImageAndSamplerCombined ||
-            info.bindingType == BindingType::kStorageImage ||
-            info.bindingType == BindingType::kSampledImage)
+        if ((info.bindingFlags & BindingFlags::kAdressSubResource) == 0u)
         {
-          if ((info.bindingFlags & BindingFlags::kAdressSubResource) == 0u)
+          if ((info.bindingFlags & BindingFlags::kForceGammaSampling) > 0u)
+          {
+            imageInfo.imageView =
+                Resources::ImageManager::_vkImageViewGamma(info.resource);
+          }
+          else if ((info.bindingFlags & BindingFlags::kForceLinearSampling) >
+                   0u)
           {
-            if ((info.bindingFlags & BindingFlags::kForceGammaSampling) > 0u)
-            {
-              imageInfo.imageView =
-                  Resources::ImageManager::_vkImageViewGamma(info.resource);
-            }
-            else if ((info.bindingFlags & BindingFlags::kForceLinearSampling) >
-                     0u)
-            {
-              imageInfo.imageView =
-                  Resources::ImageManager::_vkImageViewLinear(info.resource);
-            }
-            else
-            {
-              imageInfo.imageView =
-                  Resources::ImageManager::_vkImageView(info.resource);
-            }
+            imageInfo.imageView =
+                Resources::ImageManager::_vkImageViewLinear(info.resource);
           }
           else
           {
             imageInfo.imageView =
-                Resources::ImageManager::_vkSubResourceImageView(
-                    info.resource, info.imageData.arrayLayerIdx,
-                    info.imageData.mipLevelIdx);
+                Resources::ImageManager::_vkImageView(info.resource);
           }
-
-          imageInfo.imageLayout = info.bindingType != BindingType::kStorageImage
-                                      ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-                                      : VK_IMAGE_LAYOUT_GENERAL;
         }
-
-        if (info.bindingType == BindingType::kImageAndSamplerCombined ||
-            info.bindingType == BindingType::kSampler)
+        else
         {
-          imageInfo.sampler = Samplers::samplers[info.imageData.samplerIdx];
+          imageInfo.imageView =
+              Resources::ImageManager::_vkSubResourceImageView(
+                  info.resource, info.imageData.arrayLayerIdx,
+                  info.imageData.mipLevelIdx);
         }
 
-        writes[i].pImageInfo = &imageInfo;
+        imageInfo.imageLayout = info.bindingType != BindingType::kStorageImage
+                                    ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                    : VK_IMAGE_LAYOUT_GENERAL;
+      }
+
+      if (info.bindingType == BindingType::kImageAndSamplerCombined ||
+          info.bindingType == BindingType::kSampler)
+      {
+        imageInfo.sampler = Samplers::samplers[info.imageData.samplerIdx];
+      }
+
+      appendHandleToKey(p_Key, (uint64_t)imageInfo.imageView);
+      appendHandleToKey(p_Key, (uint64_t)imageInfo.sampler);
+      p_Key.push_back(imageInfo.imageLayout);
+    }
+  }
+}
+
+// <-
+
+VkDescriptorSet allocateAndWriteDescriptorSet(
+    PipelineLayoutRef p_Ref, const _INTR_ARRAY(BindingInfo) & p_BindInfos,
+    const _INTR_ARRAY(VkDescriptorImageInfo) & p_ImageInfos,
+    const _INTR_ARRAY(VkDescriptorBufferInfo) & p_BufferInfos)
+{
+  VkDescriptorSetAllocateInfo allocInfo = {};
+  {
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.pNext = nullptr;
+    allocInfo.descriptorPool = PipelineLayoutManager::_vkDescriptorPool(p_Ref);
+    allocInfo.descriptorSetCount = 1u;
+    allocInfo.pSetLayouts =
+        &PipelineLayoutManager::_vkDescriptorSetLayout(p_Ref);
+  }
+
+  VkDescriptorSet descSet;
+  VkResult result =
+      vkAllocateDescriptorSets(RenderSystem::_vkDevice, &allocInfo, &descSet);
+  _INTR_VK_CHECK_RESULT(result);
+
+  const _INTR_ARRAY(VkWriteDescriptorSet)& writeTemplates =
+      PipelineLayoutManager::_vkDescriptorWriteTemplates(p_Ref);
+
+  _INTR_ARRAY(VkWriteDescriptorSet) writes;
+  writes.resize(p_BindInfos.size());
+
+  for (uint32_t i = 0u; i < p_BindInfos.size(); ++i)
+  {
+    const BindingInfo& info = p_BindInfos[i];
+
+    uint32_t templateIdx = 0u;
+    for (; templateIdx < writeTemplates.size(); ++templateIdx)
+    {
+      if (writeTemplates[templateIdx].dstBinding == info.binding)
+      {
+        break;
       }
+    }
+    _INTR_ASSERT(templateIdx < writeTemplates.size() &&
+                 "Binding not part of the pipeline layout");
+
+    writes[i] = writeTemplates[templateIdx];
+    writes[i].dstSet = descSet;
+
+    if (info.bindingType >= BindingType::kRangeStartBuffer &&
+        info.bindingType <= BindingType::kRangeEndBuffer)
+    {
+      writes[i].pBufferInfo = &p_BufferInfos[i];
+    }
+    else if (info.bindingType >= BindingType::kRangeStartImage &&
+             info.bindingType <= BindingType::kRangeEndImage)
+    {
+      writes[i].pImageInfo = &p_ImageInfos[i];
+    }
+  }
+
+  vkUpdateDescriptorSets(RenderSystem::_vkDevice, (uint32_t)writes.size(),
+                         writes.data(), 0u, nullptr);
+  return descSet;
+}
+
+// <-
+
+VkDescriptorSet PipelineLayoutManager::acquireDescriptorSet(
+    PipelineLayoutRef p_Ref, const _INTR_ARRAY(BindingInfo) & p_BindInfos)
+{
+  if (!_vkDescriptorPool(p_Ref))
+  {
+    return VK_NULL_HANDLE;
+  }
+
+  _INTR_ARRAY(VkDescriptorImageInfo) imageInfos;
+  _INTR_ARRAY(VkDescriptorBufferInfo) bufferInfos;
+  _INTR_ARRAY(uint32_t) key;
+  resolveDescriptorInfos(p_BindInfos, imageInfos, bufferInfos, key);
 
-      writes[i].dstArrayElement = 0u;
-      writes[i].dstBinding = info.binding;
+  const uint32_t hash =
+      Math::hash((const char*)key.data(), key.size() * sizeof(uint32_t));
+
+  _INTR_HASH_MAP(uint32_t, CachedDescriptorSet)& cache =
+      _descriptorSetCache(p_Ref);
+
+  auto cachedDescSet = cache.find(hash);
+  if (cachedDescSet != cache.end())
+  {
+    if (cachedDescSet->second.key == key)
+    {
+      ++cachedDescSet->second.refCount;
+      return cachedDescSet->second.vkDescriptorSet;
+    }
+
+    // Hash collision, fall back to a set of its own
+    return allocateAndWriteDescriptorSet(p_Ref, p_BindInfos, imageInfos,
+                                         bufferInfos);
+  }
+
+  VkDescriptorSet descSet =
+      allocateAndWriteDescriptorSet(p_Ref, p_BindInfos, imageInfos,
+                                    bufferInfos);
+
+  CachedDescriptorSet& newCachedDescSet = cache[hash];
+  newCachedDescSet.key = std::move(key);
+  newCachedDescSet.vkDescriptorSet = descSet;
+  newCachedDescSet.refCount = 1u;
+
+  _descriptorSetHashes(p_Ref)[(uint64_t)descSet] = hash;
+
+  return descSet;
+}
+
+// <-
+
+void PipelineLayoutManager::releaseDescriptorSet(
+    PipelineLayoutRef p_Ref, VkDescriptorSet p_DescriptorSet)
+{
+  VkDescriptorPool vkDescPool = _vkDescriptorPool(p_Ref);
+  _INTR_ASSERT(vkDescPool != VK_NULL_HANDLE);
+
+  _INTR_HASH_MAP(uint64_t, uint32_t)& descSetHashes =
+      _descriptorSetHashes(p_Ref);
+
+  auto descSetHash = descSetHashes.find((uint64_t)p_DescriptorSet);
+  if (descSetHash != descSetHashes.end())
+  {
+    _INTR_HASH_MAP(uint32_t, CachedDescriptorSet)& cache =
+        _descriptorSetCache(p_Ref);
+
+    auto cachedDescSet = cache.find(descSetHash->second);
+    _INTR_ASSERT(cachedDescSet != cache.end());
+
+    if (--cachedDescSet->second.refCount > 0u)
+    {
+      return;
     }
 
-    vkUpdateDescriptorSets(RenderSystem::_vkDevice, (uint32_t)writes.size(),
-                           writes.data(), 0u, nullptr);
-    return descSet;
+    cache.erase(cachedDescSet);
+    descSetHashes.erase(descSetHash);
   }
 
-  return VK_NULL_HANDLE;
+  RenderSystem::releaseResource(_N(VkDescriptorSet), (void*)p_DescriptorSet,
+                                (void*)vkDescPool);
 }
 }
 }
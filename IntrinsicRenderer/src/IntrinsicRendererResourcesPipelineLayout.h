@@ -24,6 +24,16 @@ namespace Resources
 typedef Dod::Ref PipelineLayoutRef;
 typedef Dod::RefArray PipelineLayoutRefArray;
 
+/**
+ * A descriptor set shared by all users binding the same resources.
+ */
+struct CachedDescriptorSet
+{
+  _INTR_ARRAY(uint32_t) key;
+  VkDescriptorSet vkDescriptorSet;
+  uint32_t refCount;
+};
+
 struct PipelineLayoutData : Dod::Resources::ResourceDataBase
 {
   PipelineLayoutData()
@@ -34,6 +44,9 @@ struct PipelineLayoutData : Dod::Resources::ResourceDataBase
     vkPipelineLayout.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
     vkDescriptorSetLayout.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
     vkDescriptorPool.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
+    vkDescriptorWriteTemplates.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
+    descriptorSetCache.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
+    descriptorSetHashes.resize(_INTR_MAX_PIPELINE_LAYOUT_COUNT);
   }
 
   // Description
@@ -43,6 +56,10 @@ struct PipelineLayoutData : Dod::Resources::ResourceDataBase
   _INTR_ARRAY(VkPipelineLayout) vkPipelineLayout;
   _INTR_ARRAY(VkDescriptorSetLayout) vkDescriptorSetLayout;
   _INTR_ARRAY(VkDescriptorPool) vkDescriptorPool;
+  _INTR_ARRAY(_INTR_ARRAY(VkWriteDescriptorSet)) vkDescriptorWriteTemplates;
+  _INTR_ARRAY(_INTR_HASH_MAP(uint32_t, CachedDescriptorSet))
+  descriptorSetCache;
+  _INTR_ARRAY(_INTR_HASH_MAP(uint64_t, uint32_t)) descriptorSetHashes;
 };
 
 struct PipelineLayoutManager
@@ -141,9 +158,22 @@ struct PipelineLayoutManager
     }
   }
 
+  /**
+   * Returns a descriptor set of the given layout binding the given resources.
+   * Descriptor sets are cached by the resources they bind and shared between
+   * all callers requesting the same bindings. Each acquired set has to be
+   * returned using releaseDescriptorSet.
+   */
   static VkDescriptorSet
-  allocateAndWriteDescriptorSet(PipelineLayoutRef p_Ref,
-                                const _INTR_ARRAY(BindingInfo) & p_BindInfos);
+  acquireDescriptorSet(PipelineLayoutRef p_Ref,
+                       const _INTR_ARRAY(BindingInfo) & p_BindInfos);
+
+  /**
+   * Drops a reference to the given descriptor set. The set is queued for
+   * release as soon as it is not referenced anymore.
+   */
+  static void releaseDescriptorSet(PipelineLayoutRef p_Ref,
+                                   VkDescriptorSet p_DescriptorSet);
 
   // Description
   _INTR_INLINE static _INTR_ARRAY(BindingDescription) &
@@ -168,6 +198,21 @@ struct PipelineLayoutManager
   {
     return _data.vkDescriptorPool[p_Ref._id];
   }
+  _INTR_INLINE static _INTR_ARRAY(VkWriteDescriptorSet) &
+      _vkDescriptorWriteTemplates(PipelineLayoutRef p_Ref)
+  {
+    return _data.vkDescriptorWriteTemplates[p_Ref._id];
+  }
+  _INTR_INLINE static _INTR_HASH_MAP(uint32_t, CachedDescriptorSet) &
+      _descriptorSetCache(PipelineLayoutRef p_Ref)
+  {
+    return _data.descriptorSetCache[p_Ref._id];
+  }
+  _INTR_INLINE static _INTR_HASH_MAP(uint64_t, uint32_t) &
+      _descriptorSetHashes(PipelineLayoutRef p_Ref)
+  {
+    return _data.descriptorSetHashes[p_Ref._id];
+  }
 };
 }
 }
@@ -40,6 +40,11 @@ Memory::LockFreeFixedBlockAllocator<
     _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES>
     UniformManager::_perInstanceAllocatorLarge
         [_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
+Memory::LockFreeFixedBlockAllocator<
+    _INTR_VK_PER_INSTANCE_BLOCK_HUGE_COUNT,
+    _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES>
+    UniformManager::_perInstanceAllocatorHuge
+        [_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
 Memory::LockFreeFixedBlockAllocator<_INTR_VK_PER_MATERIAL_BLOCK_COUNT,
                                     _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES>
     UniformManager::_perMaterialAllocator;
@@ -48,6 +53,10 @@ BufferRef UniformManager::_perInstanceUniformBuffer;
 BufferRef UniformManager::_perFrameUniformBuffer;
 BufferRef UniformManager::_perMaterialUniformBuffer;
 BufferRef UniformManager::_perMaterialStagingUniformBuffer;
+uint8_t* UniformManager::_perMaterialStagingMemory = nullptr;
+
+_INTR_ARRAY(VkBufferCopy) UniformManager::_dirtyPerMaterialRanges;
+_INTR_ARRAY(VkBufferCopy) UniformManager::_perMaterialDataCopies;
 
 // <-
 
@@ -90,7 +99,7 @@ void UniformManager::init()
     buffersToCreate.push_back(_perMaterialUniformBuffer);
   }
 
-  // Staging buffer used to update the per material buffer data
+  // Host copy of the per material buffer data used as the source for updates
   _perMaterialStagingUniformBuffer =
       BufferManager::createBuffer(_N(_PerMaterialStagingConstantBuffer));
   {
@@ -104,7 +113,7 @@ void UniformManager::init()
     BufferManager::_descBufferType(_perMaterialStagingUniformBuffer) =
         BufferType::kUniform;
     BufferManager::_descSizeInBytes(_perMaterialStagingUniformBuffer) =
-        _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES;
+        _INTR_VK_PER_MATERIAL_UNIFORM_MEMORY_IN_BYTES;
     buffersToCreate.push_back(_perMaterialStagingUniformBuffer);
   }
 
@@ -132,6 +141,8 @@ void UniformManager::init()
   // Get host memory
   _perInstanceMemory = BufferManager::getGpuMemory(_perInstanceUniformBuffer);
   _perFrameMemory = BufferManager::getGpuMemory(_perFrameUniformBuffer);
+  _perMaterialStagingMemory =
+      BufferManager::getGpuMemory(_perMaterialStagingUniformBuffer);
 
   // Initializes per instance data memory blocks
   {
@@ -147,6 +158,10 @@ void UniformManager::init()
                                                  currentOffset);
       currentOffset += _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES *
                        _INTR_VK_PER_INSTANCE_BLOCK_LARGE_COUNT;
+      _perInstanceAllocatorHuge[bufferIdx].init(_perInstanceMemory,
+                                                currentOffset);
+      currentOffset += _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES *
+                       _INTR_VK_PER_INSTANCE_BLOCK_HUGE_COUNT;
     }
   }
   _INTR_LOG_INFO(
@@ -166,6 +181,50 @@ void UniformManager::init()
 
 // <-
 
+void UniformManager::preparePerMaterialDataCopies()
+{
+  if (_dirtyPerMaterialRanges.empty())
+  {
+    return;
+  }
+
+  _perMaterialDataCopies.insert(_perMaterialDataCopies.end(),
+                                _dirtyPerMaterialRanges.begin(),
+                                _dirtyPerMaterialRanges.end());
+  _dirtyPerMaterialRanges.clear();
+
+  // Copying the gap between two nearby ranges is cheaper than an additional
+  // copy region
+  Helper::coalesceBufferCopies(_perMaterialDataCopies,
+                               _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES);
+}
+
+// <-
+
+void UniformManager::recordPerMaterialDataCopies(
+    VkCommandBuffer p_CommandBuffer)
+{
+  if (_perMaterialDataCopies.empty())
+  {
+    return;
+  }
+
+  _INTR_PROFILE_CPU("Uniform Manager", "Copy Per Material Data");
+  _INTR_PROFILE_COUNTER_SET("Per Material Data Copies",
+                            (uint32_t)_perMaterialDataCopies.size());
+
+  Helper::insertBufferCopies(
+      p_CommandBuffer,
+      BufferManager::_vkBuffer(_perMaterialStagingUniformBuffer),
+      BufferManager::_vkBuffer(_perMaterialUniformBuffer),
+      _INTR_VK_PER_MATERIAL_UNIFORM_MEMORY_IN_BYTES, _perMaterialDataCopies,
+      VK_ACCESS_UNIFORM_READ_BIT);
+
+  _perMaterialDataCopies.clear();
+}
+
+// <-
+
 void UniformManager::onFrameEnded()
 {
   const uint32_t bufferIdx =
@@ -173,6 +232,7 @@ void UniformManager::onFrameEnded()
 
   _perInstanceAllocatorSmall[bufferIdx].reset();
   _perInstanceAllocatorLarge[bufferIdx].reset();
+  _perInstanceAllocatorHuge[bufferIdx].reset();
 }
 }
 }
@@ -40,6 +40,10 @@ struct UniformManager
     {
       block = _perInstanceAllocatorLarge[bufferIdx].allocate();
     }
+    else if (p_Size <= _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES)
+    {
+      block = _perInstanceAllocatorHuge[bufferIdx].allocate();
+    }
     else
     {
       _INTR_ASSERT(false);
@@ -65,31 +69,36 @@ struct UniformManager
 
   // <-
 
+  /**
+   * Updates the host copy of the per material data. The changed ranges are
+   * copied to the device in a single batch when the next frame begins.
+   */
   _INTR_INLINE static void
   updatePerMaterialDataMemory(void* p_Data, uint32_t p_Size, uint32_t p_Offset)
   {
-    // Update staging memory
-    {
-      memcpy(BufferManager::getGpuMemory(_perMaterialStagingUniformBuffer),
-             p_Data, p_Size);
-    }
-
-    // ... and copy to device
-    VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
+    _INTR_ASSERT(p_Offset + p_Size <=
+                 _INTR_VK_PER_MATERIAL_UNIFORM_MEMORY_IN_BYTES);
+    memcpy(_perMaterialStagingMemory + p_Offset, p_Data, p_Size);
 
     VkBufferCopy bufferCopy = {};
     {
+      bufferCopy.srcOffset = p_Offset;
       bufferCopy.dstOffset = p_Offset;
-      bufferCopy.srcOffset = 0u;
       bufferCopy.size = p_Size;
     }
+    _dirtyPerMaterialRanges.push_back(bufferCopy);
+  }
 
-    vkCmdCopyBuffer(
-        copyCmd, BufferManager::_vkBuffer(_perMaterialStagingUniformBuffer),
-        BufferManager::_vkBuffer(_perMaterialUniformBuffer), 1u, &bufferCopy);
+  /**
+   * Coalesces the per material data ranges changed since the last call into
+   * the copies of the next frame. Only safe to call while rendering is idle.
+   */
+  static void preparePerMaterialDataCopies();
 
-    RenderSystem::flushTemporaryCommandBuffer();
-  }
+  /**
+   * Records the prepared per material data copies.
+   */
+  static void recordPerMaterialDataCopies(VkCommandBuffer p_CommandBuffer);
 
   // <-
 
@@ -110,12 +119,20 @@ private:
       _INTR_VK_PER_INSTANCE_BLOCK_LARGE_COUNT,
       _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES>
       _perInstanceAllocatorLarge[_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
+  static Memory::LockFreeFixedBlockAllocator<
+      _INTR_VK_PER_INSTANCE_BLOCK_HUGE_COUNT,
+      _INTR_VK_PER_INSTANCE_BLOCK_HUGE_SIZE_IN_BYTES>
+      _perInstanceAllocatorHuge[_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
   static Memory::LockFreeFixedBlockAllocator<
       _INTR_VK_PER_MATERIAL_BLOCK_COUNT,
       _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES>
       _perMaterialAllocator;
 
   static BufferRef _perMaterialStagingUniformBuffer;
+  static uint8_t* _perMaterialStagingMemory;
+
+  static _INTR_ARRAY(VkBufferCopy) _dirtyPerMaterialRanges;
+  static _INTR_ARRAY(VkBufferCopy) _perMaterialDataCopies;
 };
 }
 }
@@ -0,0 +1,634 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Renderer
+{
+namespace
+{
+struct UploadBatch
+{
+  VkCommandBuffer vkCommandBuffer;
+  VkFence vkFence;
+
+  // Position of the staging ring head after this batch has been recorded
+  uint64_t stagingRingEnd;
+
+  _INTR_ARRAY(VkBufferMemoryBarrier) bufferReleaseBarriers;
+  _INTR_ARRAY(VkImageMemoryBarrier) imageReleaseBarriers;
+  _INTR_ARRAY(VkBufferMemoryBarrier) bufferAcquireBarriers;
+  _INTR_ARRAY(VkImageMemoryBarrier) imageAcquireBarriers;
+
+  // Dedicated staging buffers for uploads not fitting the ring
+  _INTR_ARRAY(VkBuffer) overflowBuffers;
+  _INTR_ARRAY(GpuMemoryAllocationInfo) overflowMemory;
+
+  bool inFlight;
+};
+
+struct StagingMemory
+{
+  VkBuffer vkBuffer;
+  uint32_t offset;
+  uint8_t* mappedMemory;
+};
+
+const VkAccessFlags _bufferAccessMask =
+    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+    VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+    VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+VkCommandPool _vkCommandPool = VK_NULL_HANDLE;
+
+VkBuffer _stagingRingBuffer = VK_NULL_HANDLE;
+GpuMemoryAllocationInfo _stagingRingMemory;
+// Monotonically increasing positions, the offset in the ring is the position
+// modulo the ring size
+uint64_t _stagingRingHead = 0u;
+uint64_t _stagingRingTail = 0u;
+
+// Batches are used and retired in FIFO order
+UploadBatch _batches[_INTR_UPLOAD_MAX_BATCH_COUNT];
+uint32_t _recordingBatchIdx = (uint32_t)-1;
+uint32_t _nextBatchIdx = 0u;
+uint32_t _oldestBatchIdx = 0u;
+
+// Acquire barriers of submitted batches not yet recorded on the graphics queue
+_INTR_ARRAY(VkBufferMemoryBarrier) _pendingBufferAcquireBarriers;
+_INTR_ARRAY(VkImageMemoryBarrier) _pendingImageAcquireBarriers;
+
+// Semaphores signaled by the submitted batches on the dedicated transfer
+// queue. Once acquired, they are waited on by the submit of the given frame
+// and recycled after the frame has finished
+_INTR_ARRAY(VkSemaphore) _pendingAcquireSemaphores;
+_INTR_HASH_MAP(uint32_t, _INTR_ARRAY(VkSemaphore)) _frameWaitSemaphores;
+_INTR_ARRAY(VkSemaphore) _freeSemaphores;
+
+std::mutex _mutex;
+
+// <-
+
+_INTR_INLINE bool isTransferQueueDedicated()
+{
+  return RenderSystem::_vkTransferQueueFamilyIndex !=
+         RenderSystem::_vkGraphicsAndComputeQueueFamilyIndex;
+}
+
+// <-
+
+_INTR_INLINE uint64_t alignUp(uint64_t p_Value, uint64_t p_Alignment)
+{
+  return (p_Value + p_Alignment - 1u) / p_Alignment * p_Alignment;
+}
+
+// <-
+
+void createStagingBuffer(uint32_t p_SizeInBytes, VkBuffer& p_Buffer,
+                         GpuMemoryAllocationInfo& p_MemoryAllocationInfo)
+{
+  VkBufferCreateInfo bufferCreateInfo = {};
+  {
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.pNext = nullptr;
+    bufferCreateInfo.size = p_SizeInBytes;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  }
+
+  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
+                                   nullptr, &p_Buffer);
+  _INTR_VK_CHECK_RESULT(result);
+
+  VkMemoryRequirements memReqs;
+  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, p_Buffer, &memReqs);
+
+  p_MemoryAllocationInfo = GpuMemoryManager::allocateOffset(
+      MemoryPoolType::kStaticStagingBuffers, (uint32_t)memReqs.size,
+      (uint32_t)memReqs.alignment, memReqs.memoryTypeBits);
+
+  result = vkBindBufferMemory(RenderSystem::_vkDevice, p_Buffer,
+                              p_MemoryAllocationInfo._vkDeviceMemory,
+                              p_MemoryAllocationInfo._offset);
+  _INTR_VK_CHECK_RESULT(result);
+}
+
+// <-
+
+VkSemaphore allocateSemaphore()
+{
+  if (!_freeSemaphores.empty())
+  {
+    const VkSemaphore semaphore = _freeSemaphores.back();
+    _freeSemaphores.pop_back();
+    return semaphore;
+  }
+
+  VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+  {
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = nullptr;
+    semaphoreCreateInfo.flags = 0u;
+  }
+
+  VkSemaphore semaphore;
+  VkResult result = vkCreateSemaphore(
+      RenderSystem::_vkDevice, &semaphoreCreateInfo, nullptr, &semaphore);
+  _INTR_VK_CHECK_RESULT(result);
+
+  return semaphore;
+}
+
+// <-
+
+bool retireOldestBatch(bool p_Wait)
+{
+  UploadBatch& batch = _batches[_oldestBatchIdx];
+  if (!batch.inFlight)
+  {
+    return false;
+  }
+
+  if (p_Wait)
+  {
+    _INTR_PROFILE_CPU("Upload Manager", "Wait For Batch");
+
+    VkResult result = vkWaitForFences(RenderSystem::_vkDevice, 1u,
+                                      &batch.vkFence, VK_TRUE, UINT64_MAX);
+    _INTR_VK_CHECK_RESULT(result);
+  }
+  else if (vkGetFenceStatus(RenderSystem::_vkDevice, batch.vkFence) !=
+           VK_SUCCESS)
+  {
+    return false;
+  }
+
+  VkResult result =
+      vkResetFences(RenderSystem::_vkDevice, 1u, &batch.vkFence);
+  _INTR_VK_CHECK_RESULT(result);
+  result = vkResetCommandBuffer(batch.vkCommandBuffer, 0u);
+  _INTR_VK_CHECK_RESULT(result);
+
+  for (uint32_t i = 0u; i < batch.overflowBuffers.size(); ++i)
+  {
+    vkDestroyBuffer(RenderSystem::_vkDevice, batch.overflowBuffers[i],
+                    nullptr);
+    GpuMemoryManager::freeOffset(batch.overflowMemory[i]);
+  }
+  batch.overflowBuffers.clear();
+  batch.overflowMemory.clear();
+
+  _stagingRingTail = batch.stagingRingEnd;
+  batch.inFlight = false;
+
+  _oldestBatchIdx = (_oldestBatchIdx + 1u) % _INTR_UPLOAD_MAX_BATCH_COUNT;
+
+  return true;
+}
+
+// <-
+
+UploadBatch& beginBatch()
+{
+  if (_recordingBatchIdx != (uint32_t)-1)
+  {
+    return _batches[_recordingBatchIdx];
+  }
+
+  UploadBatch& batch = _batches[_nextBatchIdx];
+  if (batch.inFlight)
+  {
+    // All batches in flight, the next one is also the oldest
+    retireOldestBatch(true);
+  }
+  _INTR_ASSERT(!batch.inFlight);
+
+  VkCommandBufferBeginInfo cmdBufInfo = {};
+  {
+    cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    cmdBufInfo.pNext = nullptr;
+    cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    cmdBufInfo.pInheritanceInfo = nullptr;
+  }
+  VkResult result = vkBeginCommandBuffer(batch.vkCommandBuffer, &cmdBufInfo);
+  _INTR_VK_CHECK_RESULT(result);
+
+  _recordingBatchIdx = _nextBatchIdx;
+  _nextBatchIdx = (_nextBatchIdx + 1u) % _INTR_UPLOAD_MAX_BATCH_COUNT;
+
+  return batch;
+}
+
+// <-
+
+void submitBatch()
+{
+  if (_recordingBatchIdx == (uint32_t)-1)
+  {
+    return;
+  }
+
+  _INTR_PROFILE_CPU("Upload Manager", "Submit Batch");
+
+  UploadBatch& batch = _batches[_recordingBatchIdx];
+  const bool dedicatedQueue = isTransferQueueDedicated();
+
+  // Release barriers for all uploads of this batch
+  if (!batch.bufferReleaseBarriers.empty() ||
+      !batch.imageReleaseBarriers.empty())
+  {
+    vkCmdPipelineBarrier(
+        batch.vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        dedicatedQueue ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+                       : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0u, 0u, nullptr, (uint32_t)batch.bufferReleaseBarriers.size(),
+        batch.bufferReleaseBarriers.data(),
+        (uint32_t)batch.imageReleaseBarriers.size(),
+        batch.imageReleaseBarriers.data());
+  }
+
+  VkResult result = vkEndCommandBuffer(batch.vkCommandBuffer);
+  _INTR_VK_CHECK_RESULT(result);
+
+  const bool acquireRequired = !batch.bufferAcquireBarriers.empty() ||
+                               !batch.imageAcquireBarriers.empty();
+
+  // The graphics queue waits for this semaphore before acquiring the uploads
+  VkSemaphore acquireSemaphore = VK_NULL_HANDLE;
+  if (acquireRequired)
+  {
+    acquireSemaphore = allocateSemaphore();
+  }
+
+  VkSubmitInfo submitInfo = {};
+  {
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = nullptr;
+    submitInfo.commandBufferCount = 1u;
+    submitInfo.pCommandBuffers = &batch.vkCommandBuffer;
+    submitInfo.signalSemaphoreCount = acquireRequired ? 1u : 0u;
+    submitInfo.pSignalSemaphores =
+        acquireRequired ? &acquireSemaphore : nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(RenderSystem::_vkQueueMutex);
+    result = vkQueueSubmit(RenderSystem::_vkTransferQueue, 1u, &submitInfo,
+                           batch.vkFence);
+    _INTR_VK_CHECK_RESULT(result);
+  }
+
+  batch.stagingRingEnd = _stagingRingHead;
+  batch.inFlight = true;
+
+  // The acquire barriers can be recorded on the graphics queue from now on
+  if (acquireRequired)
+  {
+    _pendingBufferAcquireBarriers.insert(_pendingBufferAcquireBarriers.end(),
+                                         batch.bufferAcquireBarriers.begin(),
+                                         batch.bufferAcquireBarriers.end());
+    _pendingImageAcquireBarriers.insert(_pendingImageAcquireBarriers.end(),
+                                        batch.imageAcquireBarriers.begin(),
+                                        batch.imageAcquireBarriers.end());
+    _pendingAcquireSemaphores.push_back(acquireSemaphore);
+  }
+
+  batch.bufferReleaseBarriers.clear();
+  batch.imageReleaseBarriers.clear();
+  batch.bufferAcquireBarriers.clear();
+  batch.imageAcquireBarriers.clear();
+
+  _recordingBatchIdx = (uint32_t)-1;
+}
+
+// <-
+
+StagingMemory allocateStagingMemory(uint32_t p_SizeInBytes)
+{
+  const uint64_t ringSize = _INTR_UPLOAD_STAGING_RING_SIZE_IN_BYTES;
+
+  if (p_SizeInBytes > ringSize / 2u)
+  {
+    VkBuffer buffer;
+    GpuMemoryAllocationInfo memoryAllocationInfo;
+    createStagingBuffer(p_SizeInBytes, buffer, memoryAllocationInfo);
+
+    UploadBatch& batch = beginBatch();
+    batch.overflowBuffers.push_back(buffer);
+    batch.overflowMemory.push_back(memoryAllocationInfo);
+
+    StagingMemory stagingMemory = {buffer, 0u,
+                                   memoryAllocationInfo._mappedMemory};
+    return stagingMemory;
+  }
+
+  while (true)
+  {
+    uint64_t position =
+        alignUp(_stagingRingHead, _INTR_UPLOAD_STAGING_ALIGNMENT);
+
+    // Allocations never wrap around, skip the remainder of the ring instead
+    if (position % ringSize + p_SizeInBytes > ringSize)
+    {
+      position = alignUp(position, ringSize);
+    }
+
+    if (position + p_SizeInBytes - _stagingRingTail <= ringSize)
+    {
+      _stagingRingHead = position + p_SizeInBytes;
+
+      StagingMemory stagingMemory;
+      stagingMemory.vkBuffer = _stagingRingBuffer;
+      stagingMemory.offset = (uint32_t)(position % ringSize);
+      stagingMemory.mappedMemory =
+          _stagingRingMemory._mappedMemory + stagingMemory.offset;
+      return stagingMemory;
+    }
+
+    // The ring is exhausted: submit what has been recorded so far and wait
+    // for the oldest batch to free its staging memory
+    submitBatch();
+    if (!retireOldestBatch(true))
+    {
+      _INTR_ASSERT(false && "Staging ring exhausted");
+    }
+  }
+}
+}
+
+// <-
+
+void UploadManager::init()
+{
+  _INTR_LOG_INFO("Initializing Upload Manager...");
+
+  {
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+    {
+      commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+      commandPoolCreateInfo.pNext = nullptr;
+      commandPoolCreateInfo.queueFamilyIndex =
+          RenderSystem::_vkTransferQueueFamilyIndex;
+      commandPoolCreateInfo.flags =
+          VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+          VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    }
+
+    VkResult result =
+        vkCreateCommandPool(RenderSystem::_vkDevice, &commandPoolCreateInfo,
+                            nullptr, &_vkCommandPool);
+    _INTR_VK_CHECK_RESULT(result);
+  }
+
+  for (uint32_t i = 0u; i < _INTR_UPLOAD_MAX_BATCH_COUNT; ++i)
+  {
+    UploadBatch& batch = _batches[i];
+
+    VkCommandBufferAllocateInfo cmd = {};
+    {
+      cmd.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+      cmd.pNext = nullptr;
+      cmd.commandPool = _vkCommandPool;
+      cmd.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+      cmd.commandBufferCount = 1u;
+    }
+
+    VkResult result = vkAllocateCommandBuffers(RenderSystem::_vkDevice, &cmd,
+                                               &batch.vkCommandBuffer);
+    _INTR_VK_CHECK_RESULT(result);
+
+    VkFenceCreateInfo fenceInfo = {};
+    {
+      fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+      fenceInfo.pNext = nullptr;
+    }
+
+    result = vkCreateFence(RenderSystem::_vkDevice, &fenceInfo, nullptr,
+                           &batch.vkFence);
+    _INTR_VK_CHECK_RESULT(result);
+
+    batch.stagingRingEnd = 0u;
+    batch.inFlight = false;
+  }
+
+  createStagingBuffer(_INTR_UPLOAD_STAGING_RING_SIZE_IN_BYTES,
+                      _stagingRingBuffer, _stagingRingMemory);
+}
+
+// <-
+
+void UploadManager::uploadBuffer(VkBuffer p_Buffer, const void* p_Data,
+                                 uint32_t p_SizeInBytes, uint32_t p_DstOffset)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  const StagingMemory stagingMemory = allocateStagingMemory(p_SizeInBytes);
+  memcpy(stagingMemory.mappedMemory, p_Data, p_SizeInBytes);
+
+  UploadBatch& batch = beginBatch();
+
+  VkBufferCopy bufferCopy = {};
+  {
+    bufferCopy.srcOffset = stagingMemory.offset;
+    bufferCopy.dstOffset = p_DstOffset;
+    bufferCopy.size = p_SizeInBytes;
+  }
+  vkCmdCopyBuffer(batch.vkCommandBuffer, stagingMemory.vkBuffer, p_Buffer, 1u,
+                  &bufferCopy);
+
+  const bool dedicatedQueue = isTransferQueueDedicated();
+
+  VkBufferMemoryBarrier barrier = {};
+  {
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.pNext = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dedicatedQueue ? 0u : _bufferAccessMask;
+    barrier.srcQueueFamilyIndex =
+        dedicatedQueue ? RenderSystem::_vkTransferQueueFamilyIndex
+                       : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex =
+        dedicatedQueue ? RenderSystem::_vkGraphicsAndComputeQueueFamilyIndex
+                       : VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = p_Buffer;
+    barrier.offset = p_DstOffset;
+    barrier.size = p_SizeInBytes;
+  }
+  batch.bufferReleaseBarriers.push_back(barrier);
+
+  if (dedicatedQueue)
+  {
+    barrier.srcAccessMask = 0u;
+    barrier.dstAccessMask = _bufferAccessMask;
+    batch.bufferAcquireBarriers.push_back(barrier);
+  }
+}
+
+// <-
+
+void UploadManager::uploadImage(
+    VkImage p_Image, const VkImageSubresourceRange& p_SubresourceRange,
+    const void* p_Data, uint32_t p_SizeInBytes,
+    const VkBufferImageCopy* p_Regions, uint32_t p_RegionCount)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  const StagingMemory stagingMemory = allocateStagingMemory(p_SizeInBytes);
+  memcpy(stagingMemory.mappedMemory, p_Data, p_SizeInBytes);
+
+  UploadBatch& batch = beginBatch();
+
+  VkImageMemoryBarrier barrier = {};
+  {
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext = nullptr;
+    barrier.srcAccessMask = 0u;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = p_Image;
+    barrier.subresourceRange = p_SubresourceRange;
+  }
+  vkCmdPipelineBarrier(batch.vkCommandBuffer,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0u, 0u, nullptr, 0u,
+                       nullptr, 1u, &barrier);
+
+  _INTR_ARRAY(VkBufferImageCopy) regions;
+  regions.insert(regions.end(), p_Regions, p_Regions + p_RegionCount);
+  for (uint32_t i = 0u; i < p_RegionCount; ++i)
+  {
+    regions[i].bufferOffset += stagingMemory.offset;
+  }
+
+  vkCmdCopyBufferToImage(batch.vkCommandBuffer, stagingMemory.vkBuffer,
+                         p_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         p_RegionCount, regions.data());
+
+  const bool dedicatedQueue = isTransferQueueDedicated();
+  {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dedicatedQueue ? 0u : VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex =
+        dedicatedQueue ? RenderSystem::_vkTransferQueueFamilyIndex
+                       : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex =
+        dedicatedQueue ? RenderSystem::_vkGraphicsAndComputeQueueFamilyIndex
+                       : VK_QUEUE_FAMILY_IGNORED;
+  }
+  batch.imageReleaseBarriers.push_back(barrier);
+
+  if (dedicatedQueue)
+  {
+    barrier.srcAccessMask = 0u;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    batch.imageAcquireBarriers.push_back(barrier);
+  }
+}
+
+// <-
+
+void UploadManager::submit()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  submitBatch();
+}
+
+// <-
+
+void UploadManager::acquireUploads(VkCommandBuffer p_CommandBuffer,
+                                   uint32_t p_FrameIdx)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // The frame has finished, so the semaphores it waited on can be reused
+  _INTR_ARRAY(VkSemaphore)& frameWaitSemaphores =
+      _frameWaitSemaphores[p_FrameIdx];
+  _freeSemaphores.insert(_freeSemaphores.end(), frameWaitSemaphores.begin(),
+                         frameWaitSemaphores.end());
+  frameWaitSemaphores.clear();
+
+  if (_pendingBufferAcquireBarriers.empty() &&
+      _pendingImageAcquireBarriers.empty())
+  {
+    return;
+  }
+
+  // The acquire barriers have to execute after the release barriers on the
+  // transfer queue. Instead of waiting for the batches on the CPU, the submit
+  // of this frame waits for their semaphores
+  frameWaitSemaphores.swap(_pendingAcquireSemaphores);
+
+  vkCmdPipelineBarrier(p_CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0u, 0u, nullptr,
+                       (uint32_t)_pendingBufferAcquireBarriers.size(),
+                       _pendingBufferAcquireBarriers.data(),
+                       (uint32_t)_pendingImageAcquireBarriers.size(),
+                       _pendingImageAcquireBarriers.data());
+
+  _pendingBufferAcquireBarriers.clear();
+  _pendingImageAcquireBarriers.clear();
+}
+
+// <-
+
+void UploadManager::appendWaitSemaphores(
+    uint32_t p_FrameIdx, _INTR_ARRAY(VkSemaphore) & p_Semaphores,
+    _INTR_ARRAY(VkPipelineStageFlags) & p_WaitStages)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  const _INTR_ARRAY(VkSemaphore)& frameWaitSemaphores =
+      _frameWaitSemaphores[p_FrameIdx];
+  p_Semaphores.insert(p_Semaphores.end(), frameWaitSemaphores.begin(),
+                      frameWaitSemaphores.end());
+  p_WaitStages.insert(p_WaitStages.end(), frameWaitSemaphores.size(),
+                      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+}
+
+// <-
+
+void UploadManager::update()
+{
+  _INTR_PROFILE_CPU("Upload Manager", "Update");
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  while (retireOldestBatch(false))
+  {
+  }
+}
+
+// <-
+
+void UploadManager::waitForUploads()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  submitBatch();
+  while (retireOldestBatch(true))
+  {
+  }
+}
+}
+}
@@ -0,0 +1,101 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// Size of the persistently mapped staging ring used for uploads
+#define _INTR_UPLOAD_STAGING_RING_SIZE_IN_BYTES (64u * 1024u * 1024u)
+// Alignment of the staging memory (also satisfies the texel block sizes of
+// all compressed formats)
+#define _INTR_UPLOAD_STAGING_ALIGNMENT 256u
+#define _INTR_UPLOAD_MAX_BATCH_COUNT 4u
+// Frame index used for the acquires recorded to the temporary command buffer
+#define _INTR_UPLOAD_TEMPORARY_FRAME_IDX ((uint32_t)-1)
+
+namespace Intrinsic
+{
+namespace Renderer
+{
+/**
+ * Uploads buffer and image data through a persistently mapped staging ring.
+ * Copies are recorded into batches which get submitted to the transfer queue
+ * without waiting for them to finish. The staging memory of a batch is
+ * recycled as soon as its fence has been signaled. Uploads larger than half
+ * the ring get a dedicated staging buffer.
+ */
+struct UploadManager
+{
+  static void init();
+
+  // <-
+
+  /**
+   * Copies the given data to the buffer. The copy gets recorded into the
+   * current batch which is sent to the GPU by calling submit().
+   */
+  static void uploadBuffer(VkBuffer p_Buffer, const void* p_Data,
+                           uint32_t p_SizeInBytes, uint32_t p_DstOffset = 0u);
+
+  /**
+   * Copies the given data to the image and transitions the sub resources to
+   * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. The buffer offsets of the
+   * regions are relative to the start of the given data.
+   */
+  static void uploadImage(VkImage p_Image,
+                          const VkImageSubresourceRange& p_SubresourceRange,
+                          const void* p_Data, uint32_t p_SizeInBytes,
+                          const VkBufferImageCopy* p_Regions,
+                          uint32_t p_RegionCount);
+
+  /**
+   * Submits the current batch to the transfer queue. Does not wait for the
+   * copies to finish.
+   */
+  static void submit();
+
+  // <-
+
+  /**
+   * Makes all submitted uploads available to the given command buffer of the
+   * graphics queue. Has to be recorded before any of the uploaded resources
+   * are used and the previous submit of the given frame has to be finished.
+   * The temporary command buffer uses _INTR_UPLOAD_TEMPORARY_FRAME_IDX.
+   * If a dedicated transfer queue is used, the ownership of the resources is
+   * acquired and the submit of the frame has to wait for the semaphores
+   * returned by appendWaitSemaphores().
+   */
+  static void acquireUploads(VkCommandBuffer p_CommandBuffer,
+                             uint32_t p_FrameIdx);
+
+  /**
+   * Appends the semaphores (and the matching wait stages) of the batches
+   * acquired in the given frame. Those are signaled by the transfer queue.
+   */
+  static void appendWaitSemaphores(
+      uint32_t p_FrameIdx, _INTR_ARRAY(VkSemaphore) & p_Semaphores,
+      _INTR_ARRAY(VkPipelineStageFlags) & p_WaitStages);
+
+  /**
+   * Recycles the staging memory of all finished batches.
+   */
+  static void update();
+
+  /**
+   * Submits the current batch and blocks until all uploads have finished.
+   */
+  static void waitForUploads();
+};
+}
+}
@@ -0,0 +1,78 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#define _INTR_MAX_TEST_COUNT 256u
+
+namespace Intrinsic
+{
+namespace Tests
+{
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+  const char* name;
+  TestFunction function;
+};
+
+// <-
+
+/**
+ * Keeps track of all test cases and their failed checks. Test cases register
+ * themselves during static initialization via _INTR_TEST.
+ */
+struct TestRegistry
+{
+  static bool registerTest(const char* p_Name, TestFunction p_Function);
+
+  /**
+   * Runs all tests whose name contains the given filter (or all tests if the
+   * filter is nullptr). Returns the count of failed tests.
+   */
+  static uint32_t runTests(const char* p_Filter);
+
+  /**
+   * Called on failed checks. Thread safe, so checks can be used in the
+   * threads spawned by a test.
+   */
+  static void onCheckFailed(const char* p_Expression, const char* p_File,
+                            uint32_t p_Line);
+
+private:
+  static TestCase _testCases[_INTR_MAX_TEST_COUNT];
+  static uint32_t _testCaseCount;
+  static std::atomic<uint32_t> _failedCheckCount;
+};
+}
+}
+
+// Declares and registers a test case
+#define _INTR_TEST(_name)                                                      \
+  static void _name();                                                         \
+  static const bool _name##Registered =                                        \
+      Intrinsic::Tests::TestRegistry::registerTest(#_name, _name);             \
+  static void _name()
+
+// Marks the current test as failed if the expression evaluates to false
+#define _INTR_CHECK(_expr)                                                     \
+  do                                                                           \
+  {                                                                            \
+    if (!(_expr))                                                              \
+    {                                                                          \
+      Intrinsic::Tests::TestRegistry::onCheckFailed(#_expr, __FILE__,          \
+                                                    __LINE__);                 \
+    }                                                                          \
+  } while (false)
@@ -0,0 +1,224 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core::Containers;
+
+namespace
+{
+const uint32_t _producerCount = 4u;
+const uint32_t _consumerCount = 4u;
+const uint32_t _elementsPerProducer = 250000u;
+const uint32_t _elementCount = _producerCount * _elementsPerProducer;
+
+// Small enough for the containers to run full and empty all the time
+const uint64_t _capacity = 256u;
+
+_INTR_INLINE uint64_t makeElement(uint32_t p_ProducerIdx, uint32_t p_Idx)
+{
+  return ((uint64_t)p_ProducerIdx << 32u) | p_Idx;
+}
+
+// <-
+
+template <class Container>
+void producerThread(Container* p_Container, uint32_t p_ProducerIdx)
+{
+  for (uint32_t i = 0u; i < _elementsPerProducer; ++i)
+  {
+    while (!p_Container->push(makeElement(p_ProducerIdx, i)))
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// <-
+
+struct ConsumerState
+{
+  std::atomic<uint32_t>* popCount;
+  std::atomic<uint8_t>* seenCounts;
+  std::atomic<uint32_t>* orderViolationCount;
+  bool checkOrder;
+};
+
+// <-
+
+template <class Container>
+void consumerThread(Container* p_Container, ConsumerState p_State)
+{
+  // The elements of a single producer have to be popped in the order they
+  // have been pushed if the container is FIFO
+  int64_t lastIdxPerProducer[_producerCount];
+  for (uint32_t i = 0u; i < _producerCount; ++i)
+  {
+    lastIdxPerProducer[i] = -1;
+  }
+
+  while (p_State.popCount->load(std::memory_order_relaxed) < _elementCount)
+  {
+    uint64_t element;
+    if (!p_Container->pop(element))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    const uint32_t producerIdx = (uint32_t)(element >> 32u);
+    const uint32_t idx = (uint32_t)element;
+
+    p_State.seenCounts[producerIdx * _elementsPerProducer + idx].fetch_add(
+        1u, std::memory_order_relaxed);
+    p_State.popCount->fetch_add(1u, std::memory_order_relaxed);
+
+    if (p_State.checkOrder)
+    {
+      if ((int64_t)idx <= lastIdxPerProducer[producerIdx])
+      {
+        p_State.orderViolationCount->fetch_add(1u, std::memory_order_relaxed);
+      }
+      lastIdxPerProducer[producerIdx] = idx;
+    }
+  }
+}
+
+// <-
+
+template <class Container> void runContendedTest(bool p_CheckOrder)
+{
+  Container* container = new Container();
+
+  std::atomic<uint32_t> popCount(0u);
+  std::atomic<uint32_t> orderViolationCount(0u);
+  std::atomic<uint8_t>* seenCounts = new std::atomic<uint8_t>[_elementCount];
+  for (uint32_t i = 0u; i < _elementCount; ++i)
+  {
+    seenCounts[i].store(0u, std::memory_order_relaxed);
+  }
+
+  const ConsumerState state = {&popCount, seenCounts, &orderViolationCount,
+                               p_CheckOrder};
+
+  std::thread threads[_producerCount + _consumerCount];
+  for (uint32_t i = 0u; i < _producerCount; ++i)
+  {
+    threads[i] = std::thread(producerThread<Container>, container, i);
+  }
+  for (uint32_t i = 0u; i < _consumerCount; ++i)
+  {
+    threads[_producerCount + i] =
+        std::thread(consumerThread<Container>, container, state);
+  }
+  for (uint32_t i = 0u; i < _producerCount + _consumerCount; ++i)
+  {
+    threads[i].join();
+  }
+
+  // Every element has to be popped exactly once
+  uint32_t lostCount = 0u;
+  uint32_t duplicateCount = 0u;
+  for (uint32_t i = 0u; i < _elementCount; ++i)
+  {
+    const uint8_t seenCount = seenCounts[i].load(std::memory_order_relaxed);
+    lostCount += seenCount == 0u ? 1u : 0u;
+    duplicateCount += seenCount > 1u ? 1u : 0u;
+  }
+
+  _INTR_CHECK(popCount.load() == _elementCount);
+  _INTR_CHECK(lostCount == 0u);
+  _INTR_CHECK(duplicateCount == 0u);
+  _INTR_CHECK(orderViolationCount.load() == 0u);
+  _INTR_CHECK(container->empty());
+  _INTR_CHECK(container->size() == 0u);
+
+  delete[] seenCounts;
+  delete container;
+}
+}
+
+// <-
+
+_INTR_TEST(LockFreeStackContended)
+{
+  runContendedTest<LockFreeStack<uint64_t, _capacity>>(false);
+}
+
+// <-
+
+_INTR_TEST(LockFreeQueueContended)
+{
+  runContendedTest<LockFreeQueue<uint64_t, _capacity>>(true);
+}
+
+// <-
+
+_INTR_TEST(LockFreeQueueFifoOrder)
+{
+  LockFreeQueue<uint64_t, 4u> queue;
+
+  // Runs multiple laps to wrap the sequence numbers of the cells
+  for (uint64_t lap = 0u; lap < 3u; ++lap)
+  {
+    for (uint64_t i = 0u; i < 4u; ++i)
+    {
+      _INTR_CHECK(queue.push(lap * 4u + i));
+    }
+    _INTR_CHECK(!queue.push(0u));
+    _INTR_CHECK(queue.size() == 4u);
+
+    for (uint64_t i = 0u; i < 4u; ++i)
+    {
+      uint64_t element;
+      _INTR_CHECK(queue.pop(element) && element == lap * 4u + i);
+    }
+
+    uint64_t element;
+    _INTR_CHECK(!queue.pop(element));
+    _INTR_CHECK(queue.empty());
+  }
+}
+
+// <-
+
+_INTR_TEST(LockFreeStackLifoOrder)
+{
+  LockFreeStack<uint64_t, 4u> stack;
+
+  for (uint64_t i = 0u; i < 4u; ++i)
+  {
+    _INTR_CHECK(stack.push(i));
+  }
+  _INTR_CHECK(!stack.push(4u));
+  _INTR_CHECK(stack.size() == 4u);
+
+  for (uint64_t i = 0u; i < 4u; ++i)
+  {
+    uint64_t element;
+    _INTR_CHECK(stack.pop(element) && element == 3u - i);
+  }
+
+  uint64_t element;
+  _INTR_CHECK(!stack.pop(element));
+  _INTR_CHECK(stack.empty());
+
+  // Nodes of popped elements have to be reusable
+  for (uint64_t i = 0u; i < 4u; ++i)
+  {
+    _INTR_CHECK(stack.push(i));
+  }
+  _INTR_CHECK(!stack.push(4u));
+}
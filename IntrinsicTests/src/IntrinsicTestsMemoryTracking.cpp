@@ -0,0 +1,101 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core::Memory;
+
+namespace
+{
+const uint32_t _threadCount = 8u;
+const uint32_t _blocksPerThread = 16u;
+const uint32_t _blockSize = 4096u;
+
+void peakThread(std::atomic<uint32_t>* p_AllocatedThreadCount)
+{
+  _INTR_MEMORY_TAG(kScratch);
+
+  void* blocks[_blocksPerThread];
+  for (uint32_t i = 0u; i < _blocksPerThread; ++i)
+  {
+    blocks[i] = Tlsf::MainAllocator::allocate(_blockSize);
+  }
+
+  // Keep the blocks alive until all threads have allocated theirs
+  p_AllocatedThreadCount->fetch_add(1u);
+  while (p_AllocatedThreadCount->load() < _threadCount)
+  {
+    std::this_thread::yield();
+  }
+
+  for (uint32_t i = 0u; i < _blocksPerThread; ++i)
+  {
+    Tlsf::MainAllocator::free(blocks[i]);
+  }
+}
+}
+
+// <-
+
+_INTR_TEST(MemoryTrackingLiveBytes)
+{
+  const TagStats statsBefore = Tracking::getTagStats(Tag::kScratch);
+
+  void* mem;
+  {
+    _INTR_MEMORY_TAG(kScratch);
+    mem = Tlsf::MainAllocator::allocate(1000u);
+  }
+
+  const TagStats stats = Tracking::getTagStats(Tag::kScratch);
+  _INTR_CHECK(stats.liveBytes == statsBefore.liveBytes + 1000);
+  _INTR_CHECK(stats.totalAllocationCount ==
+              statsBefore.totalAllocationCount + 1u);
+
+  // Attributed to the tag of the allocation, not to the one of the free
+  {
+    _INTR_MEMORY_TAG(kPhysics);
+    Tlsf::MainAllocator::free(mem);
+  }
+
+  _INTR_CHECK(Tracking::getTagStats(Tag::kScratch).liveBytes ==
+              statsBefore.liveBytes);
+}
+
+// <-
+
+_INTR_TEST(MemoryTrackingPeakBetweenFrames)
+{
+  const TagStats statsBefore = Tracking::getTagStats(Tag::kScratch);
+
+  std::atomic<uint32_t> allocatedThreadCount(0u);
+  std::thread threads[_threadCount];
+  for (uint32_t i = 0u; i < _threadCount; ++i)
+  {
+    threads[i] = std::thread(peakThread, &allocatedThreadCount);
+  }
+  for (uint32_t i = 0u; i < _threadCount; ++i)
+  {
+    threads[i].join();
+  }
+
+  // All blocks were alive at the same time and freed again before the stats
+  // got queried - without any frame in between
+  const TagStats stats = Tracking::getTagStats(Tag::kScratch);
+  _INTR_CHECK(stats.liveBytes == statsBefore.liveBytes);
+  _INTR_CHECK(stats.peakBytes >=
+              statsBefore.liveBytes +
+                  (int64_t)(_threadCount * _blocksPerThread * _blockSize));
+}
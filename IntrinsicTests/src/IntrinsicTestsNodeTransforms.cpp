@@ -0,0 +1,195 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core;
+using namespace Intrinsic::Core::Components;
+
+namespace
+{
+// Wide enough for all levels but the roots to exceed the minimum level size
+// of the parallel update
+const uint32_t _rootCount = 4u;
+const uint32_t _childrenPerRoot = 128u;
+const uint32_t _childrenPerChild = 2u;
+const uint32_t _levelCount = 4u;
+
+struct WorldTransforms
+{
+  glm::vec3 position;
+  glm::quat orientation;
+  glm::vec3 size;
+  glm::mat4 matrix;
+  glm::mat4 inverseMatrix;
+};
+
+// <-
+
+_INTR_INLINE float nextRandom(uint32_t& p_State)
+{
+  p_State ^= p_State << 13u;
+  p_State ^= p_State >> 17u;
+  p_State ^= p_State << 5u;
+  return (p_State & 0xFFFFu) / 65535.0f * 2.0f - 1.0f;
+}
+
+// <-
+
+void initManagers()
+{
+  // Only the managers touched while creating and updating Nodes
+  Application::_scheduler.Initialize(enki::GetNumHardwareThreads());
+
+  Entity::EntityManager::init();
+  Resources::EventManager::init();
+  NodeManager::init();
+  MeshManager::init();
+}
+
+// <-
+
+NodeRef createRandomNode(NodeRef p_Parent, uint32_t& p_Random)
+{
+  NodeRef nodeRef =
+      NodeManager::createNode(Entity::EntityManager::createEntity());
+  if (p_Parent.isValid())
+  {
+    NodeManager::attachChild(p_Parent, nodeRef);
+  }
+
+  NodeManager::setPosition(nodeRef,
+                           glm::vec3(nextRandom(p_Random), nextRandom(p_Random),
+                                     nextRandom(p_Random)) *
+                               10.0f);
+  NodeManager::setOrientation(
+      nodeRef, glm::normalize(glm::quat(
+                   nextRandom(p_Random), nextRandom(p_Random),
+                   nextRandom(p_Random), nextRandom(p_Random))));
+  NodeManager::setSize(nodeRef, glm::vec3(1.5f + nextRandom(p_Random)));
+
+  return nodeRef;
+}
+
+// <-
+
+void markAllNodesDirty()
+{
+  for (uint32_t i = 0u; i < NodeManager::getSortedNodeCount(); ++i)
+  {
+    NodeManager::markLocalTransformDirty(NodeManager::getSortedNodeAtIndex(i));
+  }
+}
+
+// <-
+
+void collectWorldTransforms(_INTR_ARRAY(WorldTransforms) & p_Transforms)
+{
+  p_Transforms.resize(NodeManager::getSortedNodeCount());
+  memset(p_Transforms.data(), 0,
+         p_Transforms.size() * sizeof(WorldTransforms));
+
+  for (uint32_t i = 0u; i < NodeManager::getSortedNodeCount(); ++i)
+  {
+    const NodeRef nodeRef = NodeManager::getSortedNodeAtIndex(i);
+    WorldTransforms& transforms = p_Transforms[i];
+
+    transforms.position = NodeManager::_worldPosition(nodeRef);
+    transforms.orientation = NodeManager::_worldOrientation(nodeRef);
+    transforms.size = NodeManager::_worldSize(nodeRef);
+    transforms.matrix = NodeManager::_worldMatrix(nodeRef);
+    transforms.inverseMatrix = NodeManager::_inverseWorldMatrix(nodeRef);
+  }
+}
+
+// <-
+
+void clearWorldTransforms()
+{
+  for (uint32_t i = 0u; i < NodeManager::getSortedNodeCount(); ++i)
+  {
+    const NodeRef nodeRef = NodeManager::getSortedNodeAtIndex(i);
+
+    NodeManager::_worldPosition(nodeRef) = glm::vec3(0.0f);
+    NodeManager::_worldOrientation(nodeRef) = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+    NodeManager::_worldSize(nodeRef) = glm::vec3(0.0f);
+    NodeManager::_worldMatrix(nodeRef) = glm::mat4(0.0f);
+    NodeManager::_inverseWorldMatrix(nodeRef) = glm::mat4(0.0f);
+  }
+}
+}
+
+// <-
+
+_INTR_TEST(NodeTransformsParallelMatchesSerial)
+{
+  initManagers();
+
+  uint32_t random = 0x9E3779B9u;
+  uint32_t nodeCount = _rootCount;
+  NodeRefArray level;
+  for (uint32_t i = 0u; i < _rootCount; ++i)
+  {
+    level.push_back(createRandomNode(NodeRef(), random));
+  }
+
+  for (uint32_t levelIdx = 1u; levelIdx < _levelCount; ++levelIdx)
+  {
+    const uint32_t childCount =
+        levelIdx == 1u ? _childrenPerRoot : _childrenPerChild;
+
+    NodeRefArray nextLevel;
+    for (uint32_t i = 0u; i < level.size(); ++i)
+    {
+      for (uint32_t j = 0u; j < childCount; ++j)
+      {
+        nextLevel.push_back(createRandomNode(level[i], random));
+      }
+      nodeCount += childCount;
+    }
+    level.swap(nextLevel);
+  }
+
+  NodeManager::rebuildTree();
+  _INTR_CHECK(NodeManager::getSortedNodeCount() == nodeCount);
+
+  NodeRefArray sortedNodes;
+  for (uint32_t i = 0u; i < NodeManager::getSortedNodeCount(); ++i)
+  {
+    sortedNodes.push_back(NodeManager::getSortedNodeAtIndex(i));
+  }
+
+  // Reference: all Nodes updated one after another in sorted order
+  markAllNodesDirty();
+  NodeManager::updateTransforms(sortedNodes);
+
+  _INTR_ARRAY(WorldTransforms) serialTransforms;
+  collectWorldTransforms(serialTransforms);
+
+  // The parallel update has to reproduce the results bit by bit since every
+  // Node is still computed from the very same inputs - only the thread
+  // doing the work differs
+  clearWorldTransforms();
+  markAllNodesDirty();
+  NodeManager::updateTransforms();
+
+  _INTR_ARRAY(WorldTransforms) parallelTransforms;
+  collectWorldTransforms(parallelTransforms);
+
+  _INTR_CHECK(parallelTransforms.size() == serialTransforms.size());
+  _INTR_CHECK(memcmp(parallelTransforms.data(), serialTransforms.data(),
+                     serialTransforms.size() * sizeof(WorldTransforms)) ==
+              0);
+}
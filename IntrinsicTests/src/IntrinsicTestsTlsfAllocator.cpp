@@ -0,0 +1,206 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core::Memory;
+
+namespace
+{
+const uint32_t _threadCount = 8u;
+const uint32_t _allocationsPerThread = 200000u;
+const uint32_t _maxAllocationSize = 2048u;
+
+// Blocks are handed over between the threads via these slots, so most of the
+// blocks get freed on a different thread than the one allocating them
+const uint32_t _mailboxSlotCount = 1024u;
+std::atomic<void*> _mailbox[_mailboxSlotCount];
+
+// <-
+
+_INTR_INLINE uint32_t nextRandom(uint32_t& p_State)
+{
+  p_State ^= p_State << 13u;
+  p_State ^= p_State >> 17u;
+  p_State ^= p_State << 5u;
+  return p_State;
+}
+
+// <-
+
+_INTR_INLINE void* allocateBlock(uint32_t p_Size)
+{
+  uint8_t* mem = (uint8_t*)Tlsf::MainAllocator::allocate(p_Size);
+
+  // Stores the size in the first bytes and fills the remainder with a
+  // pattern derived from the size
+  memcpy(mem, &p_Size, sizeof(uint32_t));
+  memset(mem + sizeof(uint32_t), (uint8_t)p_Size, p_Size - sizeof(uint32_t));
+
+  return mem;
+}
+
+// <-
+
+_INTR_INLINE bool freeBlock(void* p_Mem)
+{
+  const uint8_t* mem = (const uint8_t*)p_Mem;
+
+  uint32_t size;
+  memcpy(&size, mem, sizeof(uint32_t));
+
+  bool valid = size >= sizeof(uint32_t) && size <= _maxAllocationSize;
+  for (uint32_t i = sizeof(uint32_t); valid && i < size; ++i)
+  {
+    valid = mem[i] == (uint8_t)size;
+  }
+
+  Tlsf::MainAllocator::free(p_Mem);
+  return valid;
+}
+
+// <-
+
+void stressThread(uint32_t p_ThreadIdx, std::atomic<uint32_t>* p_CorruptCount)
+{
+  _INTR_MEMORY_TAG(kScratch);
+
+  uint32_t random = 0x9E3779B9u * (p_ThreadIdx + 1u);
+  uint32_t corruptCount = 0u;
+
+  for (uint32_t i = 0u; i < _allocationsPerThread; ++i)
+  {
+    const uint32_t size =
+        sizeof(uint32_t) + nextRandom(random) % (_maxAllocationSize - 3u);
+    void* mem = allocateBlock(size);
+
+    // Swap the new block with the one in a random slot and free the block
+    // found there - which was most likely allocated by another thread
+    void* prevMem =
+        _mailbox[nextRandom(random) % _mailboxSlotCount].exchange(mem);
+    if (prevMem != nullptr && !freeBlock(prevMem))
+    {
+      ++corruptCount;
+    }
+  }
+
+  p_CorruptCount->fetch_add(corruptCount);
+}
+
+// <-
+
+void shortLivedThread(uint32_t p_ThreadIdx, void** p_LeakedBlocks)
+{
+  _INTR_MEMORY_TAG(kScratch);
+
+  uint32_t random = 0x9E3779B9u * (p_ThreadIdx + 1u);
+
+  void* blocks[64];
+  for (uint32_t i = 0u; i < 64u; ++i)
+  {
+    blocks[i] = allocateBlock(sizeof(uint32_t) + nextRandom(random) % 512u);
+  }
+  for (uint32_t i = 1u; i < 64u; ++i)
+  {
+    freeBlock(blocks[i]);
+  }
+
+  // Freed by the main thread after this thread has exited and its heap has
+  // been released
+  *p_LeakedBlocks = blocks[0];
+}
+}
+
+// <-
+
+_INTR_TEST(TlsfAllocatorCrossThreadFree)
+{
+  const int64_t liveBytesBefore =
+      Tracking::getTagStats(Tag::kScratch).liveBytes;
+
+  for (uint32_t i = 0u; i < _mailboxSlotCount; ++i)
+  {
+    _mailbox[i].store(nullptr);
+  }
+
+  std::atomic<uint32_t> corruptCount(0u);
+  std::thread threads[_threadCount];
+  for (uint32_t i = 0u; i < _threadCount; ++i)
+  {
+    threads[i] = std::thread(stressThread, i, &corruptCount);
+  }
+  for (uint32_t i = 0u; i < _threadCount; ++i)
+  {
+    threads[i].join();
+  }
+
+  {
+    _INTR_MEMORY_TAG(kScratch);
+    for (uint32_t i = 0u; i < _mailboxSlotCount; ++i)
+    {
+      void* mem = _mailbox[i].exchange(nullptr);
+      if (mem != nullptr && !freeBlock(mem))
+      {
+        corruptCount.fetch_add(1u);
+      }
+    }
+  }
+
+  _INTR_CHECK(corruptCount.load() == 0u);
+  _INTR_CHECK(Tracking::getTagStats(Tag::kScratch).liveBytes ==
+              liveBytesBefore);
+}
+
+// <-
+
+_INTR_TEST(TlsfAllocatorRecyclesHeapsOfExitedThreads)
+{
+  const uint32_t batchSize = 8u;
+  const uint32_t batchCount =
+      4u * _INTR_TLSF_MAX_THREAD_HEAP_COUNT / batchSize;
+
+  const int64_t liveBytesBefore =
+      Tracking::getTagStats(Tag::kScratch).liveBytes;
+  const uint32_t heapCountBefore = Tlsf::MainAllocator::getHeapCount();
+
+  // Spawns way more threads than heaps can exist at the same time
+  for (uint32_t batchIdx = 0u; batchIdx < batchCount; ++batchIdx)
+  {
+    void* leakedBlocks[batchSize];
+    std::thread threads[batchSize];
+    for (uint32_t i = 0u; i < batchSize; ++i)
+    {
+      threads[i] = std::thread(shortLivedThread, batchIdx * batchSize + i,
+                               &leakedBlocks[i]);
+    }
+    for (uint32_t i = 0u; i < batchSize; ++i)
+    {
+      threads[i].join();
+    }
+
+    // The released heaps receive these as remote frees, which get drained
+    // by the next threads adopting the heaps
+    _INTR_MEMORY_TAG(kScratch);
+    for (uint32_t i = 0u; i < batchSize; ++i)
+    {
+      _INTR_CHECK(freeBlock(leakedBlocks[i]));
+    }
+  }
+
+  _INTR_CHECK(Tlsf::MainAllocator::getHeapCount() <=
+              heapCountBefore + batchSize);
+  _INTR_CHECK(Tracking::getTagStats(Tag::kScratch).liveBytes ==
+              liveBytesBefore);
+}
@@ -0,0 +1,232 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core::Memory;
+
+_INTR_TEST(TlsfOffsetAllocatorAllocateAndFree)
+{
+  TlsfOffsetAllocator allocator;
+  allocator.init(1024u);
+
+  TlsfOffsetAllocation a, b;
+  _INTR_CHECK(allocator.allocate(100u, 1u, a) && a.offset == 0u);
+  _INTR_CHECK(allocator.allocate(200u, 1u, b) && b.offset == 100u);
+  _INTR_CHECK(allocator.getAllocationSize(a.nodeIdx) == 100u);
+  _INTR_CHECK(allocator.getAllocationSize(b.nodeIdx) == 200u);
+  _INTR_CHECK(allocator.getAllocationCount() == 2u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 724u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 724u);
+
+  allocator.free(a.nodeIdx);
+  _INTR_CHECK(allocator.getAllocationCount() == 1u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 824u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 724u);
+
+  allocator.free(b.nodeIdx);
+  _INTR_CHECK(allocator.getAllocationCount() == 0u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 1024u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 1024u);
+}
+
+// <-
+
+_INTR_TEST(TlsfOffsetAllocatorExhaustion)
+{
+  TlsfOffsetAllocator allocator;
+  allocator.init(1024u);
+
+  TlsfOffsetAllocation allocation;
+  _INTR_CHECK(!allocator.allocate(1025u, 1u, allocation));
+  _INTR_CHECK(allocator.allocate(1024u, 1u, allocation));
+  _INTR_CHECK(allocation.offset == 0u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 0u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 0u);
+
+  TlsfOffsetAllocation failedAllocation;
+  _INTR_CHECK(!allocator.allocate(1u, 1u, failedAllocation));
+}
+
+// <-
+
+_INTR_TEST(TlsfOffsetAllocatorMergesNeighbors)
+{
+  TlsfOffsetAllocator allocator;
+  allocator.init(1024u);
+
+  TlsfOffsetAllocation a, b, c;
+  _INTR_CHECK(allocator.allocate(256u, 1u, a));
+  _INTR_CHECK(allocator.allocate(256u, 1u, b));
+  _INTR_CHECK(allocator.allocate(256u, 1u, c));
+
+  // Merges with the free remainder behind it
+  allocator.free(c.nodeIdx);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 512u);
+
+  // No free neighbors
+  allocator.free(a.nodeIdx);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 512u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 768u);
+
+  // Merges with both neighbors
+  allocator.free(b.nodeIdx);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 1024u);
+
+  TlsfOffsetAllocation whole;
+  _INTR_CHECK(allocator.allocate(1024u, 1u, whole) && whole.offset == 0u);
+}
+
+// <-
+
+_INTR_TEST(TlsfOffsetAllocatorAlignmentPadding)
+{
+  TlsfOffsetAllocator allocator;
+  allocator.init(1024u);
+
+  TlsfOffsetAllocation a, b;
+  _INTR_CHECK(allocator.allocate(1u, 1u, a) && a.offset == 0u);
+  _INTR_CHECK(allocator.allocate(64u, 256u, b) && b.offset == 256u);
+
+  // Only the allocations themselves are accounted for, the padding in front
+  // of the aligned allocation stays available
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 1024u - 65u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 1024u - 320u);
+
+  // The padding is the best fit for small allocations
+  TlsfOffsetAllocation c;
+  _INTR_CHECK(allocator.allocate(8u, 1u, c) && c.offset == 1u);
+
+  // Freeing everything merges the padding again
+  allocator.free(a.nodeIdx);
+  allocator.free(c.nodeIdx);
+  allocator.free(b.nodeIdx);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 1024u);
+}
+
+// <-
+
+_INTR_TEST(TlsfOffsetAllocatorReset)
+{
+  TlsfOffsetAllocator allocator;
+  allocator.init(4096u);
+
+  TlsfOffsetAllocation allocation;
+  for (uint32_t i = 0u; i < 16u; ++i)
+  {
+    _INTR_CHECK(allocator.allocate(100u, 16u, allocation));
+  }
+
+  // Drops all outstanding allocations at once
+  allocator.reset();
+  _INTR_CHECK(allocator.getAllocationCount() == 0u);
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == 4096u);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == 4096u);
+
+  _INTR_CHECK(allocator.allocate(4096u, 1u, allocation));
+  _INTR_CHECK(allocation.offset == 0u);
+}
+
+// <-
+
+_INTR_TEST(TlsfOffsetAllocatorRandomized)
+{
+  const uint32_t size = 65536u;
+  const uint32_t iterationCount = 100000u;
+
+  TlsfOffsetAllocator allocator;
+  allocator.init(size);
+
+  // Reference state: the owner of each byte (or zero if free)
+  _INTR_ARRAY(uint32_t) owners;
+  owners.resize(size, 0u);
+
+  _INTR_ARRAY(TlsfOffsetAllocation) allocations;
+  _INTR_ARRAY(uint32_t) allocationIds;
+  uint32_t usedSize = 0u;
+  uint32_t nextId = 1u;
+  uint32_t random = 0x9E3779B9u;
+  bool valid = true;
+
+  for (uint32_t i = 0u; i < iterationCount && valid; ++i)
+  {
+    random ^= random << 13u;
+    random ^= random >> 17u;
+    random ^= random << 5u;
+
+    if (allocations.empty() || random % 3u != 0u)
+    {
+      const uint32_t allocSize = 1u + (random >> 8u) % 1024u;
+      const uint32_t alignment = 1u << ((random >> 24u) % 9u);
+
+      TlsfOffsetAllocation allocation;
+      if (!allocator.allocate(allocSize, alignment, allocation))
+      {
+        // Only fails if there is no block which fits the worst case padding.
+        // The search rounds up to the next bin, adding less than 1/8th
+        const uint32_t minSize = allocSize + alignment - 1u;
+        valid = allocator.calcLargestFreeBlockInBytes() <
+                minSize + (minSize >> 3u);
+        continue;
+      }
+
+      valid = allocation.offset % alignment == 0u &&
+              allocation.offset + allocSize <= size;
+      for (uint32_t j = 0u; valid && j < allocSize; ++j)
+      {
+        valid = owners[allocation.offset + j] == 0u;
+        owners[allocation.offset + j] = nextId;
+      }
+
+      allocations.push_back(allocation);
+      allocationIds.push_back(nextId++);
+      usedSize += allocSize;
+    }
+    else
+    {
+      const uint32_t idx = (random >> 8u) % (uint32_t)allocations.size();
+      const TlsfOffsetAllocation allocation = allocations[idx];
+      const uint32_t allocSize =
+          allocator.getAllocationSize(allocation.nodeIdx);
+
+      for (uint32_t j = 0u; valid && j < allocSize; ++j)
+      {
+        valid = owners[allocation.offset + j] == allocationIds[idx];
+        owners[allocation.offset + j] = 0u;
+      }
+
+      allocator.free(allocation.nodeIdx);
+      allocations[idx] = allocations.back();
+      allocations.pop_back();
+      allocationIds[idx] = allocationIds.back();
+      allocationIds.pop_back();
+      usedSize -= allocSize;
+    }
+
+    valid = valid &&
+            allocator.calcAvailableMemoryInBytes() == size - usedSize &&
+            allocator.getAllocationCount() == allocations.size();
+  }
+  _INTR_CHECK(valid);
+
+  for (uint32_t i = 0u; i < allocations.size(); ++i)
+  {
+    allocator.free(allocations[i].nodeIdx);
+  }
+
+  // All blocks have to be merged again
+  _INTR_CHECK(allocator.calcAvailableMemoryInBytes() == size);
+  _INTR_CHECK(allocator.calcLargestFreeBlockInBytes() == size);
+}
@@ -0,0 +1,48 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+using namespace Intrinsic::Core;
+
+_INTR_TEST(UtilHashDetectsChanges)
+{
+  // Covers both the words and the trailing bytes
+  uint8_t data[37];
+  for (uint32_t i = 0u; i < sizeof(data); ++i)
+  {
+    data[i] = (uint8_t)(i * 7u);
+  }
+
+  const uint64_t hash = Util::calcHash(data, sizeof(data));
+  _INTR_CHECK(Util::calcHash(data, sizeof(data)) == hash);
+
+  // Every single flipped bit has to change the hash
+  bool allChanged = true;
+  for (uint32_t i = 0u; i < sizeof(data) * 8u; ++i)
+  {
+    data[i / 8u] ^= 1u << (i % 8u);
+    allChanged = allChanged && Util::calcHash(data, sizeof(data)) != hash;
+    data[i / 8u] ^= 1u << (i % 8u);
+  }
+  _INTR_CHECK(allChanged);
+
+  // Appending zeros has to change the hash as well
+  uint8_t paddedData[40] = {};
+  memcpy(paddedData, data, sizeof(data));
+  _INTR_CHECK(Util::calcHash(paddedData, sizeof(paddedData)) != hash);
+  _INTR_CHECK(Util::calcHash(paddedData, 0u) !=
+              Util::calcHash(paddedData, 1u));
+}
@@ -0,0 +1,91 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "IntrinsicTestsFramework.h"
+
+namespace Intrinsic
+{
+namespace Tests
+{
+// Static members
+TestCase TestRegistry::_testCases[_INTR_MAX_TEST_COUNT];
+uint32_t TestRegistry::_testCaseCount = 0u;
+std::atomic<uint32_t> TestRegistry::_failedCheckCount(0u);
+
+// <-
+
+bool TestRegistry::registerTest(const char* p_Name, TestFunction p_Function)
+{
+  assert(_testCaseCount < _INTR_MAX_TEST_COUNT && "Max. test count exceeded");
+
+  TestCase& testCase = _testCases[_testCaseCount++];
+  testCase.name = p_Name;
+  testCase.function = p_Function;
+
+  return true;
+}
+
+// <-
+
+uint32_t TestRegistry::runTests(const char* p_Filter)
+{
+  uint32_t failedTestCount = 0u;
+  uint32_t executedTestCount = 0u;
+
+  for (uint32_t i = 0u; i < _testCaseCount; ++i)
+  {
+    const TestCase& testCase = _testCases[i];
+    if (p_Filter != nullptr && strstr(testCase.name, p_Filter) == nullptr)
+    {
+      continue;
+    }
+
+    printf("[ RUN    ] %s\n", testCase.name);
+    fflush(stdout);
+
+    const uint32_t failedChecksBefore = _failedCheckCount.load();
+    testCase.function();
+    const bool failed = _failedCheckCount.load() != failedChecksBefore;
+
+    printf("[ %s ] %s\n", failed ? "FAILED" : "    OK", testCase.name);
+    fflush(stdout);
+
+    failedTestCount += failed ? 1u : 0u;
+    ++executedTestCount;
+  }
+
+  printf("%u of %u tests passed\n", executedTestCount - failedTestCount,
+         executedTestCount);
+  return failedTestCount;
+}
+
+// <-
+
+void TestRegistry::onCheckFailed(const char* p_Expression, const char* p_File,
+                                 uint32_t p_Line)
+{
+  _failedCheckCount.fetch_add(1u);
+  fprintf(stderr, "%s(%u): Check failed: %s\n", p_File, p_Line, p_Expression);
+}
+}
+}
+
+// <-
+
+int main(int argc, char* argv[])
+{
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  return Intrinsic::Tests::TestRegistry::runTests(filter) == 0u ? 0 : 1;
+}
@@ -31,7 +31,7 @@ layout(binding = 0) uniform PerInstance
   vec4 nearFarWidthHeight;
   vec4 nearFar;
 }
-uboPerInstance;
+uboPerInstanceDecals;
 
 PER_FRAME_DATA(1);
 
@@ -66,8 +66,9 @@ void main()
   vec3 normal = vec3(0.0);
   vec2 pbr = vec2(0.0);
 
-  const uvec3 gridPos = calcGridPosForViewPos(
-      posVS, uboPerInstance.nearFar, uboPerInstance.nearFarWidthHeight);
+  const uvec3 gridPos =
+      calcGridPosForViewPos(posVS, uboPerInstanceDecals.nearFar,
+                            uboPerInstanceDecals.nearFarWidthHeight);
 
   const uint clusterIdx =
       calcClusterIndex(gridPos, maxDecalCountPerCluster) / 2;
@@ -31,16 +31,27 @@
            uboPerMaterial.uvOffsetScale.y)
 #define UV0(_uv0) vec2(_uv0.x, (1.0 - _uv0.y))
 
+// Has to match _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL
+#define MAX_INSTANCE_COUNT 32
+
+struct PerInstanceDataFragment
+{
+  vec4 colorTint;
+  vec4 camParams;
+  vec4 data0;
+};
+
 #define PER_INSTANCE_UBO                                                       \
   layout(binding = 1) uniform PerInstance                                      \
                                                                                \
   {                                                                            \
-    vec4 colorTint;                                                            \
-    vec4 camParams;                                                            \
-    vec4 data0;                                                                \
-    vec4 data1;                                                                \
+    PerInstanceDataFragment instances[MAX_INSTANCE_COUNT];                     \
   }                                                                            \
-  uboPerInstance
+  uboPerInstanceArray;                                                         \
+                                                                               \
+  layout(location = 15) flat in uint inInstanceIdx
+
+#define uboPerInstance uboPerInstanceArray.instances[inInstanceIdx]
 
 #define PER_MATERIAL_UBO                                                       \
   layout(binding = 2) uniform PerMaterial                                      \
@@ -33,6 +33,8 @@ layout(location = 4) out vec2 outUV0;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
 
   outColor = inColor.xyz;
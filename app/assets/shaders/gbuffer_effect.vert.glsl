@@ -34,6 +34,8 @@ layout(location = 5) out vec4 outPosition;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   const vec3 worldNormal =
       (uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
   const vec3 worldPos =
@@ -41,6 +41,8 @@ layout(location = 5) out vec3 outWorldPosition;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   vec3 localPos = inPosition.xyz;
   outWorldPosition =
       (uboPerInstance.worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
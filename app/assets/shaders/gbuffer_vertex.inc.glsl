@@ -1,15 +1,30 @@
+// Has to match _INTR_MAX_INSTANCE_COUNT_PER_DRAW_CALL
+#define MAX_INSTANCE_COUNT 32
+
+struct PerInstanceDataVertex
+{
+  mat4 worldMatrix;
+  mat4 worldViewProjMatrix;
+  mat4 worldViewMatrix;
+  mat4 viewProjMatrix;
+  mat4 viewMatrix;
+  vec4 data0;
+};
+
+// The data of all instances of an (instanced) draw call is stored
+// consecutively, the instance index is passed on to the fragment shader
 #define PER_INSTANCE_UBO                                                       \
   layout(binding = 0) uniform PerInstance                                      \
                                                                                \
   {                                                                            \
-    mat4 worldMatrix;                                                          \
-    mat4 worldViewProjMatrix;                                                  \
-    mat4 worldViewMatrix;                                                      \
-    mat4 viewProjMatrix;                                                       \
-    mat4 viewMatrix;                                                           \
-    vec4 data0;                                                                \
+    PerInstanceDataVertex instances[MAX_INSTANCE_COUNT];                       \
   }                                                                            \
-  uboPerInstance
+  uboPerInstanceArray;                                                         \
+                                                                               \
+  layout(location = 15) flat out uint outInstanceIdx
+
+#define uboPerInstance uboPerInstanceArray.instances[gl_InstanceIndex]
+#define OUTPUT_INSTANCE_IDX() outInstanceIdx = uint(gl_InstanceIndex)
 
 #define INPUT()                                                                \
   layout(location = 0) in vec3 inPosition;                                     \
@@ -38,6 +38,8 @@ layout(location = 5) out vec4 outPosition;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
   outPosition = gl_Position;
 
@@ -27,7 +27,7 @@ layout(location = 1) in vec3 inColor;
 OUTPUT
 
 layout(binding = 1) uniform PerInstance { float _dummy; }
-uboPerInstance;
+uboPerInstanceGizmo;
 
 void main()
 {
@@ -39,7 +39,7 @@ layout(binding = 1) uniform PerInstance
   float gridSize;
   float fade;
 }
-uboPerInstance;
+uboPerInstanceGrid;
 
 #define GRID_RANGE 50.0
 #define GRID_FADE_RANGE 40.0
@@ -55,18 +55,18 @@ bool isGridVisible(vec2 localPos, float lineWidth, float cellSize)
 
 void main()
 {
-  const vec3 localPos = inPosition.xyz + uboPerInstance.invWorldPos.xyz;
+  const vec3 localPos = inPosition.xyz + uboPerInstanceGrid.invWorldPos.xyz;
   const vec3 worldPos = inPosition.xyz;
 
   vec2 projLocalPos = localPos.xz;
   vec2 projWorldPos = worldPos.xz;
 
-  if (abs(uboPerInstance.planeNormal.xyz) == vec3(1.0, 0.0, 0.0))
+  if (abs(uboPerInstanceGrid.planeNormal.xyz) == vec3(1.0, 0.0, 0.0))
   {
     projLocalPos = localPos.yz;
     projWorldPos = worldPos.yz;
   }
-  else if (abs(uboPerInstance.planeNormal.xyz) == vec3(0.0, 0.0, 1.0))
+  else if (abs(uboPerInstanceGrid.planeNormal.xyz) == vec3(0.0, 0.0, 1.0))
   {
     projLocalPos = localPos.xy;
     projWorldPos = worldPos.xy;
@@ -75,11 +75,11 @@ void main()
   const float xzDist = length(projLocalPos);
 
   const float gridRange =
-      uboPerInstance.gridSize * uboPerInstance.fade * GRID_RANGE;
+      uboPerInstanceGrid.gridSize * uboPerInstanceGrid.fade * GRID_RANGE;
   const float fadeRange =
-      uboPerInstance.gridSize * uboPerInstance.fade * GRID_FADE_RANGE;
+      uboPerInstanceGrid.gridSize * uboPerInstanceGrid.fade * GRID_FADE_RANGE;
   const float fadeInterval = gridRange - fadeRange;
-  const float noiseScale = 1.0 / uboPerInstance.gridSize * 0.4;
+  const float noiseScale = 1.0 / uboPerInstanceGrid.gridSize * 0.4;
 
   if (xzDist > fadeInterval)
   {
@@ -91,12 +91,12 @@ void main()
     }
   }
 
-  const float bigGridCellSize = 5.0 * uboPerInstance.gridSize;
-  const float tinyGridCellSize = uboPerInstance.gridSize;
+  const float bigGridCellSize = 5.0 * uboPerInstanceGrid.gridSize;
+  const float tinyGridCellSize = uboPerInstanceGrid.gridSize;
   const float bigGridLineWidth = calcScreenSpaceScale(
-      inPosition.xyz, uboPerInstance.viewProjMatrix, 0.004);
+      inPosition.xyz, uboPerInstanceGrid.viewProjMatrix, 0.004);
   const float tinyGridLineWidth = calcScreenSpaceScale(
-      inPosition.xyz, uboPerInstance.viewProjMatrix, 0.0025);
+      inPosition.xyz, uboPerInstanceGrid.viewProjMatrix, 0.0025);
 
   const bool tinyGridVisible =
       isGridVisible(projWorldPos, tinyGridLineWidth, tinyGridCellSize);
@@ -117,9 +117,10 @@ void main()
   GBuffer gbuffer;
   {
     gbuffer.albedo = vec4(color, 1.0);
-    gbuffer.normal = normalize(
-        (uboPerInstance.viewMatrix * vec4(uboPerInstance.planeNormal.xyz, 0.0))
-            .xyz);
+    gbuffer.normal =
+        normalize((uboPerInstanceGrid.viewMatrix *
+                   vec4(uboPerInstanceGrid.planeNormal.xyz, 0.0))
+                      .xyz);
     gbuffer.metalMask = 0.0;
     gbuffer.specular = 0.5;
     gbuffer.roughness = 0.5;
@@ -27,5 +27,7 @@ INPUT();
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
 }
@@ -35,6 +35,8 @@ const float maxNormalLen = 200.0;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   const vec3 localPos = inPosition;
   vec3 worldNormal = (uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
 
@@ -36,6 +36,8 @@ layout(location = 0) out vec2 outUV0;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   vec3 localPos = inPosition;
   const vec3 initialWorldPos =
       (uboPerInstance.worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
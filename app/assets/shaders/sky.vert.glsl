@@ -36,6 +36,8 @@ layout(location = 3) out vec3 outUpVS;
 
 void main()
 {
+  OUTPUT_INSTANCE_IDX();
+
   gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
   outUpVS = (uboPerInstance.viewMatrix * vec4(vec3(0.0, 1.0, 0.0), 0.0)).xyz;
   outPosVS = (uboPerInstance.worldViewMatrix * vec4(inPosition.xyz, 1.0)).xyz;